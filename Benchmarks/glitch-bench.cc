@@ -0,0 +1,1021 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Run with QT_QPA_PLATFORM=offscreen. Machine-readable results are
+** produced by the usual QtTest options, for example,
+** ./glitch-bench -o results.xml,xml or ./glitch-bench -csv.
+*/
+
+#include <QMouseEvent>
+#include <QTemporaryDir>
+#include <QtMath>
+#include <QtTest>
+
+#include "Arduino/glitch-cost-model-arduino.h"
+#include "Arduino/glitch-footprint-arduino.h"
+#include "Arduino/glitch-optimizer-arduino.h"
+#include "Arduino/glitch-simulator-arduino.h"
+#include "Arduino/glitch-view-arduino.h"
+#include "glitch-alignment.h"
+#include "glitch-call-graph.h"
+#include "glitch-diagram-generator.h"
+#include "glitch-graphicsview.h"
+#include "glitch-object.h"
+#include "glitch-pin-trace.h"
+#include "glitch-proximity.h"
+#include "glitch-scene.h"
+#include "glitch-serial-log.h"
+#include "glitch-ui.h"
+#include "glitch-wire-graph.h"
+
+class glitch_bench: public QObject
+{
+  Q_OBJECT
+
+ private:
+  QHash<int, QString> m_fileNames;
+  QTemporaryDir m_directory;
+  QString fileName(const int count);
+  glitch_view_arduino *openView(const QString &fileName);
+  void addSizes(const bool large);
+
+ private slots:
+  void align(void);
+  void align_data(void);
+  void callGraph(void);
+  void callGraph_data(void);
+  void cleanupTestCase(void);
+  void contextMenu(void);
+  void contextMenu_data(void);
+  void copyPaste(void);
+  void copyPaste_data(void);
+  void deleteItems(void);
+  void deleteItems_data(void);
+  void drag(void);
+  void drag_data(void);
+  void estimate(void);
+  void estimate_data(void);
+  void footprint(void);
+  void footprint_data(void);
+  void initTestCase(void);
+  void open(void);
+  void open_data(void);
+  void optimize(void);
+  void optimize_data(void);
+  void pinTrace(void);
+  void pinTrace_data(void);
+  void proximity(void);
+  void proximity_data(void);
+  void save(void);
+  void save_data(void);
+  void seek(void);
+  void seek_data(void);
+  void serialLog(void);
+  void serialLog_data(void);
+  void simulate(void);
+  void simulate_data(void);
+  void stack(void);
+  void stack_data(void);
+  void undoRedo(void);
+  void undoRedo_data(void);
+  void waveform(void);
+  void waveform_data(void);
+  void wireOrder(void);
+  void wireOrder_data(void);
+};
+
+QString glitch_bench::fileName(const int count)
+{
+  /*
+  ** One object of every twenty is a function containing nine
+  ** objects. The remaining objects are placed on the canvas.
+  */
+
+  if(m_fileNames.contains(count))
+    return m_fileNames.value(count);
+
+  auto parameters(glitch_diagram_generator::defaultParameters());
+
+  parameters.clones = 0;
+  parameters.functions = count / 20;
+  parameters.nesting = 0;
+  parameters.objects = 9;
+  parameters.canvasObjects = count - 10 * parameters.functions;
+
+  QString error("");
+  QString fileName
+    (m_directory.path() + QDir::separator() +
+     QString("bench-%1.db").arg(count));
+
+  if(!glitch_diagram_generator::generate(fileName, parameters, error))
+    qWarning() << error;
+
+  m_fileNames[count] = fileName;
+  return fileName;
+}
+
+glitch_view_arduino *glitch_bench::openView(const QString &fileName)
+{
+  QString error("");
+  auto view = new glitch_view_arduino
+    (fileName, "bench", true, glitch_common::ArduinoProject, nullptr);
+
+  if(!view->open(fileName, error))
+    qWarning() << error;
+
+  return view;
+}
+
+void glitch_bench::addSizes(const bool large)
+{
+  QTest::addColumn<int> ("count");
+  QTest::newRow("100") << 100;
+  QTest::newRow("1000") << 1000;
+  QTest::newRow("10000") << 10000;
+
+  if(large)
+    QTest::newRow("50000") << 50000;
+}
+
+void glitch_bench::align(void)
+{
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+  glitch_alignment alignment(view);
+  int i = 0;
+
+  view->selectAll();
+
+  QBENCHMARK
+    {
+      alignment.align
+	(i++ % 2 ? glitch_alignment::ALIGN_LEFT : glitch_alignment::ALIGN_TOP);
+    }
+
+  delete view;
+}
+
+void glitch_bench::align_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::callGraph(void)
+{
+  /*
+  ** A chain of calls is prepared. The benchmark closes and opens
+  ** a cycle spanning the chain. Detecting the cycle visits the chain.
+  */
+
+  QFETCH(int, count);
+
+  glitch_call_graph graph;
+
+  graph.addRoot("loop()");
+
+  for(int i = 0; i < count; i++)
+    {
+      QHash<QString, int> calls;
+
+      calls[QString("function_%1()").arg(i + 1)] = 1;
+      graph.addFunction(QString("function_%1()").arg(i));
+      graph.setCalls(QString("function_%1()").arg(i), calls);
+    }
+
+  QHash<QString, int> calls;
+
+  calls["function_0()"] = 1;
+  graph.setCalls("loop()", calls);
+
+  QHash<QString, int> cycle;
+
+  cycle["function_0()"] = 1;
+
+  auto last(QString("function_%1()").arg(count));
+
+  QBENCHMARK
+    {
+      QVERIFY(!graph.setCalls(last, cycle).isEmpty());
+      graph.setCalls(last, QHash<QString, int> ());
+    }
+
+  QVERIFY(graph.deadFunctions().isEmpty());
+}
+
+void glitch_bench::callGraph_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::cleanupTestCase(void)
+{
+  m_fileNames.clear();
+}
+
+void glitch_bench::contextMenu(void)
+{
+  QFETCH(int, count);
+
+  /*
+  ** Prepare the context menu of every object on the canvas. The
+  ** widgets and actions which remain afterwards are counted. Only
+  ** interfaces which predate the shared context menu actions are used
+  ** so that this benchmark may be compared against older trees.
+  */
+
+  auto name(fileName(count));
+  auto widgets = QApplication::allWidgets().size();
+  auto view = openView(name);
+  auto objects(view->scene()->objects());
+
+  for(auto object : objects)
+    if(object)
+      {
+	QMenu menu;
+
+	object->addActions(menu);
+      }
+
+  QSet<QAction *> actions;
+
+  for(auto action : view->findChildren<QAction *> ())
+    actions << action;
+
+  for(auto object : objects)
+    if(object)
+      for(auto action : object->findChildren<QAction *> ())
+	actions << action;
+
+  qInfo() << "Objects:" << objects.size()
+	  << "Actions:" << actions.size()
+	  << "Widgets:" << QApplication::allWidgets().size() - widgets;
+
+  QBENCHMARK
+    {
+      for(auto object : objects)
+	if(object)
+	  {
+	    QMenu menu;
+
+	    object->addActions(menu);
+	  }
+    }
+
+  delete view;
+}
+
+void glitch_bench::contextMenu_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::copyPaste(void)
+{
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+
+  view->selectAll();
+
+  QBENCHMARK
+    {
+      glitch_ui::copy(view->view());
+      glitch_ui::paste(view->view(), view->undoStack());
+    }
+
+  delete view;
+}
+
+void glitch_bench::copyPaste_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::deleteItems(void)
+{
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+
+  QBENCHMARK
+    {
+      view->selectAll();
+      view->deleteItems();
+      view->undo();
+    }
+
+  delete view;
+}
+
+void glitch_bench::deleteItems_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::drag(void)
+{
+  /*
+  ** Objects are dragged by way of simulated mouse events.
+  */
+
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+  auto viewport = view->view()->viewport();
+
+  view->resize(1024, 768);
+  view->show();
+  QVERIFY(QTest::qWaitForWindowExposed(view));
+
+  auto objects(view->objects());
+
+  QBENCHMARK
+    {
+      for(int i = 0; i < qMin(25, objects.size()); i++)
+	{
+	  auto object = objects.at(i);
+
+	  if(!object || !object->proxy())
+	    continue;
+
+	  QPoint point
+	    (view->view()->mapFromScene(object->proxy()->scenePos()) +
+	     QPoint(5, 5));
+
+	  if(!viewport->rect().contains(point))
+	    continue;
+
+	  QMouseEvent press
+	    (QEvent::MouseButtonPress,
+	     point,
+	     Qt::LeftButton,
+	     Qt::LeftButton,
+	     Qt::NoModifier);
+
+	  QApplication::sendEvent(viewport, &press);
+
+	  for(int j = 1; j <= 10; j++)
+	    {
+	      QMouseEvent move
+		(QEvent::MouseMove,
+		 point + QPoint(j, j),
+		 Qt::NoButton,
+		 Qt::LeftButton,
+		 Qt::NoModifier);
+
+	      QApplication::sendEvent(viewport, &move);
+	    }
+
+	  QMouseEvent release
+	    (QEvent::MouseButtonRelease,
+	     point + QPoint(10, 10),
+	     Qt::LeftButton,
+	     Qt::NoButton,
+	     Qt::NoModifier);
+
+	  QApplication::sendEvent(viewport, &release);
+	}
+
+      QCoreApplication::processEvents();
+    }
+
+  delete view;
+}
+
+void glitch_bench::drag_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::estimate(void)
+{
+  /*
+  ** loop() calls many functions. The benchmark changes one function
+  ** and estimates loop() again. The estimates of the other functions
+  ** are retained.
+  */
+
+  QFETCH(int, count);
+
+  QList<QMap<QString, QVariant> > body;
+  QList<QMap<QString, QVariant> > loop;
+  QMap<QString, QVariant> statement;
+  glitch_cost_model_arduino model;
+
+  statement["type"] = "arduino-analogread";
+  body << statement;
+
+  for(int i = 0; i < count; i++)
+    model.setStatements(QString("function_%1()").arg(i), body);
+
+  for(int i = 0; i < count; i++)
+    {
+      statement.clear();
+      statement["name"] = QString("function_%1()").arg(i);
+      statement["return_type"] = "void";
+      statement["type"] = "arduino-function";
+      loop << statement;
+    }
+
+  model.setStatements("loop()", loop);
+
+  auto worst = model.period().worst;
+  auto changed(body);
+
+  statement.clear();
+  statement["type"] = "arduino-analogread";
+  changed << statement;
+
+  QBENCHMARK
+    {
+      model.setStatements("function_0()", changed);
+      QVERIFY(model.period().worst > worst);
+      model.setStatements("function_0()", body);
+      QCOMPARE(model.period().worst, worst);
+    }
+}
+
+void glitch_bench::estimate_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::footprint(void)
+{
+  /*
+  ** Many functions are sized. The benchmark changes one function
+  ** and recomputes the objects which do not fit on a small board.
+  */
+
+  QFETCH(int, count);
+
+  QList<QMap<QString, QVariant> > body;
+  QMap<QString, QVariant> statement;
+  glitch_footprint_arduino footprint;
+
+  statement["type"] = "arduino-analogread";
+  body << statement;
+
+  for(int i = 0; i < count; i++)
+    footprint.setStatements(QString("function_%1()").arg(i), i + 1, body);
+
+  auto board(glitch_footprint_arduino::board("ATtiny85"));
+  auto changed(body);
+  auto flash = footprint.total().flash;
+
+  changed << statement;
+
+  QBENCHMARK
+    {
+      footprint.setStatements("function_0()", 1, changed);
+      QVERIFY(footprint.total().flash > flash);
+      footprint.overBudget(board, QStringList());
+      footprint.setStatements("function_0()", 1, body);
+      QCOMPARE(footprint.total().flash, flash);
+    }
+}
+
+void glitch_bench::footprint_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::initTestCase(void)
+{
+  QVERIFY(m_directory.isValid());
+  qputenv("GLITCH_HOME", m_directory.path().toUtf8());
+}
+
+void glitch_bench::open(void)
+{
+  QFETCH(int, count);
+
+  auto name(fileName(count));
+
+  QBENCHMARK
+    {
+      delete openView(name);
+    }
+}
+
+void glitch_bench::open_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::optimize(void)
+{
+  /*
+  ** loop() calls many small functions once. Each function is
+  ** inlined and its operators are folded.
+  */
+
+  QFETCH(int, count);
+
+  QList<QMap<QString, QVariant> > body;
+  QList<QMap<QString, QVariant> > loop;
+  QMap<QString, QVariant> statement;
+  glitch_optimizer_arduino optimizer;
+
+  statement["type"] = "arduino-analogread";
+  body << statement;
+  statement.clear();
+  statement["operator"] = "not";
+  statement["type"] = "arduino-logicaloperator";
+  body << statement << statement;
+
+  for(int i = 0; i < count; i++)
+    {
+      optimizer.addFunction
+	(QString("function_%1()").arg(i), "void", body);
+      statement.clear();
+      statement["name"] = QString("function_%1()").arg(i);
+      statement["return_type"] = "void";
+      statement["type"] = "arduino-function";
+      loop << statement;
+    }
+
+  optimizer.setLoop(loop);
+
+  QBENCHMARK
+    {
+      optimizer.optimize();
+      QCOMPARE(optimizer.report().inlined, count);
+      QVERIFY(optimizer.report().loopAfter.worst <
+	      optimizer.report().loopBefore.worst);
+    }
+}
+
+void glitch_bench::optimize_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::pinTrace(void)
+{
+  /*
+  ** loop() reads A0 while a trace is attached. A3 is changed between
+  ** runs. Both channels must receive samples.
+  */
+
+  QFETCH(int, count);
+
+  QList<QMap<QString, QVariant> > loop;
+  QMap<QString, QVariant> statement;
+  glitch_pin_trace trace;
+  glitch_simulator_arduino simulator;
+
+  statement["type"] = "arduino-analogread";
+  loop << statement;
+  simulator.setLoop(loop);
+  simulator.setAnalogPin(0, 512);
+  trace.open(false);
+  simulator.setTrace(&trace);
+  QCOMPARE(trace.count(),
+	   static_cast<int> (glitch_simulator_arduino::ANALOG_PINS));
+  QCOMPARE(trace.name(3), QString("A3"));
+
+  int level = 0;
+
+  QBENCHMARK
+    {
+      for(int i = 0; i < count; i += 1000)
+	{
+	  simulator.setAnalogPin(3, level++ % 2 ? 1023 : 0);
+	  QVERIFY(simulator.run(1000));
+	  trace.drain();
+	}
+    }
+
+  trace.drain();
+  QVERIFY(trace.samples(0) > 0);
+  QVERIFY(trace.samples(3) > 1);
+}
+
+void glitch_bench::pinTrace_data(void)
+{
+  QTest::addColumn<int> ("count");
+  QTest::newRow("100000") << 100000;
+  QTest::newRow("1000000") << 1000000;
+}
+
+void glitch_bench::proximity(void)
+{
+  /*
+  ** Objects are placed on a grid. An object is moved through the grid
+  ** and its neighbors are queried after every move.
+  */
+
+  QFETCH(int, count);
+
+  glitch_proximity proximity;
+  int columns = qMax(1, static_cast<int> (qSqrt(count)));
+
+  for(int i = 0; i < count; i++)
+    proximity.insert
+      (i, QRectF((i % columns) * 150.0, (i / columns) * 100.0, 100.0, 50.0));
+
+  int i = 0;
+
+  QBENCHMARK
+    {
+      QPointF point((i % columns) * 150.0 + 75.0, (i / columns) * 100.0);
+
+      proximity.insert(0, QRectF(point, QSizeF(100.0, 50.0)));
+      QCOMPARE(proximity.nearest(point, 5).size(), qMin(5, count));
+      i = (i + 1) % count;
+    }
+
+  QCOMPARE(proximity.order().size(), count);
+}
+
+void glitch_bench::proximity_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::save(void)
+{
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+  QString name
+    (m_directory.path() + QDir::separator() +
+     QString("bench-%1-saved.db").arg(count));
+
+  QBENCHMARK
+    {
+      QString error("");
+
+      QVERIFY2(view->saveAs(name, error), qPrintable(error));
+    }
+
+  delete view;
+}
+
+void glitch_bench::save_data(void)
+{
+  addSizes(true);
+}
+
+void glitch_bench::seek(void)
+{
+  /*
+  ** A recorded run of a hundred thousand iterations is rewound
+  ** to several iterations. Every seek replays fewer than
+  ** interval iterations.
+  */
+
+  QFETCH(int, interval);
+
+  QList<QMap<QString, QVariant> > loop;
+  QMap<QString, QVariant> statement;
+  glitch_simulator_arduino simulator;
+  const quint64 iterations = 100000;
+
+  statement["type"] = "arduino-analogread";
+  loop << statement << statement;
+  statement.clear();
+  statement["operator"] = "and";
+  statement["type"] = "arduino-logicaloperator";
+  loop << statement;
+  simulator.setLoop(loop);
+  simulator.setRecording(true, interval);
+
+  for(int i = 0; i < 10; i++)
+    {
+      simulator.setAnalogPin(0, i % 2 ? 512 : 0);
+      QVERIFY(simulator.run(iterations / 10));
+    }
+
+  auto micros = simulator.micros();
+
+  QBENCHMARK
+    {
+      for(quint64 i = iterations; i > 0; i /= 3)
+	QVERIFY(simulator.seek(i - 1));
+    }
+
+  QVERIFY(simulator.seek(iterations));
+  QCOMPARE(simulator.micros(), micros);
+}
+
+void glitch_bench::seek_data(void)
+{
+  QTest::addColumn<int> ("interval");
+  QTest::newRow("100") << 100;
+  QTest::newRow("1000") << 1000;
+  QTest::newRow("10000") << 10000;
+}
+
+void glitch_bench::serialLog(void)
+{
+  /*
+  ** Lines are appended to a full history. Every append discards
+  ** the oldest line.
+  */
+
+  QFETCH(int, count);
+
+  glitch_serial_log log(10000);
+
+  QBENCHMARK
+    {
+      log.clear();
+
+      for(int i = 0; i < count; i++)
+	{
+	  log.write(QByteArray("analogRead() = ") +
+		    QByteArray::number(i % 1024) +
+		    "\n");
+
+	  if(i % 1024 == 0)
+	    log.drain();
+	}
+
+      log.drain();
+    }
+
+  QCOMPARE(log.count(), static_cast<qint64> (qMin(count, 10000)));
+  QCOMPARE(log.line(log.first() + log.count() - 1),
+	   QString("analogRead() = %1").arg((count - 1) % 1024));
+}
+
+void glitch_bench::serialLog_data(void)
+{
+  QTest::addColumn<int> ("count");
+  QTest::newRow("100000") << 100000;
+  QTest::newRow("1000000") << 1000000;
+}
+
+void glitch_bench::simulate(void)
+{
+  /*
+  ** loop() calls a chain of functions. Each function reads an analog
+  ** pin, combines the values with logical operators, and calls the
+  ** next function. The bytecode is compared with the tree, with and
+  ** without profiles.
+  */
+
+  QFETCH(bool, profile);
+  QFETCH(int, count);
+  QFETCH(int, engine);
+
+  QList<QMap<QString, QVariant> > loop;
+  QMap<QString, QVariant> statement;
+  glitch_simulator_arduino simulator;
+  const int functions = 8;
+  qint64 id = 1;
+
+  for(int i = 0; i < functions; i++)
+    {
+      QList<QMap<QString, QVariant> > body;
+
+      for(int j = 0; j < 4; j++)
+	{
+	  statement.clear();
+	  statement["myoid"] = id++;
+	  statement["type"] = "arduino-analogread";
+	  body << statement;
+	  statement["myoid"] = id++;
+	  body << statement;
+	  statement.clear();
+	  statement["myoid"] = id++;
+	  statement["operator"] = j % 2 ? "or" : "and";
+	  statement["type"] = "arduino-logicaloperator";
+	  body << statement;
+	  statement["myoid"] = id++;
+	  statement["operator"] = "not";
+	  body << statement;
+	}
+
+      if(i + 1 < functions)
+	{
+	  statement.clear();
+	  statement["myoid"] = id++;
+	  statement["name"] = QString("function_%1()").arg(i + 1);
+	  statement["return_type"] = i % 2 ? "float" : "int";
+	  statement["type"] = "arduino-function";
+	  body << statement;
+	  statement.clear();
+	  statement["myoid"] = id++;
+	  statement["operator"] = "or";
+	  statement["type"] = "arduino-logicaloperator";
+	  body << statement;
+	}
+
+      simulator.addFunction
+	(QString("function_%1()").arg(i), i % 2 ? "int" : "float", body, id++);
+    }
+
+  statement.clear();
+  statement["myoid"] = id++;
+  statement["name"] = "function_0()";
+  statement["return_type"] = "float";
+  statement["type"] = "arduino-function";
+  loop << statement;
+  simulator.setEngine
+    (static_cast<glitch_simulator_arduino::Engines> (engine));
+  simulator.setLoop(loop);
+  simulator.setAnalogPin(0, 512);
+  simulator.setProfiling(profile);
+
+  QBENCHMARK
+    {
+      QVERIFY(simulator.run(static_cast<quint64> (count)));
+    }
+
+  QVERIFY(simulator.millis() > 0);
+
+  if(profile)
+    QCOMPARE(simulator.functionProfiles().value("loop()").micros,
+	     simulator.micros());
+}
+
+void glitch_bench::simulate_data(void)
+{
+  QTest::addColumn<bool> ("profile");
+  QTest::addColumn<int> ("count");
+  QTest::addColumn<int> ("engine");
+  QTest::newRow("bytecode-100000")
+    << false
+    << 100000
+    << static_cast<int> (glitch_simulator_arduino::BYTECODE);
+  QTest::newRow("bytecode-1000000")
+    << false
+    << 1000000
+    << static_cast<int> (glitch_simulator_arduino::BYTECODE);
+  QTest::newRow("bytecode-profiled-1000000")
+    << true
+    << 1000000
+    << static_cast<int> (glitch_simulator_arduino::BYTECODE);
+  QTest::newRow("tree-100000")
+    << false
+    << 100000
+    << static_cast<int> (glitch_simulator_arduino::TREE);
+  QTest::newRow("tree-1000000")
+    << false
+    << 1000000
+    << static_cast<int> (glitch_simulator_arduino::TREE);
+  QTest::newRow("tree-profiled-1000000")
+    << true
+    << 1000000
+    << static_cast<int> (glitch_simulator_arduino::TREE);
+}
+
+void glitch_bench::stack(void)
+{
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+  glitch_alignment alignment(view);
+  int i = 0;
+
+  view->selectAll();
+
+  QBENCHMARK
+    {
+      alignment.stack
+	(i++ % 2 ?
+	 glitch_alignment::HORIZONTAL_STACK :
+	 glitch_alignment::VERTICAL_STACK);
+    }
+
+  delete view;
+}
+
+void glitch_bench::stack_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::undoRedo(void)
+{
+  /*
+  ** A single macro containing a move of every object.
+  */
+
+  QFETCH(int, count);
+
+  auto view = openView(fileName(count));
+  glitch_alignment alignment(view);
+
+  view->selectAll();
+  alignment.align(glitch_alignment::ALIGN_LEFT);
+  QVERIFY(view->canUndo());
+
+  QBENCHMARK
+    {
+      view->undo();
+      view->redo();
+    }
+
+  delete view;
+}
+
+void glitch_bench::undoRedo_data(void)
+{
+  addSizes(false);
+}
+
+void glitch_bench::waveform(void)
+{
+  /*
+  ** The extremes of a thousand columns are computed at several
+  ** magnifications of a trace of square waves.
+  */
+
+  QFETCH(int, count);
+
+  glitch_pin_trace trace;
+  auto channel = trace.addChannel("D0", 1);
+
+  for(int i = 0; i < count; i++)
+    {
+      trace.record(channel, static_cast<quint64> (i), (i / 3) % 2);
+
+      if(i % 4096 == 0)
+	trace.drain();
+    }
+
+  trace.drain();
+  QCOMPARE(trace.samples(channel), static_cast<qint64> (count));
+
+  QBENCHMARK
+    {
+      for(quint64 span = trace.duration(); span > 1000; span /= 10)
+	QCOMPARE(trace.extents(channel, 0, span, 1000).size(), 1000);
+    }
+}
+
+void glitch_bench::waveform_data(void)
+{
+  QTest::addColumn<int> ("count");
+  QTest::newRow("1000000") << 1000000;
+  QTest::newRow("4000000") << 4000000;
+}
+
+void glitch_bench::wireOrder(void)
+{
+  /*
+  ** Objects are wired in the reverse of their positional order. Every
+  ** object is therefore moved.
+  */
+
+  QFETCH(int, count);
+
+  QList<qint64> ids;
+  glitch_wire_graph graph;
+
+  for(int i = 0; i < count; i++)
+    {
+      ids << i;
+
+      if(i > 0)
+	graph.addWire(i, i - 1);
+    }
+
+  QList<qint64> order;
+
+  QBENCHMARK
+    {
+      order = graph.order(ids);
+    }
+
+  QCOMPARE(order.size(), count);
+  QCOMPARE(order.value(0), static_cast<qint64> (count - 1));
+}
+
+void glitch_bench::wireOrder_data(void)
+{
+  addSizes(true);
+}
+
+QTEST_MAIN(glitch_bench)
+#include "glitch-bench.moc"
@@ -0,0 +1,355 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QCryptographicHash>
+#include <QPointF>
+#include <QStringList>
+
+#include "glitch-code-generator-arduino.h"
+#include "glitch-diagram.h"
+
+static void flush(QString &code, QStringList &values)
+{
+  for(const auto &value : values)
+    code.append(QString("  %1;\n").arg(value));
+
+  values.clear();
+}
+
+static bool statement_less_than(const QMap<QString, QVariant> &s1,
+				const QMap<QString, QVariant> &s2)
+{
+  /*
+  ** Diagrams are interpreted from the top down. Objects sharing
+  ** a row are interpreted from left to right.
+  */
+
+  QPointF p1(s1.value("position").toPointF());
+  QPointF p2(s2.value("position").toPointF());
+
+  if(!qFuzzyCompare(p1.y(), p2.y()))
+    return p1.y() < p2.y();
+  else if(!qFuzzyCompare(p1.x(), p2.x()))
+    return p1.x() < p2.x();
+  else
+    return s1.value("myoid").toULongLong() < s2.value("myoid").toULongLong();
+}
+
+QByteArray glitch_code_generator_arduino::hash
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  /*
+  ** Only the properties which influence the generated source are
+  ** included. The statements must be sorted.
+  */
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+
+  for(const auto &statement : statements)
+    {
+      hash.addData(statement.value("type").toString().toUtf8());
+      hash.addData("\n");
+      hash.addData(statement.value("clone").toString().toUtf8());
+      hash.addData("\n");
+      hash.addData(statement.value("name").toString().toUtf8());
+      hash.addData("\n");
+      hash.addData(statement.value("operator").toString().toUtf8());
+      hash.addData("\n");
+      hash.addData(statement.value("return_type").toString().toUtf8());
+      hash.addData("\n");
+    }
+
+  return hash.result();
+}
+
+QHash<QString, int> glitch_code_generator_arduino::calls
+(const QList<glitch_diagram_object> &objects)
+{
+  /*
+  ** Every function placed in a body is a call.
+  */
+
+  QHash<QString, int> calls;
+
+  for(const auto &object : objects)
+    if(object.type() == "arduino-function")
+      {
+	QString name(object.property("name").toString().trimmed());
+
+	if(!name.isEmpty())
+	  calls[name] += 1;
+      }
+
+  return calls;
+}
+
+QList<QMap<QString, QVariant> > glitch_code_generator_arduino::statements
+(const QList<glitch_diagram_object> &objects, const glitch_wire_graph &wires)
+{
+  /*
+  ** The objects' values in the order of interpretation.
+  */
+
+  QList<QMap<QString, QVariant> > statements;
+
+  for(const auto &object : objects)
+    statements << object.values();
+
+  sort(statements, wires);
+  return statements;
+}
+
+QString glitch_code_generator_arduino::body
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  /*
+  ** Objects producing values are held until a consumer or a statement
+  ** without a value is reached. Remaining values are emitted as
+  ** statements.
+  */
+
+  QString code("");
+  QStringList values;
+
+  for(const auto &statement : statements)
+    {
+      QString type(statement.value("type").toString());
+
+      if(type == "arduino-analogread")
+	values << "analogRead(A0)";
+      else if(type == "arduino-constant")
+	values << (statement.value("value").toBool() ? "true" : "false");
+      else if(type == "arduino-function")
+	{
+	  QString name(statement.value("name").toString().trimmed());
+
+	  if(name.isEmpty())
+	    continue;
+
+	  if(statement.value("return_type").toString() == "void")
+	    {
+	      flush(code, values);
+	      code.append(QString("  %1;\n").arg(name));
+	    }
+	  else
+	    values << name;
+	}
+      else if(type == "arduino-logicaloperator")
+	{
+	  QString o(statement.value("operator").toString());
+
+	  if(o == "not")
+	    {
+	      QString value(values.isEmpty() ? "false" : values.takeLast());
+
+	      values << QString("!(%1)").arg(value);
+	    }
+	  else
+	    {
+	      /*
+	      ** Missing operands are replaced with identity values.
+	      */
+
+	      QString identity(o == "or" ? "false" : "true");
+	      QString value2(values.isEmpty() ? identity : values.takeLast());
+	      QString value1(values.isEmpty() ? identity : values.takeLast());
+
+	      values << QString("(%1 %2 %3)").
+		arg(value1).arg(o == "or" ? "||" : "&&").arg(value2);
+	    }
+	}
+    }
+
+  flush(code, values);
+  return code;
+}
+
+QString glitch_code_generator_arduino::body
+(const QList<glitch_diagram_object> &objects)
+{
+  return body(objects, glitch_wire_graph());
+}
+
+QString glitch_code_generator_arduino::body
+(const QList<glitch_diagram_object> &objects, const glitch_wire_graph &wires)
+{
+  return body(statements(objects, wires));
+}
+
+QString glitch_code_generator_arduino::body(const glitch_diagram &diagram,
+					    const qint64 id)
+{
+  return body(diagram.children(id), diagram.wireGraph(id));
+}
+
+QString glitch_code_generator_arduino::function(const QString &returnType,
+						const QString &name,
+						const QString &body)
+{
+  return QString("%1 %2\n{\n%3}\n").arg(returnType).arg(name).arg(body);
+}
+
+QString glitch_code_generator_arduino::sketch(const glitch_diagram &diagram)
+{
+  QMap<QString, QString> functions;
+  QString loop("");
+  QString setup("");
+
+  for(const auto &object : diagram.topLevelObjects())
+    if(object.type() == "arduino-function")
+      {
+	if(object.property("clone").toBool())
+	  continue;
+
+	QString name(object.property("name").toString().trimmed());
+
+	functions[name] = function
+	  (object.property("return_type").toString(),
+	   name,
+	   body(diagram, object.id()));
+      }
+    else if(object.type() == "arduino-loop")
+      loop = body(diagram, object.id());
+    else if(object.type() == "arduino-setup")
+      setup = body(diagram, object.id());
+
+  return sketch(functions,
+		callGraph(diagram).order(),
+		function("void", "setup()", setup),
+		function("void", "loop()", loop));
+}
+
+QString glitch_code_generator_arduino::sketch
+(const QMap<QString, QString> &functions,
+ const QString &setup,
+ const QString &loop)
+{
+  return sketch(functions, QStringList(), setup, loop);
+}
+
+QString glitch_code_generator_arduino::sketch
+(const QMap<QString, QString> &functions,
+ const QStringList &order,
+ const QString &setup,
+ const QString &loop)
+{
+  /*
+  ** Functions are defined in the given order so that callees are
+  ** defined before their callers. Remaining functions follow.
+  */
+
+  QMap<QString, QString> remaining(functions);
+  QString sketch("");
+
+  for(const auto &name : order)
+    if(remaining.contains(name))
+      {
+	sketch.append(remaining.take(name));
+	sketch.append("\n");
+      }
+
+  QMapIterator<QString, QString> it(remaining);
+
+  while(it.hasNext())
+    {
+      it.next();
+      sketch.append(it.value());
+      sketch.append("\n");
+    }
+
+  sketch.append(setup);
+  sketch.append("\n");
+  sketch.append(loop);
+  return sketch;
+}
+
+glitch_call_graph glitch_code_generator_arduino::callGraph
+(const glitch_diagram &diagram)
+{
+  glitch_call_graph graph;
+
+  graph.addRoot("loop()");
+  graph.addRoot("setup()");
+
+  for(const auto &object : diagram.topLevelObjects())
+    if(object.type() == "arduino-function" &&
+       !object.property("clone").toBool())
+      graph.addFunction(object.property("name").toString().trimmed());
+
+  for(const auto &object : diagram.topLevelObjects())
+    if(object.type() == "arduino-function" &&
+       !object.property("clone").toBool())
+      graph.setCalls(object.property("name").toString().trimmed(),
+		     calls(diagram.children(object.id())));
+    else if(object.type() == "arduino-loop")
+      graph.setCalls("loop()", calls(diagram.children(object.id())));
+    else if(object.type() == "arduino-setup")
+      graph.setCalls("setup()", calls(diagram.children(object.id())));
+
+  return graph;
+}
+
+void glitch_code_generator_arduino::order
+(QList<QMap<QString, QVariant> > &statements, const glitch_wire_graph &wires)
+{
+  /*
+  ** Wired objects are evaluated after the objects feeding them.
+  ** Otherwise, the given order, usually positional, is retained.
+  */
+
+  if(wires.count() == 0)
+    return;
+
+  QHash<qint64, QMap<QString, QVariant> > hash;
+  QList<qint64> ids;
+
+  for(const auto &statement : statements)
+    {
+      auto id = statement.value("myoid").toLongLong();
+
+      hash[id] = statement;
+      ids << id;
+    }
+
+  statements.clear();
+
+  for(auto id : wires.order(ids))
+    statements << hash.value(id);
+}
+
+void glitch_code_generator_arduino::sort
+(QList<QMap<QString, QVariant> > &statements)
+{
+  std::sort(statements.begin(), statements.end(), statement_less_than);
+}
+
+void glitch_code_generator_arduino::sort
+(QList<QMap<QString, QVariant> > &statements, const glitch_wire_graph &wires)
+{
+  sort(statements);
+  order(statements, wires);
+}
@@ -0,0 +1,79 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_code_generator_arduino_h_
+#define _glitch_code_generator_arduino_h_
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QVariant>
+
+#include "glitch-call-graph.h"
+#include "glitch-wire-graph.h"
+
+class glitch_diagram;
+class glitch_diagram_object;
+
+class glitch_code_generator_arduino
+{
+ public:
+  static QByteArray hash(const QList<QMap<QString, QVariant> > &statements);
+  static QHash<QString, int> calls(const QList<glitch_diagram_object> &objects);
+  static QList<QMap<QString, QVariant> > statements
+    (const QList<glitch_diagram_object> &objects,
+     const glitch_wire_graph &wires);
+  static QString body(const QList<QMap<QString, QVariant> > &statements);
+  static QString body(const QList<glitch_diagram_object> &objects);
+  static QString body(const QList<glitch_diagram_object> &objects,
+		      const glitch_wire_graph &wires);
+  static QString body(const glitch_diagram &diagram, const qint64 id);
+  static QString function(const QString &returnType,
+			  const QString &name,
+			  const QString &body);
+  static QString sketch(const glitch_diagram &diagram);
+  static QString sketch(const QMap<QString, QString> &functions,
+			const QString &setup,
+			const QString &loop);
+  static QString sketch(const QMap<QString, QString> &functions,
+			const QStringList &order,
+			const QString &setup,
+			const QString &loop);
+  static glitch_call_graph callGraph(const glitch_diagram &diagram);
+  static void order(QList<QMap<QString, QVariant> > &statements,
+		    const glitch_wire_graph &wires);
+  static void sort(QList<QMap<QString, QVariant> > &statements);
+  static void sort(QList<QMap<QString, QVariant> > &statements,
+		   const glitch_wire_graph &wires);
+
+ private:
+  glitch_code_generator_arduino(void);
+  ~glitch_code_generator_arduino();
+};
+
+#endif
@@ -0,0 +1,332 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QQueue>
+
+#include <algorithm>
+
+#include "glitch-cost-model-arduino.h"
+
+/*
+** Approximate cycles of an ATmega328P at 16 MHz. The structures are
+** interpreted as the code generator interprets them: values are held
+** until they are consumed. The right operand of a logical operator
+** is evaluated in half of the typical cases.
+*/
+
+static const quint64 s_analogReadCycles = 1600;
+static const quint64 s_callCycles = 10;
+static const quint64 s_logicalOperatorCycles = 4;
+static const quint64 s_loopCycles = 16;
+static const quint64 s_notCycles = 3;
+
+glitch_cost_model_arduino::glitch_cost_model_arduino(void)
+{
+}
+
+glitch_cost_model_arduino::~glitch_cost_model_arduino()
+{
+}
+
+glitch_cost_model_arduino::Estimate glitch_cost_model_arduino::estimate
+(const QString &name) const
+{
+  QSet<QString> path;
+
+  return fold(name, path);
+}
+
+glitch_cost_model_arduino::Estimate glitch_cost_model_arduino::fold
+(const QString &name, QSet<QString> &path) const
+{
+  /*
+  ** Estimates are retained until a function which they include
+  ** is changed. A function which reaches itself is not bounded.
+  */
+
+  if(m_estimates.contains(name))
+    return m_estimates.value(name);
+
+  Estimate estimate;
+
+  estimate.bounded = !path.contains(name);
+  estimate.typical = 0.0;
+  estimate.worst = 0;
+
+  if(!estimate.bounded || !m_bodies.contains(name))
+    return estimate;
+
+  path.insert(name);
+
+  auto body(m_bodies.value(name));
+
+  estimate.typical = body.typical;
+  estimate.worst = body.worst;
+
+  QHashIterator<QString, QPair<quint64, double> > it(body.calls);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      auto callee(fold(it.key(), path));
+
+      estimate.bounded = callee.bounded && estimate.bounded;
+      estimate.typical += it.value().second * callee.typical;
+      estimate.worst += it.value().first * callee.worst;
+    }
+
+  path.remove(name);
+  m_estimates[name] = estimate;
+  return estimate;
+}
+
+glitch_cost_model_arduino::Estimate glitch_cost_model_arduino::period
+(void) const
+{
+  /*
+  ** An iteration of main()'s loop: the call of loop() and the test
+  ** for serial events.
+  */
+
+  auto estimate(this->estimate("loop()"));
+
+  estimate.typical += static_cast<double> (s_loopCycles);
+  estimate.worst += s_loopCycles;
+  return estimate;
+}
+
+glitch_cost_model_arduino::Body glitch_cost_model_arduino::body
+(const quint64 cycles)
+{
+  Body body;
+
+  body.typical = static_cast<double> (cycles);
+  body.worst = cycles;
+  return body;
+}
+
+QStringList glitch_cost_model_arduino::functions(void) const
+{
+  auto functions(m_bodies.keys());
+
+  std::sort(functions.begin(), functions.end());
+  return functions;
+}
+
+bool glitch_cost_model_arduino::contains(const QString &name) const
+{
+  return m_bodies.contains(name);
+}
+
+double glitch_cost_model_arduino::micros(const double cycles)
+{
+  return 1000000.0 * cycles / static_cast<double> (CLOCK);
+}
+
+void glitch_cost_model_arduino::add(Body &body,
+				    const Body &other,
+				    const double weight)
+{
+  QHashIterator<QString, QPair<quint64, double> > it(other.calls);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      auto &call(body.calls[it.key()]);
+
+      call.first += it.value().first;
+      call.second += weight * it.value().second;
+    }
+
+  body.typical += weight * other.typical;
+  body.worst += other.worst;
+}
+
+void glitch_cost_model_arduino::clear(void)
+{
+  m_bodies.clear();
+  m_callers.clear();
+  m_estimates.clear();
+}
+
+void glitch_cost_model_arduino::invalidate(const QString &name)
+{
+  /*
+  ** Discard the estimates of the function and of its direct and
+  ** indirect callers.
+  */
+
+  QQueue<QString> queue;
+  QSet<QString> visited;
+
+  queue.enqueue(name);
+  visited << name;
+
+  while(!queue.isEmpty())
+    {
+      auto function(queue.dequeue());
+
+      m_estimates.remove(function);
+
+      for(const auto &caller : m_callers.value(function))
+	if(!visited.contains(caller))
+	  {
+	    queue.enqueue(caller);
+	    visited << caller;
+	  }
+    }
+}
+
+void glitch_cost_model_arduino::removeFunction(const QString &name)
+{
+  /*
+  ** Calls of the function are retained.
+  */
+
+  if(!m_bodies.contains(name))
+    return;
+
+  for(const auto &callee : m_bodies.value(name).calls.keys())
+    m_callers[callee].remove(name);
+
+  invalidate(name);
+  m_bodies.remove(name);
+}
+
+void glitch_cost_model_arduino::renameFunction(const QString &before,
+					       const QString &after)
+{
+  if(after.isEmpty() || before.isEmpty() || before == after)
+    return;
+
+  invalidate(before);
+  invalidate(after);
+
+  for(const auto &caller : m_callers.value(before))
+    if(m_bodies.contains(caller))
+      {
+	auto &calls(m_bodies[caller].calls);
+	auto call(calls.take(before));
+	auto &renamed(calls[after]);
+
+	renamed.first += call.first;
+	renamed.second += call.second;
+      }
+
+  m_callers[after] += m_callers.take(before);
+
+  if(m_bodies.contains(before))
+    {
+      m_bodies[after] = m_bodies.take(before);
+
+      for(const auto &callee : m_bodies.value(after).calls.keys())
+	{
+	  m_callers[callee].remove(before);
+	  m_callers[callee].insert(after);
+	}
+    }
+}
+
+void glitch_cost_model_arduino::setStatements
+(const QString &name, const QList<QMap<QString, QVariant> > &statements)
+{
+  /*
+  ** Only the function's body is interpreted. The estimates of its
+  ** callers are computed again when requested.
+  */
+
+  Body function = body(0);
+  QVector<Body> values;
+
+  for(const auto &statement : statements)
+    {
+      QString type(statement.value("type").toString());
+
+      if(type == "arduino-analogread")
+	values << body(s_analogReadCycles);
+      else if(type == "arduino-constant")
+	values << body(0);
+      else if(type == "arduino-function")
+	{
+	  QString callee(statement.value("name").toString().trimmed());
+
+	  if(callee.isEmpty())
+	    continue;
+
+	  auto call(body(s_callCycles));
+
+	  call.calls[callee] = qMakePair(static_cast<quint64> (1), 1.0);
+
+	  if(statement.value("return_type").toString() == "void")
+	    {
+	      for(const auto &value : values)
+		add(function, value, 1.0);
+
+	      add(function, call, 1.0);
+	      values.clear();
+	    }
+	  else
+	    values << call;
+	}
+      else if(type == "arduino-logicaloperator")
+	{
+	  QString o(statement.value("operator").toString());
+
+	  if(o == "not")
+	    {
+	      auto value(values.isEmpty() ? body(0) : values.takeLast());
+
+	      add(value, body(s_notCycles), 1.0);
+	      values << value;
+	    }
+	  else
+	    {
+	      auto value2(values.isEmpty() ? body(0) : values.takeLast());
+	      auto value1(values.isEmpty() ? body(0) : values.takeLast());
+
+	      add(value1, value2, 0.5);
+	      add(value1, body(s_logicalOperatorCycles), 1.0);
+	      values << value1;
+	    }
+	}
+    }
+
+  for(const auto &value : values)
+    add(function, value, 1.0);
+
+  if(m_bodies.contains(name))
+    for(const auto &callee : m_bodies.value(name).calls.keys())
+      m_callers[callee].remove(name);
+
+  for(const auto &callee : function.calls.keys())
+    m_callers[callee].insert(name);
+
+  m_bodies[name] = function;
+  invalidate(name);
+}
@@ -0,0 +1,94 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_cost_model_arduino_h_
+#define _glitch_cost_model_arduino_h_
+
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QVariant>
+
+class glitch_cost_model_arduino
+{
+ public:
+  enum
+  {
+    CLOCK = 16000000
+  };
+
+  /*
+  ** Cycles of a function, including its calls. The worst case
+  ** evaluates every operand. Recursive functions are not bounded.
+  */
+
+  struct Estimate
+  {
+    bool bounded;
+    double typical;
+    quint64 worst;
+  };
+
+  glitch_cost_model_arduino(void);
+  ~glitch_cost_model_arduino();
+  Estimate estimate(const QString &name) const;
+  Estimate period(void) const;
+  QStringList functions(void) const;
+  bool contains(const QString &name) const;
+  static double micros(const double cycles);
+  void clear(void);
+  void removeFunction(const QString &name);
+  void renameFunction(const QString &before, const QString &after);
+  void setStatements(const QString &name,
+		     const QList<QMap<QString, QVariant> > &statements);
+
+ private:
+  /*
+  ** The cycles of a body without its callees. Calls are counted
+  ** per callee: sites for the worst case and weights for
+  ** the typical case.
+  */
+
+  struct Body
+  {
+    QHash<QString, QPair<quint64, double> > calls;
+    double typical;
+    quint64 worst;
+  };
+
+  QHash<QString, Body> m_bodies;
+  QHash<QString, QSet<QString> > m_callers;
+  mutable QHash<QString, Estimate> m_estimates;
+  Estimate fold(const QString &name, QSet<QString> &path) const;
+  static Body body(const quint64 cycles);
+  static void add(Body &body, const Body &other, const double weight);
+  void invalidate(const QString &name);
+};
+
+#endif
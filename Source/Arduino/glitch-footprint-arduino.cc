@@ -0,0 +1,350 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include "glitch-footprint-arduino.h"
+
+/*
+** Approximate sizes of avr-gcc -Os output, in bytes. The runtime of
+** an empty sketch is included once. A library is included once if
+** one of its objects is present. Stack frames are summed, which bounds
+** diagrams without recursion.
+*/
+
+static const qint64 s_analogReadFlash = 8;
+static const qint64 s_analogReadLibraryFlash = 82;
+static const qint64 s_analogReadLibrarySram = 1;
+static const qint64 s_callFlash = 4;
+static const qint64 s_functionFlash = 6;
+static const qint64 s_functionSram = 2;
+static const qint64 s_logicalOperatorFlash = 8;
+static const qint64 s_notFlash = 4;
+static const qint64 s_runtimeFlash = 444;
+static const qint64 s_runtimeSram = 9;
+
+glitch_footprint_arduino::glitch_footprint_arduino(void)
+{
+  m_total = footprint(0, 0);
+}
+
+glitch_footprint_arduino::~glitch_footprint_arduino()
+{
+}
+
+glitch_footprint_arduino::Board glitch_footprint_arduino::board
+(const QString &name)
+{
+  Board board;
+
+  board.name = name;
+
+  if(name == "ATtiny85")
+    {
+      board.flash = 8192;
+      board.sram = 512;
+    }
+  else if(name == "Leonardo")
+    {
+      board.flash = 28672;
+      board.sram = 2560;
+    }
+  else if(name == "Mega 2560")
+    {
+      board.flash = 253952;
+      board.sram = 8192;
+    }
+  else if(name == "Nano")
+    {
+      board.flash = 30720;
+      board.sram = 2048;
+    }
+  else
+    {
+      board.flash = 32256;
+      board.name = "Uno";
+      board.sram = 2048;
+    }
+
+  return board;
+}
+
+glitch_footprint_arduino::Footprint glitch_footprint_arduino::footprint
+(const qint64 flash, const qint64 sram)
+{
+  Footprint footprint;
+
+  footprint.flash = flash;
+  footprint.sram = sram;
+  return footprint;
+}
+
+glitch_footprint_arduino::Footprint glitch_footprint_arduino::library
+(const QString &type)
+{
+  if(type == "arduino-analogread")
+    return footprint(s_analogReadLibraryFlash, s_analogReadLibrarySram);
+  else
+    return footprint(0, 0);
+}
+
+glitch_footprint_arduino::Footprint glitch_footprint_arduino::object
+(const QMap<QString, QVariant> &statement)
+{
+  QString type(statement.value("type").toString());
+
+  if(type == "arduino-analogread")
+    return footprint(s_analogReadFlash, 0);
+  else if(type == "arduino-function")
+    return footprint(s_callFlash, 0);
+  else if(type == "arduino-logicaloperator")
+    {
+      if(statement.value("operator").toString() == "not")
+	return footprint(s_notFlash, 0);
+      else
+	return footprint(s_logicalOperatorFlash, 0);
+    }
+  else
+    return footprint(0, 0);
+}
+
+glitch_footprint_arduino::Footprint glitch_footprint_arduino::total
+(void) const
+{
+  auto total(m_total);
+
+  total.flash += s_runtimeFlash;
+  total.sram += s_runtimeSram;
+
+  QHashIterator<QString, int> it(m_counts);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      if(it.value() > 0)
+	{
+	  total.flash += library(it.key()).flash;
+	  total.sram += library(it.key()).sram;
+	}
+    }
+
+  return total;
+}
+
+QMap<QString, glitch_footprint_arduino::Footprint> glitch_footprint_arduino::
+functions(void) const
+{
+  QHashIterator<QString, Body> it(m_bodies);
+  QMap<QString, Footprint> functions;
+
+  while(it.hasNext())
+    {
+      it.next();
+      functions[it.key()] = it.value().footprint;
+    }
+
+  return functions;
+}
+
+QMap<QString, glitch_footprint_arduino::Footprint> glitch_footprint_arduino::
+types(void) const
+{
+  /*
+  ** Libraries are attributed to the types of their objects.
+  */
+
+  QHashIterator<QString, int> it(m_counts);
+  QMap<QString, Footprint> types;
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      if(it.value() <= 0)
+	continue;
+
+      auto &footprint(types[it.key()]);
+
+      footprint = m_types.value(it.key());
+      footprint.flash += library(it.key()).flash;
+      footprint.sram += library(it.key()).sram;
+    }
+
+  return types;
+}
+
+QSet<qint64> glitch_footprint_arduino::overBudget
+(const Board &board, const QStringList &order) const
+{
+  /*
+  ** The objects which follow the point at which the sketch exceeds
+  ** the board's memory. Functions are placed in the given order.
+  */
+
+  QSet<QString> libraries;
+  QSet<qint64> ids;
+  QStringList names(order);
+  auto remaining(m_bodies.keys());
+  auto used(footprint(s_runtimeFlash, s_runtimeSram));
+
+  std::sort(remaining.begin(), remaining.end());
+
+  for(const auto &name : remaining)
+    if(!names.contains(name))
+      names << name;
+
+  for(const auto &name : names)
+    {
+      if(!m_bodies.contains(name))
+	continue;
+
+      auto body(m_bodies.value(name));
+
+      used.flash += s_functionFlash;
+      used.sram += s_functionSram;
+
+      if(used.flash > board.flash || used.sram > board.sram)
+	ids << body.id;
+
+      for(const auto &item : body.items)
+	{
+	  if(!libraries.contains(item.type))
+	    {
+	      libraries << item.type;
+	      used.flash += library(item.type).flash;
+	      used.sram += library(item.type).sram;
+	    }
+
+	  used.flash += item.footprint.flash;
+	  used.sram += item.footprint.sram;
+
+	  if(used.flash > board.flash || used.sram > board.sram)
+	    ids << item.id;
+	}
+    }
+
+  return ids;
+}
+
+QStringList glitch_footprint_arduino::boards(void)
+{
+  return QStringList() << "ATtiny85"
+		       << "Leonardo"
+		       << "Mega 2560"
+		       << "Nano"
+		       << "Uno";
+}
+
+void glitch_footprint_arduino::add(const Body &body, const int sign)
+{
+  /*
+  ** Apply or withdraw a body's contribution.
+  */
+
+  auto &definition(m_types[body.type]);
+
+  definition.flash += sign * s_functionFlash;
+  definition.sram += sign * s_functionSram;
+  m_counts[body.type] += sign;
+  m_total.flash += sign * body.footprint.flash;
+  m_total.sram += sign * body.footprint.sram;
+
+  for(const auto &item : body.items)
+    {
+      auto &footprint(m_types[item.type]);
+
+      footprint.flash += sign * item.footprint.flash;
+      footprint.sram += sign * item.footprint.sram;
+      m_counts[item.type] += sign;
+    }
+}
+
+void glitch_footprint_arduino::clear(void)
+{
+  m_bodies.clear();
+  m_counts.clear();
+  m_total = footprint(0, 0);
+  m_types.clear();
+}
+
+void glitch_footprint_arduino::removeFunction(const QString &name)
+{
+  if(m_bodies.contains(name))
+    add(m_bodies.take(name), -1);
+}
+
+void glitch_footprint_arduino::renameFunction(const QString &before,
+					      const QString &after)
+{
+  if(after.isEmpty() || before.isEmpty() || before == after)
+    return;
+
+  if(m_bodies.contains(before))
+    m_bodies[after] = m_bodies.take(before);
+}
+
+void glitch_footprint_arduino::setStatements
+(const QString &name,
+ const qint64 id,
+ const QList<QMap<QString, QVariant> > &statements)
+{
+  /*
+  ** The previous contribution of the body is withdrawn. The remaining
+  ** bodies are not visited.
+  */
+
+  Body body;
+
+  body.footprint = footprint(s_functionFlash, s_functionSram);
+  body.id = id;
+
+  if(name == "loop()")
+    body.type = "arduino-loop";
+  else if(name == "setup()")
+    body.type = "arduino-setup";
+  else
+    body.type = "arduino-function";
+
+  for(const auto &statement : statements)
+    {
+      Item item;
+
+      item.footprint = object(statement);
+      item.id = statement.value("myoid").toLongLong();
+      item.type = statement.value("type").toString();
+      body.footprint.flash += item.footprint.flash;
+      body.footprint.sram += item.footprint.sram;
+      body.items << item;
+    }
+
+  if(m_bodies.contains(name))
+    add(m_bodies.value(name), -1);
+
+  add(body, 1);
+  m_bodies[name] = body;
+}
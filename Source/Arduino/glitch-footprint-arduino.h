@@ -0,0 +1,100 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_footprint_arduino_h_
+#define _glitch_footprint_arduino_h_
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+class glitch_footprint_arduino
+{
+ public:
+  struct Footprint
+  {
+    qint64 flash;
+    qint64 sram;
+  };
+
+  /*
+  ** The memory which is available to sketches. Bootloaders
+  ** are excluded.
+  */
+
+  struct Board
+  {
+    QString name;
+    qint64 flash;
+    qint64 sram;
+  };
+
+  glitch_footprint_arduino(void);
+  ~glitch_footprint_arduino();
+  Footprint total(void) const;
+  QMap<QString, Footprint> functions(void) const;
+  QMap<QString, Footprint> types(void) const;
+  QSet<qint64> overBudget(const Board &board, const QStringList &order) const;
+  static Board board(const QString &name);
+  static QStringList boards(void);
+  void clear(void);
+  void removeFunction(const QString &name);
+  void renameFunction(const QString &before, const QString &after);
+  void setStatements(const QString &name,
+		     const qint64 id,
+		     const QList<QMap<QString, QVariant> > &statements);
+
+ private:
+  struct Item
+  {
+    Footprint footprint;
+    QString type;
+    qint64 id;
+  };
+
+  struct Body
+  {
+    Footprint footprint;
+    QString type;
+    QVector<Item> items;
+    qint64 id;
+  };
+
+  QHash<QString, Body> m_bodies;
+  QHash<QString, Footprint> m_types;
+  QHash<QString, int> m_counts;
+  Footprint m_total;
+  static Footprint footprint(const qint64 flash, const qint64 sram);
+  static Footprint library(const QString &type);
+  static Footprint object(const QMap<QString, QVariant> &statement);
+  void add(const Body &body, const int sign);
+};
+
+#endif
@@ -0,0 +1,560 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QSaveFile>
+#include <QTemporaryDir>
+
+#include <iostream>
+
+#include "glitch-code-generator-arduino.h"
+#include "glitch-common.h"
+#include "glitch-diagram.h"
+#include "glitch-native-arduino.h"
+#include "glitch-simulator-arduino.h"
+
+/*
+** The stub of the Arduino core. Analog pins, digital pins, and time
+** behave as they do in the simulator. Serial output is written to
+** the standard output.
+*/
+
+static const char s_core[] =
+  "#include <chrono>\n"
+  "#include <cstdlib>\n"
+  "#include <cstring>\n"
+  "\n"
+  "#include \"Arduino.h\"\n"
+  "\n"
+  "/*\n"
+  "** Virtual time advances as it does in the simulator.\n"
+  "*/\n"
+  "\n"
+  "HardwareSerial Serial;\n"
+  "static bool s_digitalPins[20];\n"
+  "static int s_analogOutputs[20];\n"
+  "static int s_analogPins[6];\n"
+  "static unsigned long long s_micros = 0;\n"
+  "\n"
+  "int analogRead(uint8_t pin)\n"
+  "{\n"
+  "  if(pin >= A0)\n"
+  "    pin = static_cast<uint8_t> (pin - A0);\n"
+  "\n"
+  "  s_micros += 100;\n"
+  "  return pin < 6 ? s_analogPins[pin] : 0;\n"
+  "}\n"
+  "\n"
+  "int digitalRead(uint8_t pin)\n"
+  "{\n"
+  "  return pin < 20 && s_digitalPins[pin] ? HIGH : LOW;\n"
+  "}\n"
+  "\n"
+  "unsigned long micros(void)\n"
+  "{\n"
+  "  return static_cast<unsigned long> (s_micros);\n"
+  "}\n"
+  "\n"
+  "unsigned long millis(void)\n"
+  "{\n"
+  "  return static_cast<unsigned long> (s_micros / 1000);\n"
+  "}\n"
+  "\n"
+  "void analogWrite(uint8_t pin, int value)\n"
+  "{\n"
+  "  if(pin < 20)\n"
+  "    s_analogOutputs[pin] = value;\n"
+  "}\n"
+  "\n"
+  "void delay(unsigned long milliseconds)\n"
+  "{\n"
+  "  s_micros += 1000ULL * milliseconds;\n"
+  "}\n"
+  "\n"
+  "void delayMicroseconds(unsigned int microseconds)\n"
+  "{\n"
+  "  s_micros += microseconds;\n"
+  "}\n"
+  "\n"
+  "void digitalWrite(uint8_t pin, uint8_t value)\n"
+  "{\n"
+  "  if(pin < 20)\n"
+  "    s_digitalPins[pin] = value != LOW;\n"
+  "}\n"
+  "\n"
+  "void pinMode(uint8_t, uint8_t)\n"
+  "{\n"
+  "}\n"
+  "\n"
+  "int main(int argc, char *argv[])\n"
+  "{\n"
+  "  /*\n"
+  "  ** Parameters are a0=n ... a5=n, d0=n ... d19=n, and iterations=n.\n"
+  "  ** A summary is written to the standard error.\n"
+  "  */\n"
+  "\n"
+  "  unsigned long long iterations = 1000000;\n"
+  "\n"
+  "  for(int i = 1; i < argc; i++)\n"
+  "    {\n"
+  "      char *end = nullptr;\n"
+  "      long pin = strtol(argv[i] + 1, &end, 10);\n"
+  "      bool ok = end && *end == '=' && pin >= 0;\n"
+  "\n"
+  "      if(strncmp(argv[i], \"iterations=\", 11) == 0)\n"
+  "        iterations = strtoull(argv[i] + 11, nullptr, 10);\n"
+  "      else if(argv[i][0] == 'a' && ok && pin < 6)\n"
+  "        s_analogPins[pin] = atoi(end + 1);\n"
+  "      else if(argv[i][0] == 'd' && ok && pin < 20)\n"
+  "        s_digitalPins[pin] = atoi(end + 1) != 0;\n"
+  "    }\n"
+  "\n"
+  "  auto start = std::chrono::steady_clock::now();\n"
+  "\n"
+  "  setup();\n"
+  "\n"
+  "  for(unsigned long long i = 0; i < iterations; i++)\n"
+  "    loop();\n"
+  "\n"
+  "  std::cout.flush();\n"
+  "  std::cerr << \"glitch-native \"\n"
+  "            << iterations\n"
+  "            << \" \"\n"
+  "            << s_micros\n"
+  "            << \" \"\n"
+  "            << std::chrono::duration_cast<std::chrono::milliseconds>\n"
+  "               (std::chrono::steady_clock::now() - start).count()\n"
+  "            << std::endl;\n"
+  "  return EXIT_SUCCESS;\n"
+  "}\n";
+
+static const char s_header[] =
+  "#ifndef Arduino_h\n"
+  "#define Arduino_h\n"
+  "\n"
+  "#include <stddef.h>\n"
+  "#include <stdint.h>\n"
+  "\n"
+  "#include <iostream>\n"
+  "#include <sstream>\n"
+  "#include <string>\n"
+  "\n"
+  "#define A0 14\n"
+  "#define A1 15\n"
+  "#define A2 16\n"
+  "#define A3 17\n"
+  "#define A4 18\n"
+  "#define A5 19\n"
+  "#define HIGH 1\n"
+  "#define INPUT 0\n"
+  "#define INPUT_PULLUP 2\n"
+  "#define LOW 0\n"
+  "#define OUTPUT 1\n"
+  "\n"
+  "typedef bool boolean;\n"
+  "typedef uint16_t word;\n"
+  "typedef uint8_t byte;\n"
+  "\n"
+  "class String\n"
+  "{\n"
+  " public:\n"
+  "  String(void) {}\n"
+  "  String(const char *string):m_string(string ? string : \"\") {}\n"
+  "  const char *c_str(void) const {return m_string.c_str();}\n"
+  "  explicit operator bool(void) const {return !m_string.empty();}\n"
+  "\n"
+  " private:\n"
+  "  std::string m_string;\n"
+  "};\n"
+  "\n"
+  "typedef String string;\n"
+  "\n"
+  "class HardwareSerial\n"
+  "{\n"
+  " public:\n"
+  "  explicit operator bool(void) const {return true;}\n"
+  "  int available(void) {return 0;}\n"
+  "  int read(void) {return -1;}\n"
+  "  size_t print(const String &value) {return print(value.c_str());}\n"
+  "  size_t println(void) {return print(\"\\r\\n\");}\n"
+  "  size_t write(uint8_t byte)\n"
+  "  {\n"
+  "    std::cout.put(static_cast<char> (byte));\n"
+  "    return 1;\n"
+  "  }\n"
+  "\n"
+  "  void begin(unsigned long) {}\n"
+  "  void flush(void) {std::cout.flush();}\n"
+  "\n"
+  "  template<typename T> size_t print(const T &value)\n"
+  "  {\n"
+  "    std::ostringstream stream;\n"
+  "\n"
+  "    stream << value;\n"
+  "    std::cout << stream.str();\n"
+  "    return stream.str().size();\n"
+  "  }\n"
+  "\n"
+  "  template<typename T> size_t println(const T &value)\n"
+  "  {\n"
+  "    return print(value) + println();\n"
+  "  }\n"
+  "};\n"
+  "\n"
+  "extern HardwareSerial Serial;\n"
+  "int analogRead(uint8_t pin);\n"
+  "int digitalRead(uint8_t pin);\n"
+  "unsigned long micros(void);\n"
+  "unsigned long millis(void);\n"
+  "void analogWrite(uint8_t pin, int value);\n"
+  "void delay(unsigned long milliseconds);\n"
+  "void delayMicroseconds(unsigned int microseconds);\n"
+  "void digitalWrite(uint8_t pin, uint8_t value);\n"
+  "void loop(void);\n"
+  "void pinMode(uint8_t pin, uint8_t mode);\n"
+  "void setup(void);\n"
+  "\n"
+  "#endif\n";
+
+static bool write_source(const QString &fileName,
+			 const QString &source,
+			 QString &error)
+{
+  QSaveFile file(fileName);
+
+  if(!file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+    {
+      error = file.errorString();
+      return false;
+    }
+
+  QByteArray bytes(source.toUtf8());
+
+  if(file.write(bytes) != static_cast<qint64> (bytes.length()) ||
+     !file.commit())
+    {
+      error = file.errorString();
+      return false;
+    }
+
+  return true;
+}
+
+QString glitch_native_arduino::core(void)
+{
+  return QString::fromUtf8(s_core);
+}
+
+QString glitch_native_arduino::header(void)
+{
+  return QString::fromUtf8(s_header);
+}
+
+QString glitch_native_arduino::sketch
+(const QMap<QString, glitch_optimizer_arduino::Function> &functions)
+{
+  /*
+  ** Prototypes are declared as the Arduino tools declare them.
+  ** Generated functions do not return values. Their values are zero,
+  ** as they are in the simulator.
+  */
+
+  QMap<QString, QString> definitions;
+  QMapIterator<QString, glitch_optimizer_arduino::Function> it(functions);
+  QString loop("");
+  QString prototypes("");
+  QString setup("");
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      auto body(glitch_code_generator_arduino::body(it.value().statements));
+
+      if(it.key() == "loop()")
+	loop = glitch_code_generator_arduino::function("void", "loop()", body);
+      else if(it.key() == "setup()")
+	setup = glitch_code_generator_arduino::function
+	  ("void", "setup()", body);
+      else
+	{
+	  if(it.value().returnType != "void")
+	    body.append("  return {};\n");
+
+	  definitions[it.key()] = glitch_code_generator_arduino::function
+	    (it.value().returnType, it.key(), body);
+	  prototypes.append
+	    (QString("%1 %2;\n").arg(it.value().returnType).arg(it.key()));
+	}
+    }
+
+  return QString("#include \"Arduino.h\"\n\n") +
+    prototypes +
+    "\n" +
+    glitch_code_generator_arduino::sketch(definitions, setup, loop);
+}
+
+bool glitch_native_arduino::build(const QString &directory,
+				  const QString &sketch,
+				  QString &executable,
+				  QString &error)
+{
+  /*
+  ** The compiler is $CXX or c++.
+  */
+
+  QDir dir(directory);
+
+  if(!write_source(dir.filePath("Arduino.cc"), core(), error) ||
+     !write_source(dir.filePath("Arduino.h"), header(), error) ||
+     !write_source(dir.filePath("sketch.cc"), sketch, error))
+    return false;
+
+  QString compiler(QString::fromLocal8Bit(qgetenv("CXX")).trimmed());
+  QProcess process;
+
+  if(compiler.isEmpty())
+    compiler = "c++";
+
+#ifdef Q_OS_WIN
+  executable = dir.filePath("sketch.exe");
+#else
+  executable = dir.filePath("sketch");
+#endif
+  process.setProcessChannelMode(QProcess::MergedChannels);
+  process.setWorkingDirectory(directory);
+  process.start(compiler,
+		QStringList() << "-O2"
+		              << "-std=c++11"
+		              << "-o"
+		              << executable
+		              << "Arduino.cc"
+		              << "sketch.cc");
+
+  if(!process.waitForStarted())
+    {
+      error = QObject::tr("The compiler %1 could not be started.").
+	arg(compiler);
+      return false;
+    }
+
+  process.waitForFinished(-1);
+
+  if(process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+    {
+      error = QObject::tr("The sketch could not be compiled.\n%1").
+	arg(QString::fromLocal8Bit(process.readAll()).trimmed());
+      return false;
+    }
+
+  return true;
+}
+
+int glitch_native_arduino::exec(const QString &fileName,
+				const QStringList &arguments)
+{
+  QMap<QString, qint64> values;
+  QString error("");
+
+  if(!glitch_common::parseArguments
+     (arguments,
+      glitch_simulator_arduino::pinKeys() << "iterations" << "optimize",
+      values,
+      error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  /*
+  ** The pins are also passed to the native sketch.
+  */
+
+  QStringList parameters;
+  auto iterations = static_cast<quint64>
+    (values.value("iterations", 1000000));
+  auto optimize = values.value("optimize", 0) != 0;
+  glitch_simulator_arduino simulator;
+
+  for(int i = 0; i < glitch_simulator_arduino::ANALOG_PINS; i++)
+    {
+      QString key(QString("a%1").arg(i));
+
+      if(values.contains(key))
+	{
+	  auto value = qMin(values.value(key), 1023LL);
+
+	  parameters << QString("%1=%2").arg(key).arg(value);
+	  simulator.setAnalogPin(i, static_cast<int> (value));
+	}
+    }
+
+  for(int i = 0; i < glitch_simulator_arduino::DIGITAL_PINS; i++)
+    {
+      QString key(QString("d%1").arg(i));
+
+      if(values.contains(key))
+	{
+	  auto value = values.value(key) != 0;
+
+	  parameters << QString("%1=%2").arg(key).arg(value ? 1 : 0);
+	  simulator.setDigitalPin(i, value);
+	}
+    }
+
+  parameters << QString("iterations=%1").arg(iterations);
+
+  glitch_diagram diagram;
+
+  if(!diagram.load(fileName, error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  /*
+  ** The interpreter runs first. Sketches which it rejects, such as
+  ** sketches with unbounded recursion, are not compiled.
+  */
+
+  QElapsedTimer timer;
+
+  timer.start();
+
+  if(!simulator.load(diagram) || !simulator.run(iterations))
+    {
+      std::cerr << simulator.error().toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout << fileName.toStdString()
+	    << ": interpreted "
+	    << simulator.iterations()
+	    << " iteration(s) in "
+	    << timer.elapsed()
+	    << " ms. Virtual time: "
+	    << simulator.millis()
+	    << " ms."
+	    << std::endl;
+
+  /*
+  ** The sketch, optimized if requested, is compared against the
+  ** interpreted diagram.
+  */
+
+  QString executable("");
+  QTemporaryDir directory;
+  glitch_optimizer_arduino optimizer;
+
+  optimizer.load(diagram);
+
+  if(optimize)
+    optimizer.optimize();
+
+  if(!directory.isValid())
+    {
+      std::cerr << "A temporary directory could not be created."
+		<< std::endl;
+      return EXIT_FAILURE;
+    }
+
+  timer.restart();
+
+  if(!build(directory.path(),
+	    sketch(optimizer.functions(optimize)),
+	    executable,
+	    error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  auto built = timer.elapsed();
+  QProcess process;
+
+  process.start(executable, parameters);
+
+  if(!process.waitForStarted() ||
+     !process.waitForFinished(-1) ||
+     process.exitStatus() != QProcess::NormalExit ||
+     process.exitCode() != 0)
+    {
+      std::cerr << "The native sketch failed." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  /*
+  ** Serial output is forwarded. The summary contains the iterations,
+  ** the virtual time in microseconds, and the elapsed milliseconds.
+  */
+
+  auto output(process.readAllStandardOutput());
+  auto summary
+    (QString::fromLocal8Bit(process.readAllStandardError()).
+     section("glitch-native ", -1).simplified().split(' '));
+
+  std::cout.write(output.constData(), output.length());
+
+  if(summary.size() != 3)
+    {
+      std::cerr << "The native sketch did not report a summary."
+		<< std::endl;
+      return EXIT_FAILURE;
+    }
+
+  auto micros = summary.at(1).toULongLong();
+
+  std::cout << fileName.toStdString()
+	    << ": native "
+	    << summary.at(0).toStdString()
+	    << " iteration(s) in "
+	    << summary.at(2).toStdString()
+	    << " ms (built in "
+	    << built
+	    << " ms). Virtual time: "
+	    << micros / 1000
+	    << " ms."
+	    << std::endl;
+
+  if(summary.at(0).toULongLong() != simulator.iterations() ||
+     micros != simulator.micros())
+    {
+      std::cerr << "The native and interpreted virtual times differ ("
+		<< micros
+		<< " and "
+		<< simulator.micros()
+		<< " microseconds)."
+		<< std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout << "The native and interpreted runs agree." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -29,6 +29,7 @@
 #include <QUuid>
 #include <QtDebug>
 
+#include "glitch-code-generator-arduino.h"
 #include "glitch-floating-context-menu.h"
 #include "glitch-object-function-arduino.h"
 #include "glitch-misc.h"
@@ -66,12 +67,11 @@ glitch_object_function_arduino::glitch_object_function_arduino
       QUuid::createUuid().toString().remove("{").remove("}").remove("-") +
       "()";
 
-  m_editWindow->setWindowTitle(tr("Glitch: %1").arg(name));
-
   if(m_parentView)
     m_parentView->consumeFunctionName(name);
 
-  m_ui.label->setText(name);
+  m_model.setProperty("name", name);
+  refresh();
 }
 
 glitch_object_function_arduino::glitch_object_function_arduino
@@ -93,19 +93,18 @@ glitch_object_function_arduino::glitch_object_function_arduino
   m_editView = nullptr;
   m_editWindow = nullptr;
   m_initialized = true;
-  m_isFunctionClone = true;
+  m_model.setProperty("clone", true);
+  m_model.setProperty("name", name);
+  m_model.setProperty
+    ("return_type", glitch_structures_arduino::nonArrayTypes().value(0));
   m_parentView = nullptr;
   m_type = "arduino-function";
   m_ui.setupUi(this);
-  m_ui.function_definition->setVisible(false);
   m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
   m_ui.label->setAutoFillBackground(true);
-  m_ui.label->setText(name);
   m_ui.return_type->addItems(glitch_structures_arduino::nonArrayTypes());
-  m_ui.return_type->setEnabled(false);
-  m_ui.return_type->setToolTip
-    (tr("Return type is disabled on function clone."));
   prepareContextMenu();
+  refresh();
 }
 
 glitch_object_function_arduino::glitch_object_function_arduino
@@ -139,18 +138,17 @@ glitch_object_function_arduino::glitch_object_function_arduino
       m_editView = nullptr;
       m_editWindow = nullptr;
       m_initialized = true;
-      m_isFunctionClone = true;
+      m_model.setProperty("clone", true);
+      m_model.setProperty
+	("return_type", glitch_structures_arduino::nonArrayTypes().value(0));
       m_parentView = nullptr;
       m_type = "arduino-function";
       m_ui.setupUi(this);
-      m_ui.function_definition->setVisible(false);
       m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
       m_ui.label->setAutoFillBackground(true);
       m_ui.return_type->addItems(glitch_structures_arduino::nonArrayTypes());
-      m_ui.return_type->setEnabled(false);
-      m_ui.return_type->setToolTip
-	(tr("Return type is disabled on function clone."));
       prepareContextMenu();
+      refresh();
     }
 }
 
@@ -160,14 +158,22 @@ glitch_object_function_arduino::~glitch_object_function_arduino()
     m_editWindow->deleteLater();
 }
 
-QString glitch_object_function_arduino::name(void) const
+QString glitch_object_function_arduino::code(void) const
 {
-  return m_ui.label->text();
+  if(isClone())
+    return "";
+
+  return glitch_code_generator_arduino::function
+    (returnType(),
+     name().trimmed(),
+     m_editView ?
+     m_editView->code() :
+     glitch_code_generator_arduino::body(m_pendingChildren, m_pendingWires));
 }
 
 QString glitch_object_function_arduino::returnType(void) const
 {
-  return m_ui.return_type->currentText();
+  return m_model.property("return_type").toString();
 }
 
 bool glitch_object_function_arduino::hasView(void) const
@@ -177,7 +183,7 @@ bool glitch_object_function_arduino::hasView(void) const
 
 bool glitch_object_function_arduino::isClone(void) const
 {
-  return m_isFunctionClone;
+  return m_model.property("clone").toBool();
 }
 
 bool glitch_object_function_arduino::isMandatory(void) const
@@ -188,9 +194,9 @@ bool glitch_object_function_arduino::isMandatory(void) const
 glitch_object_function_arduino *glitch_object_function_arduino::
 clone(QWidget *parent) const
 {
-  auto *clone = new glitch_object_function_arduino(m_ui.label->text(), parent);
+  auto *clone = new glitch_object_function_arduino(name(), parent);
 
-  clone->setReturnType(m_ui.return_type->currentText());
+  clone->setReturnType(returnType());
   clone->setStyleSheet(styleSheet());
   return clone;
 }
@@ -256,40 +262,17 @@ glitch_object_view *glitch_object_function_arduino::editView(void) const
 
 void glitch_object_function_arduino::addActions(QMenu &menu)
 {
-  if(!m_actions.contains(DefaultMenuActions::EDIT))
-    {
-      auto *action = new QAction(tr("&Edit..."), this);
+  addSharedAction(menu, DefaultMenuActions::EDIT, SLOT(slotEdit(void)));
 
-      connect(action,
-	      SIGNAL(triggered(void)),
-	      this,
-	      SLOT(slotEdit(void)));
-      m_actions[DefaultMenuActions::EDIT] = action;
-      menu.addAction(action);
-    }
-  else
-    menu.addAction(m_actions.value(DefaultMenuActions::EDIT));
-
-  if(m_isFunctionClone)
+  if(isClone())
     {
       addDefaultActions(menu);
       return;
     }
 
-  if(!m_actions.contains(DefaultMenuActions::SET_FUNCTION_NAME))
-    {
-      auto *action = new QAction(tr("Set Function &Name..."), this);
-
-      connect(action,
-	      SIGNAL(triggered(void)),
-	      this,
-	      SLOT(slotSetFunctionName(void)));
-      m_actions[DefaultMenuActions::SET_FUNCTION_NAME] = action;
-      menu.addAction(action);
-    }
-  else
-    menu.addAction(m_actions.value(DefaultMenuActions::SET_FUNCTION_NAME));
-
+  addSharedAction(menu,
+		  DefaultMenuActions::SET_FUNCTION_NAME,
+		  SLOT(slotSetFunctionName(void)));
   addDefaultActions(menu);
 }
 
@@ -299,8 +282,12 @@ void glitch_object_function_arduino::addChild
   if(!object)
     return;
 
+  createEditWindow();
+
   if(m_editView)
     m_editView->artificialDrop(point, object);
+  else
+    object->deleteLater();
 }
 
 void glitch_object_function_arduino::declone(void)
@@ -314,23 +301,21 @@ void glitch_object_function_arduino::declone(void)
 	     this,
 	     SLOT(slotFindParentFunctionTimeout(void)));
 
+  /*
+  ** The edit window is created on demand. Please see createEditWindow().
+  */
+
   if(m_editView)
     m_editView->deleteLater();
 
   if(m_editWindow)
     m_editWindow->deleteLater();
 
-  m_editView = new glitch_object_view
-    (glitch_common::ArduinoProject, m_id, this);
-  m_editWindow = new glitch_object_edit_window(m_parent);
-  m_editWindow->setCentralWidget(m_editView);
-  m_editWindow->setEditView(m_editView);
-  m_editWindow->setUndoStack(m_editView->undoStack());
-  m_editWindow->setWindowIcon(QIcon(":Logo/glitch-logo.png"));
-  m_editWindow->resize(600, 600);
+  m_editView = nullptr;
+  m_editWindow = nullptr;
   m_findParentFunctionTimer.stop();
   m_initialized = true;
-  m_isFunctionClone = false;
+  m_model.setProperty("clone", false);
 
   if(m_parent)
     {
@@ -342,21 +327,15 @@ void glitch_object_function_arduino::declone(void)
   else
     m_parentView = nullptr;
 
-  m_ui.function_definition->setVisible(true);
   m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
   m_ui.label->setAutoFillBackground(true);
-  m_ui.return_type->setEnabled(true);
-  m_ui.return_type->setToolTip("");
-  connect(m_editView,
-	  SIGNAL(changed(void)),
-	  this,
-	  SIGNAL(changed(void)));
   connect(m_ui.return_type,
 	  SIGNAL(currentIndexChanged(int)),
 	  this,
-	  SLOT(slotReturnTypeChanged(void)));
+	  SLOT(slotReturnTypeChanged(void)),
+	  Qt::UniqueConnection);
   prepareContextMenu();
-  prepareEditSignals();
+  refresh();
 }
 
 void glitch_object_function_arduino::closeEditWindow(void)
@@ -365,38 +344,67 @@ void glitch_object_function_arduino::closeEditWindow(void)
     m_editWindow->close();
 }
 
-void glitch_object_function_arduino::initialize(QWidget *parent)
+void glitch_object_function_arduino::createEditWindow(void)
 {
-  if(m_initialized)
+  if(m_editWindow || isClone())
     return;
-  else
-    m_initialized = true;
+
+  /*
+  ** The edit view, its scene, and its window are created when the
+  ** function is first edited or when a child is first inserted.
+  ** Until then, children are held in the model.
+  */
 
   m_editView = new glitch_object_view
     (glitch_common::ArduinoProject, m_id, this);
-  m_editWindow = new glitch_object_edit_window(parent);
+
+  if(m_undoStack)
+    m_editView->scene()->setUndoStack(m_undoStack);
+
+  m_editWindow = new glitch_object_edit_window(m_parent);
   m_editWindow->setCentralWidget(m_editView);
   m_editWindow->setEditView(m_editView);
   m_editWindow->setUndoStack(m_editView->undoStack());
   m_editWindow->setWindowIcon(QIcon(":Logo/glitch-logo.png"));
+  m_editWindow->setWindowTitle(tr("Glitch: %1").arg(name()));
   m_editWindow->resize(600, 600);
-  m_isFunctionClone = false;
+
+  /*
+  ** Creating the children does not alter the diagram.
+  */
+
+  createPendingChildren();
+  connect(m_editView,
+	  SIGNAL(changed(void)),
+	  this,
+	  SIGNAL(changed(void)));
+  prepareEditSignals();
+}
+
+void glitch_object_function_arduino::initialize(QWidget *parent)
+{
+  Q_UNUSED(parent);
+
+  if(m_initialized)
+    return;
+  else
+    m_initialized = true;
+
+  m_model.setProperty("clone", false);
+  m_model.setProperty
+    ("return_type", glitch_structures_arduino::nonArrayTypes().value(0));
   m_type = "arduino-function";
   m_ui.setupUi(this);
   m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
   m_ui.label->setAutoFillBackground(true);
   m_ui.return_type->addItems(glitch_structures_arduino::nonArrayTypes());
-  connect(m_editView,
-	  SIGNAL(changed(void)),
-	  this,
-	  SIGNAL(changed(void)));
   connect(m_ui.return_type,
 	  SIGNAL(currentIndexChanged(int)),
 	  this,
-	  SLOT(slotReturnTypeChanged(void)));
-  m_previousReturnType = m_ui.return_type->currentText();
+	  SLOT(slotReturnTypeChanged(void)),
+	  Qt::UniqueConnection);
   prepareContextMenu();
-  prepareEditSignals();
+  refresh();
 }
 
 void glitch_object_function_arduino::mouseDoubleClickEvent(QMouseEvent *event)
@@ -459,20 +467,34 @@ void glitch_object_function_arduino::prepareEditSignals(void)
 	    Qt::UniqueConnection);
 }
 
-void glitch_object_function_arduino::save
-(const QSqlDatabase &db, QString &error)
+void glitch_object_function_arduino::refresh(void)
 {
-  glitch_object::save(db, error);
+  /*
+  ** The widgets are views of the model.
+  */
 
-  if(!error.isEmpty())
-    return;
+  m_ui.function_definition->setVisible(!isClone());
+  m_ui.label->setText(name());
+  m_ui.return_type->blockSignals(true);
+  m_ui.return_type->setCurrentIndex
+    (qMax(0, m_ui.return_type->findText(returnType())));
+  m_ui.return_type->blockSignals(false);
+  m_ui.return_type->setEnabled(!isClone());
 
-  QMap<QString, QVariant> properties;
+  if(isClone())
+    m_ui.return_type->setToolTip
+      (tr("Return type is disabled on function clone."));
+  else
+    m_ui.return_type->setToolTip("");
 
-  properties["clone"] = m_isFunctionClone;
-  properties["name"] = m_ui.label->text().trimmed();
-  properties["return_type"] = m_ui.return_type->currentText();
-  glitch_object::saveProperties(properties, db, error);
+  if(m_editWindow)
+    m_editWindow->setWindowTitle(tr("Glitch: %1").arg(name()));
+}
+
+void glitch_object_function_arduino::save
+(const QSqlDatabase &db, QString &error)
+{
+  glitch_object::save(db, error);
 
   if(error.isEmpty() && m_editView)
     m_editView->save(db, error);
@@ -482,19 +504,25 @@ void glitch_object_function_arduino::setName(const QString &name)
 {
   if(m_parentView)
     {
+      m_parentView->removeFunctionName(this->name());
       m_parentView->consumeFunctionName(name);
-      m_parentView->removeFunctionName(m_name);
+
+      if(!isClone())
+	m_parentView->renameFunction(this->name(), name.trimmed());
     }
 
   glitch_object::setName(name);
+  refresh();
 
-  if(m_editWindow)
-    m_editWindow->setWindowTitle(tr("Glitch: %1").arg(m_name));
-
-  m_ui.label->setText(m_name);
-
-  if(!m_isFunctionClone)
+  if(!isClone())
     emit changed();
+  else if(qobject_cast<glitch_object_view *> (m_parent))
+    /*
+    ** Clones do not alter their diagrams. The clone's view must
+    ** regenerate its source, however.
+    */
+
+    qobject_cast<glitch_object_view *> (m_parent)->slotInvalidateCode();
 }
 
 void glitch_object_function_arduino::setProperties(const QString &properties)
@@ -511,7 +539,9 @@ void glitch_object_function_arduino::setProperties(const QString &properties)
 
 	str.remove("\"");
 
-	if((m_isFunctionClone = QVariant(str).toBool()))
+	m_model.setProperty("clone", QVariant(str).toBool());
+
+	if(isClone())
 	  {
 	    connect(&m_findParentFunctionTimer,
 		    SIGNAL(timeout(void)),
@@ -520,15 +550,6 @@ void glitch_object_function_arduino::setProperties(const QString &properties)
 		    Qt::UniqueConnection);
 	    m_findParentFunctionTimer.start(100);
 	  }
-
-	m_ui.function_definition->setVisible(!m_isFunctionClone);
-	m_ui.return_type->setEnabled(!m_isFunctionClone);
-
-	if(!m_ui.return_type->isEnabled())
-	  m_ui.return_type->setToolTip
-	    (tr("Return type is disabled on function clone."));
-	else
-	  m_ui.return_type->setToolTip("");
       }
     else if(list.at(i).startsWith("name = "))
       {
@@ -536,55 +557,57 @@ void glitch_object_function_arduino::setProperties(const QString &properties)
 
 	str.remove("\"");
 
-	if(!m_isFunctionClone &&
+	if(!isClone() &&
 	   m_parentView &&
 	   m_parentView->containsFunctionName(str))
 	  str = m_parentView->nextUniqueFunctionName();
 
-	if(m_editWindow)
-	  m_editWindow->setWindowTitle(tr("Glitch: %1").arg(str));
-
-	if(!m_isFunctionClone && m_parentView)
+	if(!isClone() && m_parentView)
 	  m_parentView->consumeFunctionName(str);
 
-	m_ui.label->setText(str);
+	m_model.setProperty("name", str);
       }
     else if(list.at(i).startsWith("return_type = "))
       {
-	if(!m_isFunctionClone)
+	if(!isClone())
 	  {
 	    QString str(list.at(i).mid(14));
 
 	    str.remove("\"");
 	    setReturnType(str);
-	    m_previousReturnType = m_ui.return_type->currentText();
 	  }
 	else
 	  slotParentFunctionChanged();
       }
+
+  refresh();
 }
 
 void glitch_object_function_arduino::setReturnType(const QString &returnType)
 {
-  int index = m_ui.return_type->findText(returnType);
-
-  m_ui.return_type->blockSignals(true);
-
-  if(index >= 0)
-    m_ui.return_type->setCurrentIndex(index);
+  if(glitch_structures_arduino::nonArrayTypes().contains(returnType))
+    m_model.setProperty("return_type", returnType);
   else
-    m_ui.return_type->setCurrentIndex(0);
+    m_model.setProperty
+      ("return_type", glitch_structures_arduino::nonArrayTypes().value(0));
 
-  m_ui.return_type->blockSignals(false);
+  refresh();
 
-  if(!m_isFunctionClone)
+  if(!isClone())
     emit changed();
+  else if(qobject_cast<glitch_object_view *> (m_parent))
+    qobject_cast<glitch_object_view *> (m_parent)->slotInvalidateCode();
 }
 
 void glitch_object_function_arduino::slotEdit(void)
 {
-  if(m_editWindow && !m_isFunctionClone)
+  if(!isClone())
     {
+      createEditWindow();
+
+      if(!m_editWindow)
+	return;
+
       m_editWindow->showNormal();
       m_editWindow->activateWindow();
       m_editWindow->raise();
@@ -597,7 +620,7 @@ void glitch_object_function_arduino::slotEdit(void)
 
 void glitch_object_function_arduino::slotFindParentFunctionTimeout(void)
 {
-  if(!m_isFunctionClone || m_parentFunction)
+  if(!isClone() || m_parentFunction)
     {
       m_findParentFunctionTimer.stop();
       return;
@@ -628,25 +651,31 @@ void glitch_object_function_arduino::slotParentFunctionChanged(void)
 
 void glitch_object_function_arduino::slotReturnTypeChanged(void)
 {
-  if(m_isFunctionClone)
+  if(isClone())
     return;
 
+  /*
+  ** The model holds the previous return type until the combination
+  ** box's selection is committed.
+  */
+
+  QString before(returnType());
+
+  m_model.setProperty("return_type", m_ui.return_type->currentText());
   emit changed();
-  emit returnTypeChanged
-    (m_ui.return_type->currentText(), m_previousReturnType, this);
-  m_previousReturnType = m_ui.return_type->currentText();
+  emit returnTypeChanged(returnType(), before, this);
 }
 
 void glitch_object_function_arduino::slotSetFunctionName(void)
 {
-  if(!m_editWindow || m_isFunctionClone)
+  if(isClone())
     return;
 
   QInputDialog dialog(m_parent);
 
   dialog.setLabelText(tr("Set Function Name"));
   dialog.setTextEchoMode(QLineEdit::Normal); // A line edit!
-  dialog.setTextValue(m_ui.label->text());
+  dialog.setTextValue(name());
   dialog.setWindowIcon(QIcon(":Logo/glitch-logo.png"));
   dialog.setWindowTitle(tr("Glitch: Set Function Name"));
 
@@ -681,7 +710,7 @@ void glitch_object_function_arduino::slotSetFunctionName(void)
       else
 	text.append("()");
 
-      if(m_ui.label->text() == text)
+      if(name() == text)
 	return;
 
       if(m_parentView && m_parentView->containsFunctionName(text))
@@ -692,17 +721,17 @@ void glitch_object_function_arduino::slotSetFunctionName(void)
 	  goto restart_label;
 	}
 
-      QString name(m_ui.label->text());
-
-      if(m_parentView)
-	m_parentView->removeFunctionName(m_ui.label->text());
-
-      m_editWindow->setWindowTitle(tr("Glitch: %1").arg(text));
+      QString name(this->name());
 
       if(m_parentView)
-	m_parentView->consumeFunctionName(text);
+	{
+	  m_parentView->removeFunctionName(name);
+	  m_parentView->consumeFunctionName(text);
+	  m_parentView->renameFunction(name, text);
+	}
 
-      m_ui.label->setText(text);
+      m_model.setProperty("name", text);
+      refresh();
       emit changed();
       emit nameChanged(text, name, this);
     }
@@ -48,7 +48,7 @@ class glitch_object_function_arduino: public glitch_object
 				 const quint64 id,
 				 QWidget *parent);
   ~glitch_object_function_arduino();
-  QString name(void) const;
+  QString code(void) const;
   QString returnType(void) const;
   bool hasView(void) const;
   bool isClone(void) const;
@@ -69,14 +69,14 @@ class glitch_object_function_arduino: public glitch_object
   QPointer<glitch_object_edit_window> m_editWindow;
   QPointer<glitch_object_function_arduino> m_parentFunction;
   QPointer<glitch_view_arduino> m_parentView;
-  QString m_previousReturnType;
   QTimer m_findParentFunctionTimer;
   Ui_glitch_object_function_arduino m_ui;
-  bool m_isFunctionClone;
   glitch_object_function_arduino *findParentFunction(void) const;
+  void createEditWindow(void);
   void initialize(QWidget *parent);
   void mouseDoubleClickEvent(QMouseEvent *event);
   void prepareEditSignals(void);
+  void refresh(void);
   void setProperties(const QString &properties);
 
  private slots:
@@ -40,6 +40,7 @@ glitch_object_logical_operator_arduino::glitch_object_logical_operator_arduino
 glitch_object_logical_operator_arduino::glitch_object_logical_operator_arduino
 (const quint64 id, QWidget *parent):glitch_object(id, parent)
 {
+  m_operator = AND_OPERATOR;
   m_ui.setupUi(this);
   m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
   m_ui.label->setAutoFillBackground(true);
@@ -51,6 +52,33 @@ glitch_object_logical_operator_arduino::
 {
 }
 
+QMap<QString, QVariant> glitch_object_logical_operator_arduino::
+values(void) const
+{
+  auto values(glitch_object::values());
+
+  switch(m_operator)
+    {
+    case NOT_OPERATOR:
+      {
+	values["operator"] = "not";
+	break;
+      }
+    case OR_OPERATOR:
+      {
+	values["operator"] = "or";
+	break;
+      }
+    default:
+      {
+	values["operator"] = "and";
+	break;
+      }
+    }
+
+  return values;
+}
+
 glitch_object_logical_operator_arduino *glitch_object_logical_operator_arduino::
 clone(QWidget *parent) const
 {
@@ -46,6 +46,7 @@ class glitch_object_logical_operator_arduino: public glitch_object
   glitch_object_logical_operator_arduino(QWidget *parent);
   glitch_object_logical_operator_arduino(const quint64 id, QWidget *parent);
   ~glitch_object_logical_operator_arduino();
+  QMap<QString, QVariant> values(void) const;
   static glitch_object_logical_operator_arduino *createFromValues
     (const QMap<QString, QVariant> &values, QString &error, QWidget *parent);
   bool hasView(void) const;
@@ -25,6 +25,7 @@
 ** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include "glitch-code-generator-arduino.h"
 #include "glitch-object-edit-window.h"
 #include "glitch-object-loop-arduino.h"
 #include "glitch-object-view.h"
@@ -47,6 +48,16 @@ glitch_object_loop_arduino::~glitch_object_loop_arduino()
     m_editWindow->deleteLater();
 }
 
+QString glitch_object_loop_arduino::code(void) const
+{
+  return glitch_code_generator_arduino::function
+    ("void",
+     "loop()",
+     m_editView ?
+     m_editView->code() :
+     glitch_code_generator_arduino::body(m_pendingChildren, m_pendingWires));
+}
+
 bool glitch_object_loop_arduino::hasView(void) const
 {
   return true;
@@ -65,46 +76,48 @@ clone(QWidget *parent) const
 
 void glitch_object_loop_arduino::addActions(QMenu &menu)
 {
-  if(!m_actions.contains(DefaultMenuActions::EDIT))
-    {
-      auto *action = new QAction(tr("&Edit..."), this);
-
-      connect(action,
-	      SIGNAL(triggered(void)),
-	      this,
-	      SLOT(slotEdit(void)));
-      m_actions[DefaultMenuActions::EDIT] = action;
-      menu.addAction(action);
-    }
-  else
-    menu.addAction(m_actions.value(DefaultMenuActions::EDIT));
+  addSharedAction(menu, DefaultMenuActions::EDIT, SLOT(slotEdit(void)));
 
   addDefaultActions(menu);
 }
 
-void glitch_object_loop_arduino::initialize(QWidget *parent)
+void glitch_object_loop_arduino::createEditWindow(void)
 {
-  if(m_initialized)
+  if(m_editWindow)
     return;
-  else
-    m_initialized = true;
 
   m_editView = new glitch_object_view
     (glitch_common::ArduinoProject, m_id, this);
-  m_editWindow = new glitch_object_edit_window(parent);
+
+  if(m_undoStack)
+    m_editView->scene()->setUndoStack(m_undoStack);
+
+  m_editWindow = new glitch_object_edit_window(m_parent);
   m_editWindow->setCentralWidget(m_editView);
   m_editWindow->setWindowIcon(QIcon(":Logo/glitch-logo.png"));
   m_editWindow->setWindowTitle(tr("Glitch: loop()"));
   m_editWindow->resize(600, 600);
-  m_properties[POSITION_LOCKED] = true;
-  m_ui.setupUi(this);
-  m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
-  m_ui.label->setAutoFillBackground(true);
-  m_type = "arduino-loop";
+  createPendingChildren();
   connect(m_editView,
 	  SIGNAL(changed(void)),
 	  this,
 	  SIGNAL(changed(void)));
+}
+
+void glitch_object_loop_arduino::initialize(QWidget *parent)
+{
+  Q_UNUSED(parent);
+
+  if(m_initialized)
+    return;
+  else
+    m_initialized = true;
+
+  m_model.setProperty("position_locked", true);
+  m_ui.setupUi(this);
+  m_ui.label->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+  m_ui.label->setAutoFillBackground(true);
+  m_type = "arduino-loop";
   prepareContextMenu();
 }
 
@@ -127,6 +140,7 @@ void glitch_object_loop_arduino::save(const QSqlDatabase &db, QString &error)
 
 void glitch_object_loop_arduino::slotEdit(void)
 {
+  createEditWindow();
   m_editWindow->showNormal();
   m_editWindow->raise();
 }
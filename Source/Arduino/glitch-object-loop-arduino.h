@@ -43,6 +43,7 @@ class glitch_object_loop_arduino: public glitch_object
   glitch_object_loop_arduino(QWidget *parent);
   glitch_object_loop_arduino(const quint64 id, QWidget *parent);
   ~glitch_object_loop_arduino();
+  QString code(void) const;
   bool hasView(void) const;
   bool isMandatory(void) const;
   glitch_object_loop_arduino *clone(QWidget *parent) const;
@@ -52,6 +53,7 @@ class glitch_object_loop_arduino: public glitch_object
  private:
   QPointer<glitch_object_edit_window> m_editWindow;
   Ui_glitch_object_loop_arduino m_ui;
+  void createEditWindow(void);
   void initialize(QWidget *parent);
   void mouseDoubleClickEvent(QMouseEvent *event);
 
@@ -0,0 +1,568 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QObject>
+
+#include "glitch-code-generator-arduino.h"
+#include "glitch-diagram.h"
+#include "glitch-optimizer-arduino.h"
+
+static const QString s_barrier = "barrier";
+static const int s_inlineStatements = 4;
+
+static QString cycles(const glitch_cost_model_arduino::Estimate &estimate,
+		      const bool worst)
+{
+  if(!estimate.bounded)
+    return QObject::tr("unbounded");
+  else if(worst)
+    return QString::number(estimate.worst);
+  else
+    return QString::number(estimate.typical, 'f', 1);
+}
+
+glitch_optimizer_arduino::glitch_optimizer_arduino(void)
+{
+  clear();
+}
+
+glitch_optimizer_arduino::~glitch_optimizer_arduino()
+{
+}
+
+QHash<QString, int> glitch_optimizer_arduino::calls
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  QHash<QString, int> calls;
+
+  for(const auto &statement : statements)
+    if(statement.value("type").toString() == "arduino-function")
+      {
+	QString name(statement.value("name").toString().trimmed());
+
+	if(!name.isEmpty())
+	  calls[name] += 1;
+      }
+
+  return calls;
+}
+
+QList<QMap<QString, QVariant> > glitch_optimizer_arduino::expand
+(const QList<QMap<QString, QVariant> > &statements,
+ const QSet<QString> &inlined) const
+{
+  /*
+  ** The bodies of inlined functions replace their calls, including
+  ** the calls within the bodies. The barriers isolate the values of
+  ** a body from the values of its caller.
+  */
+
+  QList<QMap<QString, QVariant> > expanded;
+  QMap<QString, QVariant> barrier;
+  QVector<QMap<QString, QVariant> > stack;
+
+  barrier["type"] = s_barrier;
+
+  for(int i = statements.size() - 1; i >= 0; i--)
+    stack << statements.at(i);
+
+  while(!stack.isEmpty())
+    {
+      auto statement(stack.takeLast());
+      QString name(statement.value("name").toString().trimmed());
+
+      if(statement.value("type").toString() == "arduino-function" &&
+	 inlined.contains(name))
+	{
+	  auto body(m_optimized.value(name).statements);
+
+	  stack << barrier;
+
+	  for(int i = body.size() - 1; i >= 0; i--)
+	    stack << body.at(i);
+
+	  stack << barrier;
+	}
+      else
+	expanded << statement;
+    }
+
+  return expanded;
+}
+
+QList<QMap<QString, QVariant> > glitch_optimizer_arduino::expression
+(const Value &value)
+{
+  if(value.constant)
+    {
+      QMap<QString, QVariant> statement;
+
+      statement["type"] = "arduino-constant";
+      statement["value"] = value.value;
+      return QList<QMap<QString, QVariant> > () << statement;
+    }
+  else
+    return value.code;
+}
+
+QList<QMap<QString, QVariant> > glitch_optimizer_arduino::fold
+(const QList<QMap<QString, QVariant> > &statements, int &folded)
+{
+  /*
+  ** Values are consumed by logical operators or discarded. Their
+  ** truth is therefore sufficient. Missing operands are replaced with
+  ** identity values, as in the code generator. Operators of the
+  ** result always have their operands.
+  */
+
+  QList<QMap<QString, QVariant> > code;
+  QVector<Value> values;
+
+  for(const auto &statement : statements)
+    {
+      QString type(statement.value("type").toString());
+
+      if(type == "arduino-analogread")
+	values << opaque(statement);
+      else if(type == "arduino-constant")
+	values << constant(statement.value("value").toBool());
+      else if(type == "arduino-function")
+	{
+	  if(statement.value("name").toString().trimmed().isEmpty())
+	    continue;
+
+	  if(statement.value("return_type").toString() == "void")
+	    {
+	      flush(code, values);
+	      code << statement;
+	    }
+	  else
+	    values << opaque(statement);
+	}
+      else if(type == "arduino-logicaloperator")
+	{
+	  QString o(statement.value("operator").toString());
+
+	  if(o == "not")
+	    {
+	      auto value
+		(values.isEmpty() ? constant(false) : values.takeLast());
+
+	      if(value.constant)
+		{
+		  folded += 1;
+		  value.value = !value.value;
+		}
+	      else if(value.negated)
+		{
+		  /*
+		  ** !(!(x)) and x are equally true.
+		  */
+
+		  folded += 1;
+		  value.code.removeLast();
+		  value.negated = false;
+		}
+	      else
+		{
+		  value.code << statement;
+		  value.negated = true;
+		}
+
+	      values << value;
+	    }
+	  else
+	    {
+	      auto isOr = o == "or";
+	      auto value2
+		(values.isEmpty() ? constant(!isOr) : values.takeLast());
+	      auto value1
+		(values.isEmpty() ? constant(!isOr) : values.takeLast());
+
+	      if(value1.constant)
+		{
+		  /*
+		  ** The right operand is not evaluated if the left
+		  ** operand decides the result.
+		  */
+
+		  folded += 1;
+		  values << (value1.value == isOr ? value1 : value2);
+		}
+	      else if(value2.constant && value2.value != isOr)
+		{
+		  folded += 1;
+		  values << value1;
+		}
+	      else
+		{
+		  Value value;
+
+		  value.code << expression(value1)
+			     << expression(value2)
+			     << statement;
+		  value.constant = false;
+		  value.negated = false;
+		  value.value = false;
+		  values << value;
+		}
+	    }
+	}
+      else if(type == s_barrier)
+	flush(code, values);
+      else
+	{
+	  /*
+	  ** Pending values precede the statement.
+	  */
+
+	  flush(code, values);
+	  code << statement;
+	}
+    }
+
+  flush(code, values);
+  return code;
+}
+
+QMap<QString, glitch_optimizer_arduino::Function>
+glitch_optimizer_arduino::functions(const bool optimized) const
+{
+  /*
+  ** The loaded functions or the functions of the latest optimization,
+  ** including loop() and setup().
+  */
+
+  return optimized ? m_optimized : m_functions;
+}
+
+QString glitch_optimizer_arduino::sketch(void) const
+{
+  /*
+  ** The optimized functions. The order of the call graph reflects
+  ** the eliminated and inlined functions.
+  */
+
+  QMap<QString, QString> functions;
+  QString loop("");
+  QString setup("");
+
+  QMapIterator<QString, Function> it(m_optimized);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      auto body(glitch_code_generator_arduino::body(it.value().statements));
+
+      if(it.key() == "loop()")
+	loop = body;
+      else if(it.key() == "setup()")
+	setup = body;
+      else
+	functions[it.key()] = glitch_code_generator_arduino::function
+	  (it.value().returnType, it.key(), body);
+    }
+
+  return glitch_code_generator_arduino::sketch
+    (functions,
+     m_callGraph.order(),
+     glitch_code_generator_arduino::function("void", "setup()", setup),
+     glitch_code_generator_arduino::function("void", "loop()", loop));
+}
+
+QString glitch_optimizer_arduino::summary(void) const
+{
+  return QObject::tr
+    ("loop(): %1 -> %2 cycles (worst case %3 -> %4). "
+     "setup(): %5 -> %6 cycles. "
+     "Folded %7 operator(s), eliminated %8 function(s), "
+     "inlined %9 function(s).").
+    arg(cycles(m_report.loopBefore, false)).
+    arg(cycles(m_report.loopAfter, false)).
+    arg(cycles(m_report.loopBefore, true)).
+    arg(cycles(m_report.loopAfter, true)).
+    arg(cycles(m_report.setupBefore, true)).
+    arg(cycles(m_report.setupAfter, true)).
+    arg(m_report.folded).
+    arg(m_report.eliminated).
+    arg(m_report.inlined);
+}
+
+glitch_cost_model_arduino glitch_optimizer_arduino::costModel
+(const QMap<QString, Function> &functions)
+{
+  QMapIterator<QString, Function> it(functions);
+  glitch_cost_model_arduino costModel;
+
+  while(it.hasNext())
+    {
+      it.next();
+      costModel.setStatements(it.key(), it.value().statements);
+    }
+
+  return costModel;
+}
+
+glitch_optimizer_arduino::Report glitch_optimizer_arduino::report(void) const
+{
+  return m_report;
+}
+
+glitch_optimizer_arduino::Value glitch_optimizer_arduino::constant
+(const bool value)
+{
+  Value v;
+
+  v.constant = true;
+  v.negated = false;
+  v.value = value;
+  return v;
+}
+
+glitch_optimizer_arduino::Value glitch_optimizer_arduino::opaque
+(const QMap<QString, QVariant> &statement)
+{
+  Value value;
+
+  value.code << statement;
+  value.constant = false;
+  value.negated = false;
+  value.value = false;
+  return value;
+}
+
+void glitch_optimizer_arduino::addFunction
+(const QString &name,
+ const QString &returnType,
+ const QList<QMap<QString, QVariant> > &statements)
+{
+  if(name.trimmed().isEmpty())
+    return;
+
+  Function function;
+
+  function.returnType = returnType;
+  function.statements = statements;
+  m_functions[name.trimmed()] = function;
+}
+
+void glitch_optimizer_arduino::clear(void)
+{
+  m_callGraph.clear();
+  m_functions.clear();
+  m_optimized.clear();
+  m_report.eliminated = 0;
+  m_report.folded = 0;
+  m_report.inlined = 0;
+  m_report.loopAfter = m_report.loopBefore =
+    m_report.setupAfter = m_report.setupBefore =
+    glitch_cost_model_arduino().period();
+  setLoop(QList<QMap<QString, QVariant> > ());
+  setSetup(QList<QMap<QString, QVariant> > ());
+}
+
+void glitch_optimizer_arduino::flush(QList<QMap<QString, QVariant> > &code,
+				     QVector<Value> &values)
+{
+  /*
+  ** Remaining values are emitted as statements. Constants do not
+  ** have effects.
+  */
+
+  for(const auto &value : values)
+    if(!value.constant)
+      code << value.code;
+
+  values.clear();
+}
+
+void glitch_optimizer_arduino::load(const glitch_diagram &diagram)
+{
+  clear();
+
+  for(const auto &object : diagram.topLevelObjects())
+    {
+      auto statements
+	(glitch_code_generator_arduino::
+	 statements(diagram.children(object.id()),
+		    diagram.wireGraph(object.id())));
+
+      if(object.type() == "arduino-function")
+	{
+	  if(!object.property("clone").toBool())
+	    addFunction(object.property("name").toString().trimmed(),
+			object.property("return_type").toString(),
+			statements);
+	}
+      else if(object.type() == "arduino-loop")
+	setLoop(statements);
+      else if(object.type() == "arduino-setup")
+	setSetup(statements);
+    }
+}
+
+void glitch_optimizer_arduino::optimize(void)
+{
+  /*
+  ** Functions which are not reachable from loop() or setup() are
+  ** eliminated. Bodies are folded. Small void functions having
+  ** a single call are inlined, callees first, and the bodies are
+  ** folded again.
+  */
+
+  m_callGraph.clear();
+  m_callGraph.addRoot("loop()");
+  m_callGraph.addRoot("setup()");
+  m_optimized = m_functions;
+  m_report.eliminated = 0;
+  m_report.folded = 0;
+  m_report.inlined = 0;
+
+  for(const auto &name : m_optimized.keys())
+    if(name != "loop()" && name != "setup()")
+      m_callGraph.addFunction(name);
+
+  for(const auto &name : m_optimized.keys())
+    m_callGraph.setCalls(name, calls(m_optimized.value(name).statements));
+
+  for(const auto &name : m_callGraph.deadFunctions())
+    if(m_optimized.remove(name) > 0)
+      {
+	m_callGraph.removeFunction(name);
+	m_callGraph.setCalls(name, QHash<QString, int> ());
+	m_report.eliminated += 1;
+      }
+
+  for(auto &function : m_optimized)
+    function.statements = fold(function.statements, m_report.folded);
+
+  QHash<QString, int> sites;
+  QHash<QString, int> sizes;
+  QSet<QString> inlined;
+
+  for(const auto &function : m_optimized)
+    for(const auto &statement : function.statements)
+      if(statement.value("type").toString() == "arduino-function")
+	sites[statement.value("name").toString().trimmed()] += 1;
+
+  for(const auto &name : m_callGraph.order())
+    {
+      if(!m_optimized.contains(name))
+	continue;
+
+      /*
+      ** The size includes the bodies of inlined callees.
+      */
+
+      auto size = 0;
+
+      for(const auto &statement : m_optimized.value(name).statements)
+	{
+	  QString callee(statement.value("name").toString().trimmed());
+
+	  if(statement.value("type").toString() == "arduino-function" &&
+	     inlined.contains(callee))
+	    size += sizes.value(callee);
+	  else
+	    size += 1;
+	}
+
+      sizes[name] = size;
+
+      if(m_optimized.value(name).returnType != "void" ||
+	 m_callGraph.isRecursive(name) ||
+	 name == "loop()" ||
+	 name == "setup()" ||
+	 sites.value(name) != 1 ||
+	 size > s_inlineStatements)
+	continue;
+
+      inlined << name;
+    }
+
+  if(!inlined.isEmpty())
+    {
+      for(const auto &name : inlined)
+	{
+	  m_callGraph.removeFunction(name);
+	  m_callGraph.setCalls(name, QHash<QString, int> ());
+	}
+
+      QMutableMapIterator<QString, Function> it(m_optimized);
+
+      while(it.hasNext())
+	{
+	  it.next();
+
+	  if(inlined.contains(it.key()))
+	    continue;
+
+	  auto callees(calls(it.value().statements).keys());
+	  auto host = false;
+
+	  for(const auto &callee : callees)
+	    if(inlined.contains(callee))
+	      {
+		host = true;
+		break;
+	      }
+
+	  if(host)
+	    {
+	      it.value().statements = fold
+		(expand(it.value().statements, inlined), m_report.folded);
+	      m_callGraph.setCalls(it.key(), calls(it.value().statements));
+	    }
+	}
+
+      for(const auto &name : inlined)
+	m_optimized.remove(name);
+
+      m_report.inlined = inlined.size();
+    }
+
+  auto after(costModel(m_optimized));
+  auto before(costModel(m_functions));
+
+  m_report.loopAfter = after.period();
+  m_report.loopBefore = before.period();
+  m_report.setupAfter = after.estimate("setup()");
+  m_report.setupBefore = before.estimate("setup()");
+}
+
+void glitch_optimizer_arduino::setLoop
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  addFunction("loop()", "void", statements);
+}
+
+void glitch_optimizer_arduino::setSetup
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  addFunction("setup()", "void", statements);
+}
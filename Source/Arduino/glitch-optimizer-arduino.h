@@ -0,0 +1,116 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_optimizer_arduino_h_
+#define _glitch_optimizer_arduino_h_
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include "glitch-call-graph.h"
+#include "glitch-cost-model-arduino.h"
+
+class glitch_diagram;
+
+class glitch_optimizer_arduino
+{
+ public:
+  struct Function
+  {
+    QList<QMap<QString, QVariant> > statements;
+    QString returnType;
+  };
+
+  /*
+  ** Estimates of loop() and setup() before and after optimization.
+  */
+
+  struct Report
+  {
+    glitch_cost_model_arduino::Estimate loopAfter;
+    glitch_cost_model_arduino::Estimate loopBefore;
+    glitch_cost_model_arduino::Estimate setupAfter;
+    glitch_cost_model_arduino::Estimate setupBefore;
+    int eliminated;
+    int folded;
+    int inlined;
+  };
+
+  glitch_optimizer_arduino(void);
+  ~glitch_optimizer_arduino();
+  QMap<QString, Function> functions(const bool optimized) const;
+  QString sketch(void) const;
+  QString summary(void) const;
+  Report report(void) const;
+  static QList<QMap<QString, QVariant> > fold
+    (const QList<QMap<QString, QVariant> > &statements, int &folded);
+  void addFunction(const QString &name,
+		   const QString &returnType,
+		   const QList<QMap<QString, QVariant> > &statements);
+  void clear(void);
+  void load(const glitch_diagram &diagram);
+  void optimize(void);
+  void setLoop(const QList<QMap<QString, QVariant> > &statements);
+  void setSetup(const QList<QMap<QString, QVariant> > &statements);
+
+ private:
+  /*
+  ** A folded value. The code of a constant is not emitted unless
+  ** the constant is an operand.
+  */
+
+  struct Value
+  {
+    QList<QMap<QString, QVariant> > code;
+    bool constant;
+    bool negated;
+    bool value;
+  };
+
+  QMap<QString, Function> m_functions;
+  QMap<QString, Function> m_optimized;
+  Report m_report;
+  glitch_call_graph m_callGraph;
+  static QHash<QString, int> calls
+    (const QList<QMap<QString, QVariant> > &statements);
+  QList<QMap<QString, QVariant> > expand
+    (const QList<QMap<QString, QVariant> > &statements,
+     const QSet<QString> &inlined) const;
+  static QList<QMap<QString, QVariant> > expression(const Value &value);
+  static Value constant(const bool value);
+  static Value opaque(const QMap<QString, QVariant> &statement);
+  static glitch_cost_model_arduino costModel
+    (const QMap<QString, Function> &functions);
+  static void flush(QList<QMap<QString, QVariant> > &code,
+		    QVector<Value> &values);
+};
+
+#endif
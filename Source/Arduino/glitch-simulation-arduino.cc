@@ -0,0 +1,451 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QApplication>
+#include <QCloseEvent>
+#include <QFileDialog>
+#include <QScrollBar>
+#include <QShortcut>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+
+#include "glitch-misc.h"
+#include "glitch-serial-log-model.h"
+#include "glitch-simulation-arduino.h"
+#include "glitch-view-arduino.h"
+
+static const int s_serialLines = 10000;
+
+static bool profile_greater_than
+(const QPair<quint64, QString> &p1, const QPair<quint64, QString> &p2)
+{
+  return p1.first > p2.first;
+}
+
+glitch_simulation_arduino::glitch_simulation_arduino
+(glitch_view_arduino *parent):QMainWindow(parent), m_serialLog(s_serialLines)
+{
+  m_drainTimer.setInterval(50);
+  m_serialModel = new glitch_serial_log_model(&m_serialLog, this);
+  m_simulator.setSerialLog(&m_serialLog);
+  m_simulator.setTrace(&m_trace);
+  m_ui.setupUi(this);
+  m_ui.pins->setRowCount(glitch_simulator_arduino::ANALOG_PINS);
+  m_ui.results->setFont(QFont("Courier"));
+  m_ui.serial->setFont(QFont("Courier"));
+  m_ui.serial->setModel(m_serialModel);
+#ifndef Q_OS_UNIX
+  m_ui.terminal->setEnabled(false);
+  m_ui.terminal->setToolTip(tr("Pseudo-terminals are not supported."));
+#endif
+
+  /*
+  ** Diagrams do not contain Serial statements yet. The monitor is
+  ** shown once a simulation produces Serial output.
+  */
+
+  m_ui.serial_dock->setVisible(false);
+  m_ui.waveforms->setTrace(&m_trace);
+
+  for(int i = 0; i < glitch_simulator_arduino::ANALOG_PINS; i++)
+    {
+      m_ui.pins->setItem(i, 0, new QTableWidgetItem("0"));
+      m_ui.pins->setVerticalHeaderItem
+	(i, new QTableWidgetItem(QString("A%1").arg(i)));
+    }
+
+  new QShortcut(tr("Ctrl+W"),
+		this,
+		SLOT(close(void)));
+  connect(&m_drainTimer,
+	  SIGNAL(timeout(void)),
+	  this,
+	  SLOT(slotDrain(void)));
+  connect(parent,
+	  SIGNAL(changed(void)),
+	  this,
+	  SLOT(slotEstimate(void)));
+  connect(&m_watcher,
+	  SIGNAL(finished(void)),
+	  this,
+	  SLOT(slotFinished(void)));
+  connect(m_ui.export_vcd,
+	  SIGNAL(clicked(void)),
+	  this,
+	  SLOT(slotExportVcd(void)));
+  connect(m_ui.run,
+	  SIGNAL(clicked(void)),
+	  this,
+	  SLOT(slotRun(void)));
+  connect(m_ui.seek,
+	  SIGNAL(clicked(void)),
+	  this,
+	  SLOT(slotSeek(void)));
+  connect(m_ui.terminal,
+	  SIGNAL(toggled(bool)),
+	  this,
+	  SLOT(slotTerminal(bool)));
+  setWindowModality(Qt::NonModal);
+  slotEstimate();
+}
+
+glitch_simulation_arduino::~glitch_simulation_arduino()
+{
+  m_serialLog.close();
+  m_simulator.interrupt();
+  m_trace.close();
+  m_watcher.waitForFinished();
+}
+
+void glitch_simulation_arduino::closeEvent(QCloseEvent *event)
+{
+  if(m_watcher.isRunning())
+    {
+      m_serialLog.close();
+      m_simulator.interrupt();
+      m_trace.close();
+    }
+
+  QMainWindow::closeEvent(event);
+}
+
+void glitch_simulation_arduino::showProfiles(void)
+{
+  /*
+  ** Objects are tinted by their shares of the virtual time. Objects
+  ** of diagrams which do not consume time are tinted by their counts.
+  */
+
+  auto view = qobject_cast<glitch_view_arduino *> (parentWidget());
+
+  if(!view)
+    return;
+  else if(!m_simulator.isProfiling())
+    {
+      view->setHeat(QHash<qint64, qreal> ());
+      return;
+    }
+
+  QHash<qint64, qreal> heat;
+  auto profiles(m_simulator.objectProfiles());
+  quint64 count = 0;
+  quint64 micros = 0;
+
+  for(const auto &profile : profiles)
+    {
+      count = qMax(profile.count, count);
+      micros = qMax(profile.micros, micros);
+    }
+
+  QHashIterator<qint64, glitch_simulator_arduino::Profile> it(profiles);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      if(micros > 0)
+	heat[it.key()] = static_cast<qreal> (it.value().micros) /
+	  static_cast<qreal> (micros);
+      else if(count > 0)
+	heat[it.key()] = static_cast<qreal> (it.value().count) /
+	  static_cast<qreal> (count);
+    }
+
+  view->setHeat(heat);
+
+  QList<QPair<quint64, QString> > functions;
+  auto total = qMax(static_cast<quint64> (1), m_simulator.micros());
+
+  QMapIterator<QString, glitch_simulator_arduino::Profile> i
+    (m_simulator.functionProfiles());
+
+  while(i.hasNext())
+    {
+      i.next();
+      functions << QPair<quint64, QString>
+	(i.value().micros,
+	 tr("%1: %2 call(s), %3 ms (%4%).").
+	 arg(i.key()).
+	 arg(i.value().count).
+	 arg(i.value().micros / 1000).
+	 arg(100.0 * static_cast<double> (i.value().micros) /
+	     static_cast<double> (total), 0, 'f', 1));
+    }
+
+  std::stable_sort(functions.begin(), functions.end(), profile_greater_than);
+
+  for(const auto &function : functions)
+    m_ui.results->appendPlainText(function.second);
+}
+
+void glitch_simulation_arduino::slotDrain(void)
+{
+  if(m_trace.drain() > 0)
+    m_ui.waveforms->slotTraceChanged();
+
+  if(m_serialLog.drain() > 0)
+    {
+      /*
+      ** The monitor follows the output unless it was scrolled.
+      */
+
+      auto scrollBar = m_ui.serial->verticalScrollBar();
+      auto first = m_serialModel->rowCount(QModelIndex()) == 0;
+      auto follow = scrollBar->value() == scrollBar->maximum();
+
+      m_serialModel->refresh();
+
+      if(first)
+	m_ui.serial_dock->setVisible(true);
+
+      if(follow)
+	m_ui.serial->scrollToBottom();
+    }
+}
+
+void glitch_simulation_arduino::slotEstimate(void)
+{
+  /*
+  ** The view's model retains the estimates of unchanged functions.
+  */
+
+  auto view = qobject_cast<glitch_view_arduino *> (parentWidget());
+
+  if(!view)
+    return;
+
+  const auto &model(view->costModel());
+  auto functions(model.functions());
+
+  m_ui.estimates->setRowCount(functions.size() + 1);
+
+  for(int i = 0; i <= functions.size(); i++)
+    {
+      auto estimate
+	(i == 0 ? model.period() : model.estimate(functions.at(i - 1)));
+
+      for(int j = 0; j < m_ui.estimates->columnCount(); j++)
+	if(!m_ui.estimates->item(i, j))
+	  {
+	    m_ui.estimates->setItem(i, j, new QTableWidgetItem());
+
+	    if(j > 0)
+	      m_ui.estimates->item(i, j)->setTextAlignment
+		(Qt::AlignRight | Qt::AlignVCenter);
+	  }
+
+      m_ui.estimates->item(i, 0)->setText
+	(i == 0 ? tr("Period of loop()") : functions.at(i - 1));
+      m_ui.estimates->item(i, 1)->setText
+	(QString::number(glitch_cost_model_arduino::micros(estimate.typical),
+			 'f',
+			 1));
+      m_ui.estimates->item(i, 2)->setText
+	(estimate.bounded ?
+	 QString::number
+	 (glitch_cost_model_arduino::
+	  micros(static_cast<double> (estimate.worst)), 'f', 1) :
+	 tr("Unbounded"));
+    }
+
+  m_ui.estimates->resizeColumnsToContents();
+}
+
+void glitch_simulation_arduino::slotExportVcd(void)
+{
+  QFileDialog dialog(this, tr("Glitch: Export Pin Traces"));
+
+  dialog.setAcceptMode(QFileDialog::AcceptSave);
+  dialog.setDefaultSuffix("vcd");
+  dialog.setDirectory(glitch_misc::homePath());
+  dialog.setFileMode(QFileDialog::AnyFile);
+  dialog.setNameFilter("Value Change Dump (*.vcd)");
+  dialog.setOption(QFileDialog::DontConfirmOverwrite, false);
+  dialog.setWindowIcon(windowIcon());
+  QApplication::processEvents();
+
+  if(dialog.exec() == QDialog::Accepted)
+    {
+      QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+      QString error("");
+      auto fileName(dialog.selectedFiles().value(0));
+      auto ok = m_trace.exportVcd(fileName, error);
+
+      QApplication::restoreOverrideCursor();
+
+      if(!ok)
+	glitch_misc::showErrorDialog
+	  (tr("Unable to export %1 (%2).").arg(fileName).arg(error), this);
+    }
+}
+
+void glitch_simulation_arduino::slotFinished(void)
+{
+  m_drainTimer.stop();
+  slotDrain();
+  m_serialLog.close();
+  m_trace.close();
+  m_ui.export_vcd->setEnabled(m_ui.trace->isChecked());
+  m_ui.pins->setEnabled(true);
+  m_ui.profile->setEnabled(true);
+  m_ui.record->setEnabled(true);
+  m_ui.run->setEnabled(true);
+  m_ui.seek->setEnabled(m_simulator.snapshots() > 0);
+  m_ui.seek_iteration->setEnabled(m_simulator.snapshots() > 0);
+  m_ui.seek_iteration->setMaximum
+    (static_cast<int> (qMin(m_simulator.recordedIterations(),
+			    static_cast<quint64>
+			    (std::numeric_limits<int>::max()))));
+  m_ui.trace->setEnabled(true);
+
+  auto elapsed = qMax(static_cast<qint64> (1), m_timer.elapsed());
+
+  if(m_watcher.result())
+    m_ui.results->appendPlainText
+      (tr("%1 iteration(s) in %2 ms (%3 per second). Virtual time: %4 ms.").
+       arg(m_simulator.iterations()).
+       arg(elapsed).
+       arg(m_simulator.iterations() * 1000 / static_cast<quint64> (elapsed)).
+       arg(m_simulator.millis()));
+  else
+    m_ui.results->appendPlainText
+      (tr("Error after %1 iteration(s): %2").
+       arg(m_simulator.iterations()).
+       arg(m_simulator.error()));
+
+  if(m_serialLog.dropped() > 0 || m_serialLog.terminalDropped() > 0)
+    m_ui.results->appendPlainText
+      (tr("Serial output: %1 byte(s) dropped from the log, %2 byte(s) "
+	  "not written to the terminal.").
+       arg(m_serialLog.dropped()).
+       arg(m_serialLog.terminalDropped()));
+
+  showProfiles();
+}
+
+void glitch_simulation_arduino::slotRun(void)
+{
+  /*
+  ** The program is prepared from the diagram's current objects and
+  ** executed by another thread. Pin traces are collected while the
+  ** simulation runs.
+  */
+
+  auto view = qobject_cast<glitch_view_arduino *> (parentWidget());
+
+  if(!view || m_watcher.isRunning())
+    return;
+
+  view->loadSimulator(m_simulator);
+  view->setHeat(QHash<qint64, qreal> ());
+  m_simulator.setProfiling(m_ui.profile->isChecked());
+  m_simulator.setRecording(m_ui.record->isChecked());
+
+  for(int i = 0; i < m_ui.pins->rowCount(); i++)
+    if(m_ui.pins->item(i, 0))
+      m_simulator.setAnalogPin(i, m_ui.pins->item(i, 0)->text().toInt());
+
+  m_serialLog.clear();
+  m_serialLog.open(true);
+  m_serialModel->refresh();
+  m_trace.clear();
+  m_trace.open(true);
+  m_simulator.setTrace(m_ui.trace->isChecked() ? &m_trace : nullptr);
+  m_ui.export_vcd->setEnabled(false);
+  m_ui.pins->setEnabled(false);
+  m_ui.profile->setEnabled(false);
+  m_ui.record->setEnabled(false);
+  m_ui.run->setEnabled(false);
+  m_ui.seek->setEnabled(false);
+  m_ui.seek_iteration->setEnabled(false);
+  m_ui.trace->setEnabled(false);
+  m_ui.waveforms->slotTraceChanged();
+  m_drainTimer.start();
+  m_timer.start();
+  m_watcher.setFuture
+    (QtConcurrent::run(&m_simulator,
+		       &glitch_simulator_arduino::run,
+		       static_cast<quint64> (m_ui.iterations->value())));
+}
+
+void glitch_simulation_arduino::slotSeek(void)
+{
+  if(m_watcher.isRunning())
+    return;
+
+  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+  QElapsedTimer timer;
+
+  timer.start();
+
+  auto ok = m_simulator.seek
+    (static_cast<quint64> (m_ui.seek_iteration->value()));
+  auto elapsed = timer.elapsed();
+
+  QApplication::restoreOverrideCursor();
+
+  if(ok)
+    m_ui.results->appendPlainText
+      (tr("Rewound to iteration %1 in %2 ms. Virtual time: %3 ms.").
+       arg(m_simulator.iterations()).
+       arg(elapsed).
+       arg(m_simulator.millis()));
+  else
+    m_ui.results->appendPlainText
+      (tr("Unable to rewind: %1").arg(m_simulator.error()));
+}
+
+void glitch_simulation_arduino::slotTerminal(bool state)
+{
+  /*
+  ** The pseudo-terminal persists across runs.
+  */
+
+  if(!state)
+    {
+      m_serialLog.closeTerminal();
+      m_ui.terminal_name->clear();
+      return;
+    }
+
+  QString error("");
+
+  if(m_serialLog.openTerminal(error))
+    m_ui.terminal_name->setText(m_serialLog.terminalName());
+  else
+    {
+      m_ui.terminal->blockSignals(true);
+      m_ui.terminal->setChecked(false);
+      m_ui.terminal->blockSignals(false);
+      glitch_misc::showErrorDialog
+	(tr("Unable to open a pseudo-terminal (%1).").arg(error), this);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_simulation_arduino_h_
+#define _glitch_simulation_arduino_h_
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QMainWindow>
+#include <QTimer>
+
+#include "glitch-pin-trace.h"
+#include "glitch-serial-log.h"
+#include "glitch-simulator-arduino.h"
+#include "ui_glitch-simulation-arduino.h"
+
+class glitch_serial_log_model;
+class glitch_view_arduino;
+
+class glitch_simulation_arduino: public QMainWindow
+{
+  Q_OBJECT
+
+ public:
+  glitch_simulation_arduino(glitch_view_arduino *parent);
+  ~glitch_simulation_arduino();
+
+ private:
+  QElapsedTimer m_timer;
+  QFutureWatcher<bool> m_watcher;
+  QTimer m_drainTimer;
+  Ui_glitch_simulation_arduino m_ui;
+  glitch_pin_trace m_trace;
+  glitch_serial_log m_serialLog;
+  glitch_serial_log_model *m_serialModel;
+  glitch_simulator_arduino m_simulator;
+  void closeEvent(QCloseEvent *event);
+  void showProfiles(void);
+
+ private slots:
+  void slotDrain(void);
+  void slotEstimate(void);
+  void slotExportVcd(void);
+  void slotFinished(void);
+  void slotRun(void);
+  void slotSeek(void);
+  void slotTerminal(bool state);
+};
+
+#endif
@@ -0,0 +1,1185 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QElapsedTimer>
+#include <QObject>
+
+#include <iostream>
+
+#include "glitch-code-generator-arduino.h"
+#include "glitch-common.h"
+#include "glitch-diagram.h"
+#include "glitch-pin-trace.h"
+#include "glitch-serial-log.h"
+#include "glitch-simulator-arduino.h"
+
+/*
+** The duration of analogRead(), approximately.
+*/
+
+static const quint64 s_analogReadMicros = 100;
+
+/*
+** The register of a frame which holds values. The engine is an
+** accumulator machine over integers: booleans, analogRead() results,
+** and the zero of a call, since generated functions do not return
+** values.
+*/
+
+static const int s_accumulator = 0;
+
+/*
+** Deeper calls are reported as stack overflows.
+*/
+
+static const int s_maximumDepth = 256;
+
+glitch_simulator_arduino::glitch_simulator_arduino(void)
+{
+  for(int i = 0; i < ANALOG_PINS; i++)
+    m_state.analogPins[i] = 0;
+
+  for(int i = 0; i < DIGITAL_PINS; i++)
+    m_state.digitalPins[i] = false;
+
+  m_engine = BYTECODE;
+  m_profiling = false;
+  m_recording = false;
+  m_replaying = false;
+  m_serialLog = nullptr;
+  m_snapshotInterval = 1000;
+  m_trace = nullptr;
+  clear();
+}
+
+glitch_simulator_arduino::~glitch_simulator_arduino()
+{
+}
+
+QHash<qint64, glitch_simulator_arduino::Profile> glitch_simulator_arduino::
+objectProfiles(void) const
+{
+  /*
+  ** Functions are reported by their objects.
+  */
+
+  QHash<qint64, Profile> profiles;
+
+  for(int i = 0; i < m_functionProfiles.size(); i++)
+    if(m_functionProfiles.at(i).count > 0 && m_functions.at(i).id >= 0)
+      profiles[m_functions.at(i).id] = m_functionProfiles.at(i);
+
+  for(int i = 0; i < m_objectProfiles.size(); i++)
+    if(m_objectProfiles.at(i).count > 0)
+      profiles[m_objectIds.at(i)] = m_objectProfiles.at(i);
+
+  return profiles;
+}
+
+QMap<QString, glitch_simulator_arduino::Profile> glitch_simulator_arduino::
+functionProfiles(void) const
+{
+  QMap<QString, Profile> profiles;
+
+  for(int i = 0; i < m_functionProfiles.size(); i++)
+    if(m_functionProfiles.at(i).count > 0)
+      profiles[m_functions.at(i).name] = m_functionProfiles.at(i);
+
+  return profiles;
+}
+
+QString glitch_simulator_arduino::error(void) const
+{
+  return m_error;
+}
+
+QStringList glitch_simulator_arduino::pinKeys(void)
+{
+  /*
+  ** Command-line keys of the analog and digital pins.
+  */
+
+  QStringList keys;
+
+  for(int i = 0; i < ANALOG_PINS; i++)
+    keys << QString("a%1").arg(i);
+
+  for(int i = 0; i < DIGITAL_PINS; i++)
+    keys << QString("d%1").arg(i);
+
+  return keys;
+}
+
+glitch_simulator_arduino::Engines glitch_simulator_arduino::engine(void) const
+{
+  return m_engine;
+}
+
+bool glitch_simulator_arduino::call(const int function)
+{
+  if(!m_error.isEmpty())
+    return false;
+  else if(m_depth >= s_maximumDepth)
+    {
+      m_error = QObject::tr("Stack overflow in %1.").
+	arg(m_functions.at(function).name);
+      return false;
+    }
+
+  auto micros = m_state.micros;
+
+  if(m_profiling)
+    m_functionProfiles[function].count += 1;
+
+  m_depth += 1;
+
+  for(auto statement : m_functions.at(function).body)
+    {
+      evaluate(statement);
+
+      if(!m_error.isEmpty())
+	break;
+    }
+
+  m_depth -= 1;
+
+  if(m_profiling)
+    m_functionProfiles[function].micros += m_state.micros - micros;
+
+  return m_error.isEmpty();
+}
+
+bool glitch_simulator_arduino::compile(void)
+{
+  /*
+  ** Bodies are compiled as the code generator interprets them.
+  ** Values are held until a consumer or a statement without a value
+  ** is reached. Remaining values are evaluated as statements.
+  */
+
+  if(m_compiled)
+    return true;
+
+  /*
+  ** Objects are assigned consecutive indexes. Their counters
+  ** are not hashed while the program executes.
+  */
+
+  QHash<qint64, int> objects;
+
+  m_nodes.clear();
+  m_objectIds.clear();
+
+  for(int i = 0; i < m_functions.size(); i++)
+    {
+      QVector<int> body;
+      QVector<int> values;
+
+      for(const auto &statement : m_functions.at(i).statements)
+	{
+	  QString type(statement.value("type").toString());
+	  auto id = statement.value("myoid").toLongLong();
+
+	  if(!objects.contains(id))
+	    {
+	      objects[id] = m_objectIds.size();
+	      m_objectIds << id;
+	    }
+
+	  auto object = objects.value(id);
+
+	  if(type == "arduino-analogread")
+	    values << node(ANALOG_READ, -1, -1, 0, object);
+	  else if(type == "arduino-function")
+	    {
+	      QString name(statement.value("name").toString().trimmed());
+
+	      if(name.isEmpty())
+		continue;
+	      else if(!m_functionIndexes.contains(name))
+		{
+		  m_error = QObject::tr("%1 is not defined.").arg(name);
+		  return false;
+		}
+
+	      auto n = node
+		(CALL, -1, -1, m_functionIndexes.value(name), object);
+
+	      if(statement.value("return_type").toString() == "void")
+		{
+		  body << values << n;
+		  values.clear();
+		}
+	      else
+		values << n;
+	    }
+	  else if(type == "arduino-logicaloperator")
+	    {
+	      QString o(statement.value("operator").toString());
+
+	      if(o == "not")
+		{
+		  auto value = values.isEmpty() ?
+		    node(CONSTANT, -1, -1, 0) : values.takeLast();
+
+		  values << node(NOT, value, -1, 0, object);
+		}
+	      else
+		{
+		  /*
+		  ** Missing operands are replaced with identity values.
+		  */
+
+		  int identity = o == "or" ? 0 : 1;
+		  auto value2 = values.isEmpty() ?
+		    node(CONSTANT, -1, -1, identity) : values.takeLast();
+		  auto value1 = values.isEmpty() ?
+		    node(CONSTANT, -1, -1, identity) : values.takeLast();
+
+		  values << node
+		    (o == "or" ? OR : AND, value1, value2, 0, object);
+		}
+	    }
+	}
+
+      body << values;
+      m_functions[i].body = body;
+    }
+
+  /*
+  ** Flatten the trees into threaded code. The logical operators
+  ** short-circuit, so an operand is consumed before the next one is
+  ** computed and every value is held in the frame's accumulator,
+  ** register 0. If profiling, the remaining registers hold the times
+  ** at which the function and its objects were entered.
+  */
+
+  int registers = 1;
+
+  m_code.clear();
+
+  for(int i = 0; i < m_functions.size(); i++)
+    {
+      auto &function(m_functions[i]);
+      auto mark = m_profiling ? 2 : 1;
+
+      function.entry = m_code.size();
+      function.registers = mark;
+
+      if(m_profiling)
+	instruction(OP_FUNCTION_BEGIN, 1, i);
+
+      for(auto statement : function.body)
+	function.registers = qMax
+	  (generate(statement, mark), function.registers);
+
+      if(m_profiling)
+	instruction(OP_FUNCTION_END, 1, i);
+
+      instruction(OP_RETURN);
+      registers = qMax(function.registers, registers);
+    }
+
+  m_functionProfiles = QVector<Profile> (m_functions.size(), Profile());
+  m_objectProfiles = QVector<Profile> (m_objectIds.size(), Profile());
+
+  m_frames.resize(s_maximumDepth);
+  m_registers.resize(s_maximumDepth * registers);
+  m_compiled = true;
+  return true;
+}
+
+bool glitch_simulator_arduino::digitalPin(const int pin) const
+{
+  if(pin >= 0 && pin < DIGITAL_PINS)
+    return m_state.digitalPins[pin];
+  else
+    return false;
+}
+
+bool glitch_simulator_arduino::execute(const int function)
+{
+  /*
+  ** Calls are kept on a frame stack rather than the host's stack.
+  ** Instructions are threaded through a table of labels if the
+  ** compiler supports them.
+  */
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+  static void *labels[] =
+    {
+     &&op_analog_read,
+     &&op_call,
+     &&op_function_begin,
+     &&op_function_end,
+     &&op_jump_if_not_zero,
+     &&op_jump_if_zero,
+     &&op_load,
+     &&op_not,
+     &&op_object_begin,
+     &&op_object_end,
+     &&op_return,
+     &&op_test
+    };
+#define GLITCH_DISPATCH goto *labels[code[pc].opcode]
+#define GLITCH_OPCODE(label, opcode) label:
+#else
+#define GLITCH_DISPATCH continue
+#define GLITCH_OPCODE(label, opcode) case opcode:
+#endif
+
+  auto code = m_code.constData();
+  auto frames = m_frames.data();
+  auto functionProfiles = m_functionProfiles.data();
+  auto functions = m_functions.constData();
+  auto objectProfiles = m_objectProfiles.data();
+  auto registers = m_registers.data();
+  int base = 0;
+  int current = function;
+  int depth = 0;
+  int pc = functions[current].entry;
+  auto journal = m_recording || m_trace;
+  quint64 micros = m_state.micros;
+
+#if defined(__GNUC__)
+  GLITCH_DISPATCH;
+#else
+  for(;;)
+    switch(code[pc].opcode)
+      {
+#endif
+	GLITCH_OPCODE(op_analog_read, OP_ANALOG_READ)
+	  {
+	    if(Q_UNLIKELY(journal))
+	      {
+		m_state.micros = micros;
+		registers[base + code[pc].a] = analogRead(code[pc].b);
+		micros = m_state.micros;
+	      }
+	    else
+	      {
+		micros += s_analogReadMicros;
+		registers[base + code[pc].a] =
+		  m_state.analogPins[code[pc].b];
+	      }
+
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_call, OP_CALL)
+	  {
+	    if(depth + 1 >= s_maximumDepth)
+	      {
+		m_state.micros = micros;
+		m_error = QObject::tr("Stack overflow in %1.").
+		  arg(functions[code[pc].b].name);
+		return false;
+	      }
+
+	    /*
+	    ** Generated functions do not return values. Their registers
+	    ** are zero.
+	    */
+
+	    registers[base + code[pc].a] = 0;
+	    frames[depth].base = base;
+	    frames[depth].function = current;
+	    frames[depth].pc = pc + 1;
+	    base += functions[current].registers;
+	    current = code[pc].b;
+	    depth += 1;
+	    pc = functions[current].entry;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_function_begin, OP_FUNCTION_BEGIN)
+	  {
+	    functionProfiles[code[pc].b].count += 1;
+	    registers[base + code[pc].a] = static_cast<qint64> (micros);
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_function_end, OP_FUNCTION_END)
+	  {
+	    functionProfiles[code[pc].b].micros +=
+	      micros - static_cast<quint64> (registers[base + code[pc].a]);
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_jump_if_not_zero, OP_JUMP_IF_NOT_ZERO)
+	  {
+	    if(registers[base + code[pc].a])
+	      pc = code[pc].b;
+	    else
+	      pc += 1;
+
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_jump_if_zero, OP_JUMP_IF_ZERO)
+	  {
+	    if(registers[base + code[pc].a])
+	      pc += 1;
+	    else
+	      pc = code[pc].b;
+
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_load, OP_LOAD)
+	  {
+	    registers[base + code[pc].a] = code[pc].b;
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_not, OP_NOT)
+	  {
+	    auto &r(registers[base + code[pc].a]);
+
+	    r = !r;
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_object_begin, OP_OBJECT_BEGIN)
+	  {
+	    objectProfiles[code[pc].b].count += 1;
+	    registers[base + code[pc].a] = static_cast<qint64> (micros);
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_object_end, OP_OBJECT_END)
+	  {
+	    objectProfiles[code[pc].b].micros +=
+	      micros - static_cast<quint64> (registers[base + code[pc].a]);
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_return, OP_RETURN)
+	  {
+	    if(depth == 0)
+	      {
+		m_state.micros = micros;
+		return true;
+	      }
+
+	    depth -= 1;
+	    base = frames[depth].base;
+	    current = frames[depth].function;
+	    pc = frames[depth].pc;
+	    GLITCH_DISPATCH;
+	  }
+	GLITCH_OPCODE(op_test, OP_TEST)
+	  {
+	    auto &r(registers[base + code[pc].a]);
+
+	    r = r != 0;
+	    pc += 1;
+	    GLITCH_DISPATCH;
+	  }
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#else
+      }
+#endif
+
+#undef GLITCH_DISPATCH
+#undef GLITCH_OPCODE
+}
+
+bool glitch_simulator_arduino::isProfiling(void) const
+{
+  return m_profiling;
+}
+
+bool glitch_simulator_arduino::isRecording(void) const
+{
+  return m_recording;
+}
+
+bool glitch_simulator_arduino::isReplaying(void) const
+{
+  return m_replaying;
+}
+
+bool glitch_simulator_arduino::load(const glitch_diagram &diagram)
+{
+  clear();
+
+  for(const auto &object : diagram.topLevelObjects())
+    {
+      auto statements
+	(glitch_code_generator_arduino::
+	 statements(diagram.children(object.id()),
+		    diagram.wireGraph(object.id())));
+
+      if(object.type() == "arduino-function")
+	{
+	  if(!object.property("clone").toBool())
+	    addFunction(object.property("name").toString().trimmed(),
+			object.property("return_type").toString(),
+			statements,
+			object.id());
+	}
+      else if(object.type() == "arduino-loop")
+	setLoop(statements);
+      else if(object.type() == "arduino-setup")
+	setSetup(statements);
+    }
+
+  return compile();
+}
+
+bool glitch_simulator_arduino::run(const quint64 iterations)
+{
+  /*
+  ** Execute setup() once and loop() the given number of times.
+  */
+
+  if(!compile())
+    return false;
+
+  if(!m_state.setupDone)
+    {
+      m_state.setupDone = true;
+
+      if(!(m_engine == BYTECODE ? execute(m_setup) : call(m_setup)))
+	return false;
+    }
+
+  for(quint64 i = 0; i < iterations; i++)
+    {
+      if(m_interrupted.load(std::memory_order_relaxed))
+	{
+	  m_error = QObject::tr("Interrupted.");
+	  return false;
+	}
+
+      if(m_recording)
+	journal();
+
+      if(!(m_engine == BYTECODE ? execute(m_loop) : call(m_loop)))
+	return false;
+
+      m_state.iterations += 1;
+
+      if(!m_replaying)
+	m_recordedIterations = qMax(m_state.iterations, m_recordedIterations);
+    }
+
+  return true;
+}
+
+bool glitch_simulator_arduino::seek(const quint64 iteration)
+{
+  /*
+  ** Restore the latest snapshot which precedes the iteration and
+  ** replay the journal from there.
+  */
+
+  if(!m_recording || m_snapshots.isEmpty())
+    {
+      m_error = QObject::tr("The simulation has not been recorded.");
+      return false;
+    }
+
+  auto target = qMin(iteration, m_recordedIterations);
+  int high = m_snapshots.size();
+  int low = 0;
+
+  while(high - low > 1)
+    {
+      auto middle = low + (high - low) / 2;
+
+      if(m_snapshots.at(middle).iterations <= target)
+	low = middle;
+      else
+	high = middle;
+    }
+
+  m_depth = 0;
+  m_error.clear();
+  m_replaying = true;
+  m_state = m_snapshots.at(low);
+
+  if(run(target - m_state.iterations))
+    {
+      if(m_state.iterations >= m_recordedIterations)
+	m_replaying = false;
+
+      return true;
+    }
+  else
+    return false;
+}
+
+int glitch_simulator_arduino::analogPin(const int pin) const
+{
+  if(pin >= 0 && pin < ANALOG_PINS)
+    return m_state.analogPins[pin];
+  else
+    return 0;
+}
+
+int glitch_simulator_arduino::analogRead(const int pin)
+{
+  /*
+  ** Recorded values are journaled as they change. Replayed values
+  ** are taken from the journal.
+  */
+
+  int value = m_state.analogPins[pin];
+
+  if(m_replaying)
+    {
+      if(m_state.input < m_inputs.size() &&
+	 m_inputs.at(m_state.input).read == m_state.reads)
+	{
+	  m_state.values[m_inputs.at(m_state.input).pin] =
+	    m_inputs.at(m_state.input).value;
+	  m_state.input += 1;
+	}
+
+      value = m_state.values[pin];
+    }
+  else
+    {
+      if(m_recording && m_state.values[pin] != value)
+	{
+	  Input input;
+
+	  input.pin = pin;
+	  input.read = m_state.reads;
+	  input.value = value;
+	  m_inputs << input;
+	  m_state.input = m_inputs.size();
+	  m_state.values[pin] = value;
+	}
+
+      if(m_trace)
+	m_trace->record(pin, m_state.micros, value);
+    }
+
+  m_state.micros += s_analogReadMicros;
+  m_state.reads += 1;
+  return value;
+}
+
+int glitch_simulator_arduino::compute(const int node)
+{
+  const auto &n(m_nodes.at(node));
+
+  switch(n.type)
+    {
+    case ANALOG_READ:
+      {
+	return analogRead(0);
+      }
+    case AND:
+      {
+	return evaluate(n.left) && evaluate(n.right);
+      }
+    case CALL:
+      {
+	/*
+	** Generated functions do not return values. Their values
+	** are zero.
+	*/
+
+	call(n.value);
+	return 0;
+      }
+    case CONSTANT:
+      {
+	return n.value;
+      }
+    case NOT:
+      {
+	return !evaluate(n.left);
+      }
+    case OR:
+      {
+	return evaluate(n.left) || evaluate(n.right);
+      }
+    default:
+      {
+	return 0;
+      }
+    }
+}
+
+int glitch_simulator_arduino::evaluate(const int node)
+{
+  auto object = m_nodes.at(node).object;
+
+  if(!m_profiling || object < 0)
+    return compute(node);
+
+  auto micros = m_state.micros;
+
+  m_objectProfiles[object].count += 1;
+
+  auto value = compute(node);
+
+  m_objectProfiles[object].micros += m_state.micros - micros;
+  return value;
+}
+
+int glitch_simulator_arduino::exec(const QString &fileName,
+				   const QStringList &arguments)
+{
+  QMap<QString, qint64> values;
+  QString error("");
+
+  if(!glitch_common::parseArguments
+     (arguments,
+      pinKeys() << "interval" << "iterations" << "seek",
+      values,
+      error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  glitch_simulator_arduino simulator;
+  auto iterations = static_cast<quint64>
+    (values.value("iterations", 1000000));
+  auto seek = values.value("seek", -1);
+  quint64 interval = 0;
+
+  if(values.contains("interval"))
+    interval = static_cast<quint64>
+      (qBound(1LL, values.value("interval"), 1000000000LL));
+
+  for(int i = 0; i < ANALOG_PINS; i++)
+    {
+      QString key(QString("a%1").arg(i));
+
+      if(values.contains(key))
+	simulator.setAnalogPin
+	  (i, static_cast<int> (qMin(values.value(key), 1023LL)));
+    }
+
+  for(int i = 0; i < DIGITAL_PINS; i++)
+    {
+      QString key(QString("d%1").arg(i));
+
+      if(values.contains(key))
+	simulator.setDigitalPin(i, values.value(key) != 0);
+    }
+
+  glitch_diagram diagram;
+
+  if(!diagram.load(fileName, error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  QElapsedTimer timer;
+
+  timer.start();
+
+  if(!simulator.load(diagram))
+    {
+      std::cerr << simulator.error().toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  if(interval > 0 || seek >= 0)
+    simulator.setRecording
+      (true, interval > 0 ? static_cast<int> (interval) : 1000);
+
+  if(!simulator.run(iterations))
+    {
+      std::cerr << simulator.error().toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  auto elapsed = qMax(static_cast<qint64> (1), timer.elapsed());
+
+  std::cout << fileName.toStdString()
+	    << ": "
+	    << simulator.iterations()
+	    << " iteration(s) in "
+	    << elapsed
+	    << " ms ("
+	    << simulator.iterations() * 1000 / static_cast<quint64> (elapsed)
+	    << " per second). Virtual time: "
+	    << simulator.millis()
+	    << " ms."
+	    << std::endl;
+
+  if(seek >= 0)
+    {
+      auto micros = simulator.micros();
+
+      timer.restart();
+
+      if(!simulator.seek(static_cast<quint64> (seek)))
+	{
+	  std::cerr << simulator.error().toStdString() << std::endl;
+	  return EXIT_FAILURE;
+	}
+
+      std::cout << "Seek to iteration "
+		<< simulator.iterations()
+		<< " of "
+		<< simulator.recordedIterations()
+		<< " in "
+		<< timer.elapsed()
+		<< " ms ("
+		<< simulator.snapshots()
+		<< " snapshot(s)). Virtual time: "
+		<< simulator.millis()
+		<< " of "
+		<< micros / 1000
+		<< " ms."
+		<< std::endl;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int glitch_simulator_arduino::generate(const int node, const int m)
+{
+  /*
+  ** Emit the instructions which place the value of the tree in the
+  ** accumulator. If profiling, the time at which the tree is entered
+  ** is held in register m. The number of registers is returned.
+  */
+
+  const auto n(m_nodes.at(node));
+  auto profile = m_profiling && n.object >= 0;
+  auto registers = profile ? m + 1 : 1;
+
+  if(profile)
+    instruction(OP_OBJECT_BEGIN, m, n.object);
+
+  switch(n.type)
+    {
+    case ANALOG_READ:
+      {
+	instruction(OP_ANALOG_READ, s_accumulator, 0);
+	break;
+      }
+    case AND:
+    case OR:
+      {
+	registers = qMax(generate(n.left, m + 1), registers);
+	instruction(OP_TEST, s_accumulator);
+
+	auto jump = instruction
+	  (n.type == AND ? OP_JUMP_IF_ZERO : OP_JUMP_IF_NOT_ZERO,
+	   s_accumulator);
+
+	registers = qMax(generate(n.right, m + 1), registers);
+	instruction(OP_TEST, s_accumulator);
+	m_code[jump].b = m_code.size();
+	break;
+      }
+    case CALL:
+      {
+	instruction(OP_CALL, s_accumulator, n.value);
+	break;
+      }
+    case CONSTANT:
+      {
+	instruction(OP_LOAD, s_accumulator, n.value);
+	break;
+      }
+    case NOT:
+      {
+	registers = qMax(generate(n.left, m + 1), registers);
+	instruction(OP_NOT, s_accumulator);
+	break;
+      }
+    default:
+      {
+	break;
+      }
+    }
+
+  if(profile)
+    instruction(OP_OBJECT_END, m, n.object);
+
+  return registers;
+}
+
+int glitch_simulator_arduino::instruction(const Opcodes opcode,
+					  const int a,
+					  const int b)
+{
+  Instruction i;
+
+  i.a = static_cast<quint16> (a);
+  i.b = b;
+  i.opcode = static_cast<quint8> (opcode);
+  i.reserved = 0;
+  m_code << i;
+  return m_code.size() - 1;
+}
+
+int glitch_simulator_arduino::node(const Types type,
+				   const int left,
+				   const int right,
+				   const int value,
+				   const int object)
+{
+  Node n;
+
+  n.left = left;
+  n.object = object;
+  n.right = right;
+  n.type = type;
+  n.value = value;
+  m_nodes << n;
+  return m_nodes.size() - 1;
+}
+
+int glitch_simulator_arduino::snapshots(void) const
+{
+  return m_snapshots.size();
+}
+
+quint64 glitch_simulator_arduino::iterations(void) const
+{
+  return m_state.iterations;
+}
+
+quint64 glitch_simulator_arduino::micros(void) const
+{
+  return m_state.micros;
+}
+
+quint64 glitch_simulator_arduino::millis(void) const
+{
+  return m_state.micros / 1000;
+}
+
+quint64 glitch_simulator_arduino::recordedIterations(void) const
+{
+  return m_recordedIterations;
+}
+
+void glitch_simulator_arduino::addFunction
+(const QString &name,
+ const QString &returnType,
+ const QList<QMap<QString, QVariant> > &statements,
+ const qint64 id)
+{
+  Function function;
+
+  function.entry = 0;
+  function.id = id;
+  function.name = name;
+  function.registers = 1;
+  function.returnType = returnType;
+  function.statements = statements;
+
+  if(m_functionIndexes.contains(name))
+    m_functions[m_functionIndexes.value(name)] = function;
+  else
+    {
+      m_functionIndexes[name] = m_functions.size();
+      m_functions << function;
+    }
+
+  m_compiled = false;
+}
+
+void glitch_simulator_arduino::clear(void)
+{
+  /*
+  ** Remove the program. The pins are retained.
+  */
+
+  m_code.clear();
+  m_compiled = false;
+  m_functionIndexes.clear();
+  m_functions.clear();
+  m_nodes.clear();
+  addFunction("loop()", "void", QList<QMap<QString, QVariant> > ());
+  addFunction("setup()", "void", QList<QMap<QString, QVariant> > ());
+  m_loop = m_functionIndexes.value("loop()");
+  m_setup = m_functionIndexes.value("setup()");
+  reset();
+}
+
+void glitch_simulator_arduino::interrupt(void)
+{
+  /*
+  ** May be issued by another thread.
+  */
+
+  m_interrupted.store(true);
+}
+
+void glitch_simulator_arduino::journal(void)
+{
+  /*
+  ** Issued before every iteration of loop() while recording.
+  ** Replaying ends where the recording ends.
+  */
+
+  if(m_replaying && m_state.iterations >= m_recordedIterations)
+    m_replaying = false;
+
+  if(!m_replaying &&
+     m_state.iterations % static_cast<quint64> (m_snapshotInterval) == 0 &&
+     (m_snapshots.isEmpty() ||
+      m_snapshots.last().iterations < m_state.iterations))
+    m_snapshots << m_state;
+}
+
+void glitch_simulator_arduino::reset(void)
+{
+  /*
+  ** The pins are retained. The journal is discarded.
+  */
+
+  for(int i = 0; i < ANALOG_PINS; i++)
+    m_state.values[i] = -1;
+
+  m_depth = 0;
+  m_error.clear();
+  m_functionProfiles.fill(Profile());
+  m_inputs.clear();
+  m_interrupted.store(false);
+  m_objectProfiles.fill(Profile());
+  m_recordedIterations = 0;
+  m_replaying = false;
+  m_snapshots.clear();
+  m_state.input = 0;
+  m_state.iterations = 0;
+  m_state.micros = 0;
+  m_state.reads = 0;
+  m_state.setupDone = false;
+}
+
+void glitch_simulator_arduino::serialWrite(const QByteArray &bytes)
+{
+  if(m_serialLog && !m_replaying)
+    m_serialLog->write(bytes);
+}
+
+void glitch_simulator_arduino::setAnalogPin(const int pin, const int value)
+{
+  if(pin < 0 || pin >= ANALOG_PINS)
+    return;
+
+  auto level = qBound(0, value, 1023);
+
+  if(m_state.analogPins[pin] == level)
+    return;
+
+  m_state.analogPins[pin] = level;
+
+  if(m_trace && !m_replaying)
+    m_trace->record(pin, m_state.micros, level);
+}
+
+void glitch_simulator_arduino::setDigitalPin(const int pin, const bool value)
+{
+  if(pin >= 0 && pin < DIGITAL_PINS)
+    m_state.digitalPins[pin] = value;
+}
+
+void glitch_simulator_arduino::setEngine(const Engines engine)
+{
+  m_engine = engine;
+}
+
+void glitch_simulator_arduino::setLoop
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  addFunction("loop()", "void", statements);
+}
+
+void glitch_simulator_arduino::setProfiling(const bool profiling)
+{
+  /*
+  ** The program is compiled again. Profiles are collected by
+  ** additional instructions.
+  */
+
+  if(m_profiling != profiling)
+    {
+      m_compiled = false;
+      m_profiling = profiling;
+    }
+}
+
+void glitch_simulator_arduino::setRecording(const bool recording,
+					    const int interval)
+{
+  /*
+  ** A snapshot is taken every interval iterations of loop(). Seeking
+  ** replays at most interval iterations.
+  */
+
+  m_recording = recording;
+  m_snapshotInterval = qMax(1, interval);
+  reset();
+}
+
+void glitch_simulator_arduino::setSerialLog(glitch_serial_log *serialLog)
+{
+  /*
+  ** Serial output is written by the thread which runs the simulation.
+  */
+
+  m_serialLog = serialLog;
+}
+
+void glitch_simulator_arduino::setSetup
+(const QList<QMap<QString, QVariant> > &statements)
+{
+  addFunction("setup()", "void", statements);
+}
+
+void glitch_simulator_arduino::setTrace(glitch_pin_trace *trace)
+{
+  /*
+  ** The trace is dedicated to the simulator. Its channels, the analog
+  ** inputs, are created once. A channel begins with the level of its
+  ** input and records the level as it is changed. A0 also records
+  ** every analogRead(), the only input which diagrams read. Samples
+  ** are recorded by the thread which runs the simulation.
+  */
+
+  m_trace = trace;
+
+  if(!m_trace)
+    return;
+
+  if(m_trace->count() == 0)
+    for(int i = 0; i < ANALOG_PINS; i++)
+      m_trace->addChannel(QString("A%1").arg(i), 10);
+
+  if(!m_replaying)
+    for(int i = 0; i < ANALOG_PINS; i++)
+      m_trace->record(i, m_state.micros, m_state.analogPins[i]);
+}
@@ -0,0 +1,237 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_simulator_arduino_h_
+#define _glitch_simulator_arduino_h_
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <atomic>
+
+class glitch_diagram;
+class glitch_pin_trace;
+class glitch_serial_log;
+
+class glitch_simulator_arduino
+{
+ public:
+  enum
+  {
+    ANALOG_PINS = 6,
+    DIGITAL_PINS = 20
+  };
+
+  enum Engines
+  {
+    BYTECODE = 0,
+    TREE
+  };
+
+  /*
+  ** Executions and the virtual time which elapsed during them,
+  ** including the time of nested objects and calls.
+  */
+
+  struct Profile
+  {
+    quint64 count;
+    quint64 micros;
+  };
+
+  glitch_simulator_arduino(void);
+  ~glitch_simulator_arduino();
+  QHash<qint64, Profile> objectProfiles(void) const;
+  QMap<QString, Profile> functionProfiles(void) const;
+  QString error(void) const;
+  static QStringList pinKeys(void);
+  bool digitalPin(const int pin) const;
+  bool isProfiling(void) const;
+  bool isRecording(void) const;
+  bool isReplaying(void) const;
+  bool load(const glitch_diagram &diagram);
+  bool run(const quint64 iterations);
+  bool seek(const quint64 iteration);
+  Engines engine(void) const;
+  int analogPin(const int pin) const;
+  int snapshots(void) const;
+  quint64 iterations(void) const;
+  quint64 micros(void) const;
+  quint64 millis(void) const;
+  quint64 recordedIterations(void) const;
+  static int exec(const QString &fileName, const QStringList &arguments);
+  void addFunction(const QString &name,
+		   const QString &returnType,
+		   const QList<QMap<QString, QVariant> > &statements,
+		   const qint64 id = -1);
+  void clear(void);
+  void interrupt(void);
+  void reset(void);
+  void serialWrite(const QByteArray &bytes);
+  void setAnalogPin(const int pin, const int value);
+  void setDigitalPin(const int pin, const bool value);
+  void setEngine(const Engines engine);
+  void setLoop(const QList<QMap<QString, QVariant> > &statements);
+  void setProfiling(const bool profiling);
+  void setRecording(const bool recording, const int interval = 1000);
+  void setSerialLog(glitch_serial_log *serialLog);
+  void setSetup(const QList<QMap<QString, QVariant> > &statements);
+  void setTrace(glitch_pin_trace *trace);
+
+ private:
+  enum Types
+  {
+    ANALOG_READ = 0,
+    AND,
+    CALL,
+    CONSTANT,
+    NOT,
+    OR
+  };
+
+  enum Opcodes
+  {
+    OP_ANALOG_READ = 0,
+    OP_CALL,
+    OP_FUNCTION_BEGIN,
+    OP_FUNCTION_END,
+    OP_JUMP_IF_NOT_ZERO,
+    OP_JUMP_IF_ZERO,
+    OP_LOAD,
+    OP_NOT,
+    OP_OBJECT_BEGIN,
+    OP_OBJECT_END,
+    OP_RETURN,
+    OP_TEST
+  };
+
+  struct Frame
+  {
+    int base;
+    int function;
+    int pc;
+  };
+
+  struct Function
+  {
+    QList<QMap<QString, QVariant> > statements;
+    QString name;
+    QString returnType;
+    QVector<int> body;
+    int entry;
+    int registers;
+    qint64 id;
+  };
+
+  struct Instruction
+  {
+    quint8 opcode;
+    quint8 reserved;
+    quint16 a;
+    qint32 b;
+  };
+
+  struct Node
+  {
+    Types type;
+    int left;
+    int object;
+    int right;
+    int value;
+  };
+
+  struct Input
+  {
+    int pin;
+    int value;
+    quint64 read;
+  };
+
+  /*
+  ** The complete state of the machine between iterations of loop().
+  ** Snapshots are copies.
+  */
+
+  struct State
+  {
+    bool digitalPins[DIGITAL_PINS];
+    bool setupDone;
+    int analogPins[ANALOG_PINS];
+    int input;
+    int values[ANALOG_PINS];
+    quint64 iterations;
+    quint64 micros;
+    quint64 reads;
+  };
+
+  QHash<QString, int> m_functionIndexes;
+  QString m_error;
+  QVector<Frame> m_frames;
+  QVector<Function> m_functions;
+  QVector<Instruction> m_code;
+  QVector<Node> m_nodes;
+  QVector<Profile> m_functionProfiles;
+  QVector<Profile> m_objectProfiles;
+  QVector<qint64> m_objectIds;
+  QVector<qint64> m_registers;
+  Engines m_engine;
+  bool m_compiled;
+  bool m_profiling;
+  QVector<Input> m_inputs;
+  QVector<State> m_snapshots;
+  State m_state;
+  bool m_recording;
+  bool m_replaying;
+  glitch_pin_trace *m_trace;
+  glitch_serial_log *m_serialLog;
+  int m_depth;
+  int m_loop;
+  int m_setup;
+  int m_snapshotInterval;
+  std::atomic<bool> m_interrupted;
+  quint64 m_recordedIterations;
+  bool call(const int function);
+  bool compile(void);
+  bool execute(const int function);
+  int analogRead(const int pin);
+  int compute(const int node);
+  int evaluate(const int node);
+  int generate(const int node, const int m);
+  int instruction(const Opcodes opcode, const int a = 0, const int b = 0);
+  int node(const Types type,
+	   const int left = -1,
+	   const int right = -1,
+	   const int value = 0,
+	   const int object = -1);
+  void journal(void);
+};
+
+#endif
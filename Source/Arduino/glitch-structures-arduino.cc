@@ -222,6 +222,19 @@ QStringList glitch_structures_arduino::nonArrayTypes(void)
   return s_nonArrayTypes;
 }
 
+QStringList glitch_structures_arduino::objectTypes(void)
+{
+  /*
+  ** The types of the implemented objects.
+  */
+
+  return QStringList() << "arduino-analogread"
+		       << "arduino-function"
+		       << "arduino-logicaloperator"
+		       << "arduino-loop"
+		       << "arduino-setup";
+}
+
 QStringList glitch_structures_arduino::structureNames(void)
 {
   if(!s_structureNamesMap.isEmpty())
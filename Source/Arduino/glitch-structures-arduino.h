@@ -40,6 +40,7 @@ class glitch_structures_arduino: public QDialog
   glitch_structures_arduino(QWidget *parent);
   ~glitch_structures_arduino();
   static QStringList nonArrayTypes(void);
+  static QStringList objectTypes(void);
   static QStringList structureNames(void);
   static QStringList types(void);
   static bool containsStructure(const QString &structureName);
@@ -28,10 +28,19 @@
 #include <QSqlQuery>
 #include <QtDebug>
 
+#include "glitch-canvas-settings.h"
+#include "glitch-code-generator-arduino.h"
+#include "glitch-object-function-arduino.h"
 #include "glitch-object-loop-arduino.h"
+#include "glitch-object-view.h"
 #include "glitch-object-setup-arduino.h"
+#include "glitch-optimizer-arduino.h"
 #include "glitch-proxy-widget.h"
 #include "glitch-scene.h"
+#include "glitch-simulation-arduino.h"
+#include "glitch-simulator-arduino.h"
+#include "glitch-style-sheet-pool.h"
+#include "glitch-trace.h"
 #include "glitch-view-arduino.h"
 
 glitch_view_arduino::glitch_view_arduino
@@ -63,6 +72,17 @@ glitch_view_arduino::glitch_view_arduino
   m_scene->addItem(proxy);
   m_setupObject->setProxy(proxy);
   proxy->setPos(m_loopObject->width() + 20.0, 10.0);
+  m_callGraph.addRoot("loop()");
+  m_callGraph.addRoot("setup()");
+  m_canvasSettings->setFootprint(&m_footprint);
+  connect(m_canvasSettings,
+	  SIGNAL(accepted(const bool)),
+	  this,
+	  SLOT(slotUpdateFootprint(void)));
+  connect(m_loopObject,
+	  SIGNAL(changed(void)),
+	  this,
+	  SLOT(slotCallsChanged(void)));
   connect(m_loopObject,
 	  SIGNAL(changed(void)),
 	  this,
@@ -71,10 +91,18 @@ glitch_view_arduino::glitch_view_arduino
 	  SIGNAL(functionAdded(const QString &, const bool)),
 	  this,
 	  SLOT(slotFunctionAdded(const QString &, const bool)));
+  connect(m_scene,
+	  SIGNAL(functionChanged(glitch_object *)),
+	  this,
+	  SLOT(slotFunctionChanged(glitch_object *)));
   connect(m_scene,
 	  SIGNAL(functionDeleted(const QString &)),
 	  this,
 	  SLOT(slotFunctionDeleted(const QString &)));
+  connect(m_setupObject,
+	  SIGNAL(changed(void)),
+	  this,
+	  SLOT(slotCallsChanged(void)));
   connect(m_setupObject,
 	  SIGNAL(changed(void)),
 	  this,
@@ -85,8 +113,49 @@ glitch_view_arduino::~glitch_view_arduino()
 {
 }
 
+QHash<QString, int> glitch_view_arduino::calls(glitch_object *object) const
+{
+  if(!object)
+    return QHash<QString, int> ();
+
+  if(!object->editView())
+    return glitch_code_generator_arduino::calls(object->pendingChildren());
+
+  QHash<QString, int> calls;
+
+  for(auto child : object->editView()->objects())
+    {
+      auto function = qobject_cast<glitch_object_function_arduino *> (child);
+
+      if(function && !function->name().trimmed().isEmpty())
+	calls[function->name().trimmed()] += 1;
+    }
+
+  return calls;
+}
+
+QList<glitch_scene *> glitch_view_arduino::scenes(void) const
+{
+  /*
+  ** The canvas and the edit windows which have been opened.
+  */
+
+  QList<glitch_scene *> scenes;
+
+  scenes << m_scene;
+
+  for(int i = 0; i < scenes.size(); i++)
+    for(auto object : scenes.at(i)->objects())
+      if(object && object->editView() && object->editView()->scene())
+	scenes << object->editView()->scene();
+
+  return scenes;
+}
+
 QString glitch_view_arduino::nextUniqueFunctionName(void) const
 {
+  GLITCH_TRACE_SCOPE("glitch_view_arduino::nextUniqueFunctionName");
+
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
   QString name("function_0()");
@@ -102,6 +171,52 @@ QString glitch_view_arduino::nextUniqueFunctionName(void) const
   return name;
 }
 
+QString glitch_view_arduino::optimizedSource(QString &report) const
+{
+  glitch_optimizer_arduino optimizer;
+
+  for(auto object : m_scene->objects())
+    {
+      auto function = qobject_cast<glitch_object_function_arduino *> (object);
+
+      if(function && !function->isClone())
+	optimizer.addFunction
+	  (function->name().trimmed(),
+	   function->returnType(),
+	   function->statements());
+    }
+
+  optimizer.setLoop(m_loopObject->statements());
+  optimizer.setSetup(m_setupObject->statements());
+  optimizer.optimize();
+  report = optimizer.summary();
+  return optimizer.sketch();
+}
+
+QString glitch_view_arduino::source(void) const
+{
+  /*
+  ** Function definitions cache their generated bodies. Only
+  ** recently-modified functions are regenerated.
+  */
+
+  QMap<QString, QString> functions;
+
+  for(auto object : m_scene->objects())
+    {
+      auto function = qobject_cast<glitch_object_function_arduino *> (object);
+
+      if(function && !function->isClone())
+	functions[function->name()] = function->code();
+    }
+
+  return glitch_code_generator_arduino::sketch
+    (functions,
+     m_callGraph.order(),
+     m_setupObject->code(),
+     m_loopObject->code());
+}
+
 bool glitch_view_arduino::containsFunctionName(const QString &name) const
 {
   return m_functionNames.contains(name);
@@ -125,14 +240,17 @@ bool glitch_view_arduino::open(const QString &fileName, QString &error)
     if((ok = db.open()))
       {
 	QSqlQuery query(db);
+	glitch_style_sheet_pool styleSheets;
 
 	query.setForwardOnly(true);
+	styleSheets.load(db);
 
 	if(query.exec("SELECT stylesheet, type FROM objects WHERE "
 		      "type IN ('arduino-loop', 'arduino-setup')"))
 	  while(query.next())
 	    {
-	      QString styleSheet(query.value(0).toString().trimmed());
+	      QString styleSheet
+		(styleSheets.resolve(query.value(0).toString().trimmed()));
 	      QString type(query.value(1).toString().toLower().trimmed());
 
 	      if(type == "arduino-loop")
@@ -151,28 +269,226 @@ bool glitch_view_arduino::open(const QString &fileName, QString &error)
   }
 
   glitch_common::discardDatabase(connectionName);
+
+  /*
+  ** Prepare the call graph. Later changes are applied per body.
+  */
+
+  for(auto object : m_scene->objects())
+    {
+      auto function = qobject_cast<glitch_object_function_arduino *> (object);
+
+      if(function && !function->isClone())
+	updateCalls(function);
+    }
+
+  updateCalls(m_loopObject);
+  updateCalls(m_setupObject);
   return ok;
 }
 
+const glitch_cost_model_arduino &glitch_view_arduino::costModel(void) const
+{
+  return m_costModel;
+}
+
+const glitch_footprint_arduino &glitch_view_arduino::footprint(void) const
+{
+  return m_footprint;
+}
+
+glitch_call_graph glitch_view_arduino::callGraph(void) const
+{
+  return m_callGraph;
+}
+
+glitch_object *glitch_view_arduino::caller(const QString &name) const
+{
+  if(name == "loop()")
+    return m_loopObject;
+  else if(name == "setup()")
+    return m_setupObject;
+
+  for(auto object : m_scene->objects())
+    {
+      auto function = qobject_cast<glitch_object_function_arduino *> (object);
+
+      if(function && !function->isClone() && function->name() == name)
+	return function;
+    }
+
+  return nullptr;
+}
+
+glitch_object *glitch_view_arduino::mandatoryObject(const QString &type) const
+{
+  if(type == "arduino-loop")
+    return m_loopObject;
+  else if(type == "arduino-setup")
+    return m_setupObject;
+  else
+    return nullptr;
+}
+
 void glitch_view_arduino::consumeFunctionName(const QString &name)
 {
   if(!name.trimmed().isEmpty())
     m_functionNames[name] = '0';
 }
 
+void glitch_view_arduino::loadSimulator
+(glitch_simulator_arduino &simulator) const
+{
+  simulator.clear();
+
+  for(auto object : m_scene->objects())
+    {
+      auto function = qobject_cast<glitch_object_function_arduino *> (object);
+
+      if(function && !function->isClone())
+	simulator.addFunction
+	  (function->name().trimmed(),
+	   function->returnType(),
+	   function->statements(),
+	   static_cast<qint64> (function->id()));
+    }
+
+  simulator.setLoop(m_loopObject->statements());
+  simulator.setSetup(m_setupObject->statements());
+}
+
 void glitch_view_arduino::removeFunctionName(const QString &name)
 {
   m_functionNames.remove(name);
 }
 
+void glitch_view_arduino::renameFunction(const QString &before,
+					 const QString &after)
+{
+  if(after.isEmpty() || before.isEmpty() || before == after)
+    return;
+
+  /*
+  ** Bodies which have not been materialized hold their clones as
+  ** models.
+  */
+
+  for(const auto &name : m_callGraph.callers(before))
+    {
+      auto object = caller(name);
+
+      if(!object || object->editView())
+	continue;
+
+      auto children(object->pendingChildren());
+
+      for(auto &child : children)
+	if(child.type() == "arduino-function" &&
+	   child.property("name").toString().trimmed() == before)
+	  child.setProperty("name", after);
+
+      object->setPendingChildren(children);
+    }
+
+  m_callGraph.renameFunction(before, after);
+  m_costModel.renameFunction(before, after);
+  m_footprint.renameFunction(before, after);
+  updateFootprint();
+}
+
+void glitch_view_arduino::setHeat(const QHash<qint64, qreal> &heat)
+{
+  for(auto scene : scenes())
+    scene->setHeat(heat);
+}
+
+void glitch_view_arduino::showSimulation(void)
+{
+  if(!m_simulation)
+    m_simulation = new glitch_simulation_arduino(this);
+
+  m_simulation->setWindowTitle(tr("Glitch: Simulation (%1)").arg(name()));
+  m_simulation->showNormal();
+  m_simulation->activateWindow();
+  m_simulation->raise();
+}
+
+void glitch_view_arduino::slotCallsChanged(void)
+{
+  updateCalls(qobject_cast<glitch_object *> (sender()));
+}
+
 void glitch_view_arduino::slotFunctionAdded(const QString &name,
 					    const bool isClone)
 {
   if(!isClone)
-    consumeFunctionName(name);
+    {
+      consumeFunctionName(name);
+      m_callGraph.addFunction(name);
+    }
+}
+
+void glitch_view_arduino::slotFunctionChanged(glitch_object *object)
+{
+  updateCalls(object);
 }
 
 void glitch_view_arduino::slotFunctionDeleted(const QString &name)
 {
+  m_callGraph.removeFunction(name);
+  m_costModel.removeFunction(name);
+  m_footprint.removeFunction(name);
   removeFunctionName(name);
+  updateFootprint();
+}
+
+void glitch_view_arduino::slotUpdateFootprint(void)
+{
+  updateFootprint();
+}
+
+void glitch_view_arduino::updateCalls(glitch_object *object)
+{
+  if(!object)
+    return;
+
+  QString name("");
+
+  if(object == m_loopObject)
+    name = "loop()";
+  else if(object == m_setupObject)
+    name = "setup()";
+  else
+    name = object->name().trimmed();
+
+  if(name.isEmpty())
+    return;
+
+  auto cycle(m_callGraph.setCalls(name, calls(object)));
+
+  m_costModel.setStatements(name, object->statements());
+  m_footprint.setStatements
+    (name, static_cast<qint64> (object->id()), object->statements());
+  updateFootprint();
+
+  if(!cycle.isEmpty())
+    emit warning(tr("Warning: %1 is recursive (%2).").
+		 arg(cycle.first()).arg(cycle.join(" -> ")));
+}
+
+void glitch_view_arduino::updateFootprint(void)
+{
+  /*
+  ** Outline the objects which do not fit on the board.
+  */
+
+  auto overBudget
+    (m_footprint.overBudget(glitch_footprint_arduino::
+			    board(m_canvasSettings->board()),
+			    m_callGraph.order()));
+
+  for(auto scene : scenes())
+    scene->setOverBudget(overBudget);
+
+  m_canvasSettings->slotUpdateFootprint();
 }
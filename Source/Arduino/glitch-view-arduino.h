@@ -28,11 +28,16 @@
 #ifndef _glitch_view_arduino_h_
 #define _glitch_view_arduino_h_
 
+#include "glitch-call-graph.h"
+#include "glitch-cost-model-arduino.h"
+#include "glitch-footprint-arduino.h"
 #include "glitch-view.h"
 
 class glitch_alignment;
 class glitch_object_loop_arduino;
 class glitch_object_setup_arduino;
+class glitch_simulation_arduino;
+class glitch_simulator_arduino;
 
 class glitch_view_arduino: public glitch_view
 {
@@ -46,19 +51,41 @@ class glitch_view_arduino: public glitch_view
 		      QWidget *parent);
   ~glitch_view_arduino();
   QString nextUniqueFunctionName(void) const;
+  QString optimizedSource(QString &report) const;
+  QString source(void) const;
   bool containsFunctionName(const QString &name) const;
   bool open(const QString &fileName, QString &error);
+  const glitch_cost_model_arduino &costModel(void) const;
+  const glitch_footprint_arduino &footprint(void) const;
+  glitch_call_graph callGraph(void) const;
   void consumeFunctionName(const QString &name);
+  void loadSimulator(glitch_simulator_arduino &simulator) const;
   void removeFunctionName(const QString &name);
+  void renameFunction(const QString &before, const QString &after);
+  void setHeat(const QHash<qint64, qreal> &heat);
+  void showSimulation(void);
 
  private:
   QMap<QString, char> m_functionNames;
+  QPointer<glitch_simulation_arduino> m_simulation;
+  glitch_call_graph m_callGraph;
+  glitch_cost_model_arduino m_costModel;
+  glitch_footprint_arduino m_footprint;
   glitch_object_loop_arduino *m_loopObject;
   glitch_object_setup_arduino *m_setupObject;
+  QHash<QString, int> calls(glitch_object *object) const;
+  QList<glitch_scene *> scenes(void) const;
+  glitch_object *caller(const QString &name) const;
+  glitch_object *mandatoryObject(const QString &type) const;
+  void updateCalls(glitch_object *object);
+  void updateFootprint(void);
 
  private slots:
+  void slotCallsChanged(void);
   void slotFunctionAdded(const QString &name, const bool isClone);
+  void slotFunctionChanged(glitch_object *object);
   void slotFunctionDeleted(const QString &name);
+  void slotUpdateFootprint(void);
 };
 
 #endif
@@ -37,10 +37,6 @@ class glitch_alignment: public QDialog
   Q_OBJECT
 
  public:
-  glitch_alignment(QWidget *parent);
-  ~glitch_alignment();
-
- private:
   enum AlignmentType
   {
     ALIGN_BOTTOM = 0,
@@ -57,10 +53,14 @@ class glitch_alignment: public QDialog
     VERTICAL_STACK
   };
 
-  Ui_glitch_alignment m_ui;
+  glitch_alignment(QWidget *parent);
+  ~glitch_alignment();
   void align(const AlignmentType alignmentType);
   void stack(const StackType stackType);
 
+ private:
+  Ui_glitch_alignment m_ui;
+
  private slots:
   void slotAlign(void);
   void slotStack(void);
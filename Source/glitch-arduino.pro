@@ -2,12 +2,14 @@ FORMS          += UI/Arduino/glitch-object-analog-read-arduino.ui \
                   UI/Arduino/glitch-object-function-arduino.ui \
                   UI/Arduino/glitch-object-logical-operator-arduino.ui \
 		  UI/Arduino/glitch-object-loop-arduino.ui \
-                  UI/Arduino/glitch-object-setup-arduino.ui
+                  UI/Arduino/glitch-object-setup-arduino.ui \
+                  UI/Arduino/glitch-simulation-arduino.ui
 HEADERS	       += Source/Arduino/glitch-object-analog-read-arduino.h \
                   Source/Arduino/glitch-object-function-arduino.h \
                   Source/Arduino/glitch-object-logical-operator-arduino.h \
 		  Source/Arduino/glitch-object-loop-arduino.h \
 		  Source/Arduino/glitch-object-setup-arduino.h \
+                  Source/Arduino/glitch-simulation-arduino.h \
                   Source/Arduino/glitch-structures-arduino.h \
 		  Source/Arduino/glitch-view-arduino.h
 SOURCES	       += Source/Arduino/glitch-object-analog-read-arduino.cc \
@@ -15,5 +17,6 @@ SOURCES	       += Source/Arduino/glitch-object-analog-read-arduino.cc \
                   Source/Arduino/glitch-object-logical-operator-arduino.cc \
 		  Source/Arduino/glitch-object-loop-arduino.cc \
 		  Source/Arduino/glitch-object-setup-arduino.cc \
+                  Source/Arduino/glitch-simulation-arduino.cc \
                   Source/Arduino/glitch-structures-arduino.cc \
 		  Source/Arduino/glitch-view-arduino.cc
@@ -0,0 +1,178 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <iostream>
+
+#include "Arduino/glitch-code-generator-arduino.h"
+#include "glitch-batch-export.h"
+#include "glitch-diagram.h"
+#include "glitch-trace.h"
+
+static QMutex s_outputMutex;
+
+glitch_batch_export::Result glitch_batch_export::exportDiagram
+(const QString &fileName)
+{
+  GLITCH_TRACE_SCOPE("glitch_batch_export::exportDiagram");
+
+  QElapsedTimer timer;
+  Result result;
+
+  result.bytes = 0;
+  result.elapsed = 0;
+  result.fileName = fileName;
+  timer.start();
+
+  QString source(glitch_batch_export::source(fileName, result.error));
+
+  if(result.error.isEmpty())
+    {
+      QFileInfo fileInfo(fileName);
+      QSaveFile file
+	(fileInfo.absolutePath() +
+	 QDir::separator() +
+	 fileInfo.completeBaseName() +
+	 ".ino");
+
+      /*
+      ** The sketch replaces the previous sketch only if it was
+      ** written completely.
+      */
+
+      if(file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+	{
+	  QByteArray bytes(source.toUtf8());
+
+	  if(file.write(bytes) == static_cast<qint64> (bytes.length()) &&
+	     file.commit())
+	    result.bytes = static_cast<qint64> (bytes.length());
+	  else
+	    result.error = file.errorString();
+	}
+      else
+	result.error = file.errorString();
+    }
+
+  result.elapsed = timer.elapsed();
+
+  QMutexLocker locker(&s_outputMutex);
+
+  if(result.error.isEmpty())
+    std::cout << fileName.toStdString()
+	      << ": "
+	      << result.bytes
+	      << " bytes, "
+	      << result.elapsed
+	      << " ms."
+	      << std::endl;
+  else
+    std::cerr << fileName.toStdString()
+	      << ": "
+	      << result.error.toStdString()
+	      << std::endl;
+
+  return result;
+}
+
+QString glitch_batch_export::source(const QString &fileName, QString &error)
+{
+  glitch_diagram diagram;
+
+  if(!diagram.load(fileName, error))
+    return "";
+
+  if(diagram.type() != "ArduinoProject")
+    {
+      error = QObject::tr("Expecting a diagram type of ArduinoProject.");
+      return "";
+    }
+
+  return glitch_code_generator_arduino::sketch(diagram);
+}
+
+int glitch_batch_export::exec(const QString &directory)
+{
+  QDir dir(directory);
+
+  if(!dir.exists())
+    {
+      std::cerr << "The directory " << directory.toStdString()
+		<< " does not exist." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  QStringList fileNames;
+
+  for(const auto &fileInfo : dir.entryInfoList(QStringList() << "*.db",
+					       QDir::Files | QDir::Readable,
+					       QDir::Name))
+    fileNames << fileInfo.absoluteFilePath();
+
+  /*
+  ** Each diagram is exported on a worker thread through a private
+  ** SQLite connection.
+  */
+
+  QElapsedTimer timer;
+
+  timer.start();
+
+  auto results = QtConcurrent::blockingMapped<QList<Result> >
+    (fileNames, &glitch_batch_export::exportDiagram);
+  int failures = 0;
+  qint64 bytes = 0;
+  qint64 elapsed = qMax(static_cast<qint64> (1), timer.elapsed());
+
+  for(const auto &result : results)
+    if(result.error.isEmpty())
+      bytes += result.bytes;
+    else
+      failures += 1;
+
+  std::cout << results.size() - failures
+	    << " of "
+	    << results.size()
+	    << " diagram(s) exported by "
+	    << QThreadPool::globalInstance()->maxThreadCount()
+	    << " thread(s) in "
+	    << elapsed
+	    << " ms ("
+	    << 1000.0 * results.size() / static_cast<double> (elapsed)
+	    << " diagram(s) / s, "
+	    << static_cast<double> (bytes) / static_cast<double> (elapsed)
+	    << " KB / s)."
+	    << std::endl;
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,584 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QQueue>
+#include <QStack>
+
+#include <algorithm>
+
+#include "glitch-call-graph.h"
+
+/*
+** Functions are vertices. A clone of a function placed in the body
+** of another function, loop(), or setup() is a call. Edges are counted
+** so that removing one of several identical clones preserves the call.
+**
+** A topological order of the edges is maintained incrementally after
+** Pearce and Kelly, "A Dynamic Topological Sort Algorithm for Directed
+** Acyclic Graphs". Inserting an edge only visits the vertices between
+** its endpoints in the order. An edge which would close a cycle is kept
+** as a back edge outside of the order; back edges describe recursion.
+** Removing an ordered edge never invalidates the order, although it may
+** allow back edges to be ordered.
+*/
+
+glitch_call_graph::glitch_call_graph(void)
+{
+}
+
+glitch_call_graph::~glitch_call_graph()
+{
+}
+
+QHash<QString, int> glitch_call_graph::calls(const QString &caller) const
+{
+  QHash<QString, int> calls;
+
+  if(!m_vertices.contains(caller))
+    return calls;
+
+  QHashIterator<int, int> it(m_successors.at(m_vertices.value(caller)));
+
+  while(it.hasNext())
+    {
+      it.next();
+      calls[m_names.at(it.key())] = it.value();
+    }
+
+  return calls;
+}
+
+QList<int> glitch_call_graph::path(const int from, const int to) const
+{
+  /*
+  ** A shortest path of at least one edge from from to to.
+  */
+
+  QHash<int, int> parents;
+  QQueue<int> queue;
+
+  queue.enqueue(from);
+
+  while(!queue.isEmpty())
+    {
+      auto v = queue.dequeue();
+
+      for(auto w : m_successors.at(v).keys())
+	{
+	  if(parents.contains(w))
+	    continue;
+
+	  parents[w] = v;
+
+	  if(w == to)
+	    {
+	      QList<int> list;
+
+	      list.prepend(w);
+
+	      do
+		{
+		  w = parents.value(w);
+		  list.prepend(w);
+		}
+	      while(w != from);
+
+	      return list;
+	    }
+
+	  queue.enqueue(w);
+	}
+    }
+
+  return QList<int> ();
+}
+
+QSet<int> glitch_call_graph::reachable
+(const QList<int> &vertices, const bool forward) const
+{
+  QSet<int> set;
+  QStack<int> stack;
+
+  for(auto v : vertices)
+    {
+      set.insert(v);
+      stack.push(v);
+    }
+
+  while(!stack.isEmpty())
+    {
+      auto v = stack.pop();
+
+      for(auto w : forward ? m_successors.at(v).keys() :
+	    m_predecessors.at(v).keys())
+	if(!set.contains(w))
+	  {
+	    set.insert(w);
+	    stack.push(w);
+	  }
+    }
+
+  return set;
+}
+
+QStringList glitch_call_graph::addEdge
+(const int x, const int y, const int count)
+{
+  /*
+  ** Returns the cycle closed by the edge, if any.
+  */
+
+  if(count <= 0)
+    return QStringList();
+
+  if(m_successors.at(x).contains(y))
+    {
+      m_predecessors[y][x] += count;
+      m_successors[x][y] += count;
+      return QStringList();
+    }
+
+  m_predecessors[y][x] = count;
+  m_successors[x][y] = count;
+
+  if(insertEdge(x, y))
+    return QStringList();
+
+  m_backEdges.insert(qMakePair(x, y));
+
+  auto list(x == y ? QList<int> () << y : path(y, x));
+
+  list.prepend(x);
+  return names(list);
+}
+
+QStringList glitch_call_graph::callees(const QString &name) const
+{
+  QStringList list;
+
+  if(m_vertices.contains(name))
+    list = names(m_successors.at(m_vertices.value(name)).keys());
+
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+QStringList glitch_call_graph::callers(const QString &name) const
+{
+  QStringList list;
+
+  if(m_vertices.contains(name))
+    list = names(m_predecessors.at(m_vertices.value(name)).keys());
+
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+QStringList glitch_call_graph::cycle(const QString &name) const
+{
+  /*
+  ** A shortest call path from name back to name.
+  */
+
+  if(!m_vertices.contains(name))
+    return QStringList();
+
+  auto v = m_vertices.value(name);
+
+  return names(path(v, v));
+}
+
+QStringList glitch_call_graph::deadFunctions(void) const
+{
+  /*
+  ** Functions which are not reachable from loop() or setup().
+  */
+
+  QList<int> roots;
+
+  for(const auto &root : m_roots)
+    roots << m_vertices.value(root);
+
+  auto set(reachable(roots, true));
+  QStringList list;
+
+  for(const auto &function : m_functions)
+    if(!set.contains(m_vertices.value(function)))
+      list << function;
+
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+QStringList glitch_call_graph::functions(void) const
+{
+  QStringList list(m_functions.values());
+
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+QStringList glitch_call_graph::names(const QList<int> &vertices) const
+{
+  QStringList list;
+
+  for(auto v : vertices)
+    list << m_names.at(v);
+
+  return list;
+}
+
+QStringList glitch_call_graph::order(void) const
+{
+  /*
+  ** Functions ordered such that callees precede their callers. Calls
+  ** which are part of recursion are not considered.
+  */
+
+  QList<QPair<int, QString> > list;
+
+  for(const auto &function : m_functions)
+    list << qMakePair(-m_order.at(m_vertices.value(function)), function);
+
+  std::sort(list.begin(), list.end());
+
+  QStringList order;
+
+  for(const auto &pair : list)
+    order << pair.second;
+
+  return order;
+}
+
+QStringList glitch_call_graph::recursiveFunctions(void) const
+{
+  /*
+  ** Every cycle contains a back edge x -> y. The cycle's functions
+  ** are reachable from y and reach x.
+  */
+
+  QSet<int> set;
+
+  for(const auto &edge : m_backEdges)
+    set.unite
+      (reachable(QList<int> () << edge.second, true).
+       intersect(reachable(QList<int> () << edge.first, false)));
+
+  QStringList list;
+
+  for(auto v : set)
+    if(m_functions.contains(m_names.at(v)) || m_roots.contains(m_names.at(v)))
+      list << m_names.at(v);
+
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+QStringList glitch_call_graph::setCalls
+(const QString &caller, const QHash<QString, int> &calls)
+{
+  /*
+  ** Replaces the calls of caller. Only the differences are applied.
+  ** Returns a cycle introduced by the new calls, if any.
+  */
+
+  auto x = vertex(caller);
+  auto previous(m_successors.at(x));
+  QHashIterator<QString, int> it(calls);
+  QStringList cycle;
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      auto y = vertex(it.key());
+      auto count = previous.take(y);
+
+      if(count > it.value())
+	removeEdge(x, y, count - it.value());
+      else
+	{
+	  auto list(addEdge(x, y, it.value() - count));
+
+	  if(cycle.isEmpty())
+	    cycle = list;
+	}
+    }
+
+  QHashIterator<int, int> i(previous);
+
+  while(i.hasNext())
+    {
+      i.next();
+      removeEdge(x, i.key(), i.value());
+    }
+
+  return cycle;
+}
+
+bool glitch_call_graph::contains(const QString &name) const
+{
+  return m_functions.contains(name) || m_roots.contains(name);
+}
+
+bool glitch_call_graph::insertEdge(const int x, const int y)
+{
+  /*
+  ** Orders the edge x -> y. Returns false if the edge closes a cycle.
+  */
+
+  if(x == y)
+    return false;
+
+  auto lb = m_order.at(y);
+  auto ub = m_order.at(x);
+
+  if(lb > ub)
+    return true;
+
+  /*
+  ** Discover the vertices reachable from y which precede x and the
+  ** vertices reaching x which follow y.
+  */
+
+  QList<int> backward;
+  QList<int> forward;
+  QSet<int> visited;
+  QStack<int> stack;
+
+  stack.push(y);
+  visited.insert(y);
+
+  while(!stack.isEmpty())
+    {
+      auto v = stack.pop();
+
+      forward << v;
+
+      for(auto w : m_successors.at(v).keys())
+	{
+	  if(m_backEdges.contains(qMakePair(v, w)) || (v == x && w == y))
+	    continue;
+
+	  if(w == x)
+	    return false;
+
+	  if(m_order.at(w) < ub && !visited.contains(w))
+	    {
+	      stack.push(w);
+	      visited.insert(w);
+	    }
+	}
+    }
+
+  stack.push(x);
+  visited.insert(x);
+
+  while(!stack.isEmpty())
+    {
+      auto v = stack.pop();
+
+      backward << v;
+
+      for(auto w : m_predecessors.at(v).keys())
+	{
+	  if(m_backEdges.contains(qMakePair(w, v)) || (w == x && v == y))
+	    continue;
+
+	  if(lb < m_order.at(w) && !visited.contains(w))
+	    {
+	      stack.push(w);
+	      visited.insert(w);
+	    }
+	}
+    }
+
+  /*
+  ** The backward vertices are placed before the forward vertices
+  ** using the positions which both sets occupied.
+  */
+
+  auto lessThan = [this] (const int a, const int b)
+		  {
+		    return m_order.at(a) < m_order.at(b);
+		  };
+
+  std::sort(backward.begin(), backward.end(), lessThan);
+  std::sort(forward.begin(), forward.end(), lessThan);
+
+  QList<int> positions;
+  auto vertices(backward + forward);
+
+  for(auto v : vertices)
+    positions << m_order.at(v);
+
+  std::sort(positions.begin(), positions.end());
+
+  for(int i = 0; i < vertices.size(); i++)
+    m_order[vertices.at(i)] = positions.at(i);
+
+  return true;
+}
+
+bool glitch_call_graph::isRecursive(const QString &name) const
+{
+  return !cycle(name).isEmpty();
+}
+
+int glitch_call_graph::vertex(const QString &name)
+{
+  if(m_vertices.contains(name))
+    return m_vertices.value(name);
+
+  auto v = m_names.size();
+
+  m_names << name;
+  m_order << v;
+  m_predecessors << QHash<int, int> ();
+  m_successors << QHash<int, int> ();
+  m_vertices[name] = v;
+  return v;
+}
+
+void glitch_call_graph::addFunction(const QString &name)
+{
+  if(name.trimmed().isEmpty())
+    return;
+
+  m_functions.insert(name);
+  vertex(name);
+}
+
+void glitch_call_graph::addRoot(const QString &name)
+{
+  if(name.trimmed().isEmpty())
+    return;
+
+  m_roots.insert(name);
+  vertex(name);
+}
+
+void glitch_call_graph::clear(void)
+{
+  m_backEdges.clear();
+  m_functions.clear();
+  m_names.clear();
+  m_order.clear();
+  m_predecessors.clear();
+  m_roots.clear();
+  m_successors.clear();
+  m_vertices.clear();
+}
+
+void glitch_call_graph::removeEdge(const int x, const int y, const int count)
+{
+  if(count <= 0 || !m_successors.at(x).contains(y))
+    return;
+
+  if(m_successors.at(x).value(y) > count)
+    {
+      m_predecessors[y][x] -= count;
+      m_successors[x][y] -= count;
+      return;
+    }
+
+  m_predecessors[y].remove(x);
+  m_successors[x].remove(y);
+
+  if(m_backEdges.remove(qMakePair(x, y)))
+    return;
+
+  /*
+  ** The removed edge may have been the only path which prevented
+  ** a back edge from being ordered.
+  */
+
+  for(const auto &edge : m_backEdges.values())
+    if(insertEdge(edge.first, edge.second))
+      m_backEdges.remove(edge);
+}
+
+void glitch_call_graph::removeFunction(const QString &name)
+{
+  /*
+  ** The function's calls are retained so that restoring the function
+  ** restores its calls. Its callers are removed with its clones.
+  */
+
+  m_functions.remove(name);
+}
+
+void glitch_call_graph::renameFunction(const QString &before,
+				       const QString &after)
+{
+  if(after.trimmed().isEmpty() || before == after)
+    return;
+
+  if(m_functions.remove(before))
+    m_functions.insert(after);
+
+  if(m_roots.remove(before))
+    m_roots.insert(after);
+
+  if(!m_vertices.contains(before))
+    return;
+
+  auto x = m_vertices.take(before);
+
+  if(!m_vertices.contains(after))
+    {
+      m_names[x] = after;
+      m_vertices[after] = x;
+      return;
+    }
+
+  /*
+  ** A vertex named after exists. Its calls and callers are merged
+  ** with the calls and callers of before.
+  */
+
+  auto y = m_vertices.value(after);
+  QHashIterator<int, int> it(m_successors.at(x));
+
+  while(it.hasNext())
+    {
+      it.next();
+      removeEdge(x, it.key(), it.value());
+      addEdge(y, it.key() == x ? y : it.key(), it.value());
+    }
+
+  it = QHashIterator<int, int> (m_predecessors.at(x));
+
+  while(it.hasNext())
+    {
+      it.next();
+      removeEdge(it.key(), x, it.value());
+      addEdge(it.key(), y, it.value());
+    }
+
+  m_names[x] = "";
+}
@@ -0,0 +1,78 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_call_graph_h_
+#define _glitch_call_graph_h_
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+class glitch_call_graph
+{
+ public:
+  glitch_call_graph(void);
+  ~glitch_call_graph();
+  QHash<QString, int> calls(const QString &caller) const;
+  QStringList callees(const QString &name) const;
+  QStringList callers(const QString &name) const;
+  QStringList cycle(const QString &name) const;
+  QStringList deadFunctions(void) const;
+  QStringList functions(void) const;
+  QStringList order(void) const;
+  QStringList recursiveFunctions(void) const;
+  QStringList setCalls(const QString &caller,
+		       const QHash<QString, int> &calls);
+  bool contains(const QString &name) const;
+  bool isRecursive(const QString &name) const;
+  void addFunction(const QString &name);
+  void addRoot(const QString &name);
+  void clear(void);
+  void removeFunction(const QString &name);
+  void renameFunction(const QString &before, const QString &after);
+
+ private:
+  QHash<QString, int> m_vertices;
+  QSet<QPair<int, int> > m_backEdges;
+  QSet<QString> m_functions;
+  QSet<QString> m_roots;
+  QVector<QHash<int, int> > m_predecessors;
+  QVector<QHash<int, int> > m_successors;
+  QVector<QString> m_names;
+  QVector<int> m_order;
+  QList<int> path(const int from, const int to) const;
+  QSet<int> reachable(const QList<int> &vertices, const bool forward) const;
+  QStringList addEdge(const int x, const int y, const int count);
+  QStringList names(const QList<int> &vertices) const;
+  bool insertEdge(const int x, const int y);
+  int vertex(const QString &name);
+  void removeEdge(const int x, const int y, const int count);
+};
+
+#endif
@@ -33,6 +33,8 @@
 #include <QSqlError>
 #include <QSqlQuery>
 
+#include "Arduino/glitch-footprint-arduino.h"
+#include "Arduino/glitch-structures-arduino.h"
 #include "glitch-canvas-settings.h"
 #include "glitch-common.h"
 #include "glitch-misc.h"
@@ -41,11 +43,27 @@
 glitch_canvas_settings::glitch_canvas_settings(QWidget *parent):
   QDialog(parent)
 {
+  m_footprint = nullptr;
   m_ui.setupUi(this);
   m_ui.background_color->setStyleSheet
     (QString("QPushButton {background-color: %1}").
      arg(QColor(211, 211, 211).name()));
   m_ui.background_color->setText(QColor(211, 211, 211).name());
+  m_ui.themes->setRowCount(glitch_structures_arduino::objectTypes().size());
+
+  for(int i = 0; i < m_ui.themes->rowCount(); i++)
+    {
+      auto item = new QTableWidgetItem
+	(glitch_structures_arduino::objectTypes().at(i));
+
+      item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+      m_ui.themes->setItem(i, 0, item);
+      m_ui.themes->setItem(i, 1, new QTableWidgetItem(""));
+    }
+
+  m_ui.themes->resizeColumnToContents(0);
+  m_ui.board->addItems(glitch_footprint_arduino::boards());
+  setBoard("Uno");
   new QShortcut(tr("Ctrl+W"),
 		this,
 		SLOT(close(void)));
@@ -53,6 +71,10 @@ glitch_canvas_settings::glitch_canvas_settings(QWidget *parent):
 	  SIGNAL(clicked(void)),
 	  this,
 	  SLOT(slotSelectBackgroundColor(void)));
+  connect(m_ui.board,
+	  SIGNAL(currentIndexChanged(int)),
+	  this,
+	  SLOT(slotUpdateFootprint(void)));
   connect(m_ui.buttonBox->button(QDialogButtonBox::Apply),
 	  SIGNAL(clicked(void)),
 	  this,
@@ -92,13 +114,53 @@ settings(void) const
 {
   QHash<Settings, QVariant> hash;
 
+  hash[BOARD] = board();
   hash[CANVAS_BACKGROUND_COLOR] = canvasBackgroundColor().name();
   hash[CANVAS_NAME] = name();
   hash[REDO_UNDO_STACK_SIZE] = redoUndoStackSize();
+
+  QMapIterator<QString, QString> it(themes());
+  QVariantMap map;
+
+  while(it.hasNext())
+    {
+      it.next();
+      map[it.key()] = it.value();
+    }
+
+  hash[THEMES] = map;
   hash[VIEW_UPDATE_MODE] = viewportUpdateMode();
   return hash;
 }
 
+QMap<QString, QString> glitch_canvas_settings::themes(void) const
+{
+  /*
+  ** Object types and their style sheets. Types without style sheets
+  ** are excluded.
+  */
+
+  QMap<QString, QString> map;
+
+  for(int i = 0; i < m_ui.themes->rowCount(); i++)
+    {
+      auto item1 = m_ui.themes->item(i, 0);
+      auto item2 = m_ui.themes->item(i, 1);
+
+      if(!item1 || !item2 || item2->text().trimmed().isEmpty())
+	continue;
+
+      map[item1->text()] = item2->text().trimmed();
+    }
+
+  return map;
+}
+
+QString glitch_canvas_settings::board(void) const
+{
+  return m_ui.board->currentText();
+}
+
 QString glitch_canvas_settings::defaultName(void) const
 {
   if(m_ui.project_type->currentText() == tr("Arduino"))
@@ -132,6 +194,7 @@ bool glitch_canvas_settings::save(QString &error) const
 	query.exec
 	  ("CREATE TABLE IF NOT EXISTS canvas_settings ("
 	   "background_color TEXT NOT NULL, "
+	   "board TEXT NOT NULL DEFAULT 'Uno', "
 	   "name TEXT NOT NULL PRIMARY KEY, "
 	   "project_type TEXT NOT NULL CHECK "
 	   "(project_type IN ('Arduino')), "
@@ -141,6 +204,13 @@ bool glitch_canvas_settings::save(QString &error) const
 	   "'smart'))"
 	   ")");
 
+	/*
+	** Older diagrams do not have boards.
+	*/
+
+	query.exec("ALTER TABLE canvas_settings ADD "
+		   "board TEXT NOT NULL DEFAULT 'Uno'");
+
 	if(!(ok = query.exec("DELETE FROM canvas_settings")))
 	  {
 	    error = query.lastError().text();
@@ -150,12 +220,14 @@ bool glitch_canvas_settings::save(QString &error) const
 	query.prepare
 	  ("INSERT OR REPLACE INTO canvas_settings "
 	   "(background_color, "
+	   "board, "
 	   "name, "
 	   "project_type, "
 	   "redo_undo_stack_size, "
 	   "update_mode) "
-	   "VALUES (?, ?, ?, ?, ?)");
+	   "VALUES (?, ?, ?, ?, ?, ?)");
 	query.addBindValue(m_ui.background_color->text());
+	query.addBindValue(m_ui.board->currentText());
 
 	QString name(m_ui.name->text().trimmed());
 
@@ -169,7 +241,37 @@ bool glitch_canvas_settings::save(QString &error) const
 	  (m_ui.update_mode->currentText().toLower().replace(' ', '_'));
 
 	if(!(ok = query.exec()))
-	  error = query.lastError().text();
+	  {
+	    error = query.lastError().text();
+	    goto done_label;
+	  }
+
+	query.exec("CREATE TABLE IF NOT EXISTS canvas_themes ("
+		   "stylesheet TEXT NOT NULL, "
+		   "type TEXT NOT NULL PRIMARY KEY)");
+
+	if(!(ok = query.exec("DELETE FROM canvas_themes")))
+	  {
+	    error = query.lastError().text();
+	    goto done_label;
+	  }
+
+	QMapIterator<QString, QString> it(themes());
+
+	while(it.hasNext())
+	  {
+	    it.next();
+	    query.prepare("INSERT INTO canvas_themes (stylesheet, type) "
+			  "VALUES (?, ?)");
+	    query.addBindValue(it.value());
+	    query.addBindValue(it.key());
+
+	    if(!(ok = query.exec()))
+	      {
+		error = query.lastError().text();
+		break;
+	      }
+	  }
       }
     else
       error = db.lastError().text();
@@ -257,6 +359,29 @@ void glitch_canvas_settings::prepare(void)
 	    if(m_ui.update_mode->currentIndex() < 0)
 	      m_ui.update_mode->setCurrentIndex(1); // Full
 
+	    /*
+	    ** Older diagrams do not have themes.
+	    */
+
+	    QMap<QString, QString> themes;
+
+	    if(query.exec("SELECT stylesheet, type FROM canvas_themes"))
+	      while(query.next())
+		themes[query.value(1).toString().trimmed()] =
+		  query.value(0).toString().trimmed();
+
+	    setThemes(themes);
+
+	    /*
+	    ** Older diagrams do not have boards.
+	    */
+
+	    if(query.exec("SELECT board FROM canvas_settings") &&
+	       query.next())
+	      setBoard(query.value(0).toString().trimmed());
+	    else
+	      setBoard("Uno");
+
 	    setResult(QDialog::Accepted);
 	    emit accepted(false);
 	  }
@@ -269,11 +394,26 @@ void glitch_canvas_settings::prepare(void)
   QApplication::restoreOverrideCursor();
 }
 
+void glitch_canvas_settings::setBoard(const QString &board)
+{
+  m_ui.board->setCurrentIndex(m_ui.board->findText(board));
+
+  if(m_ui.board->currentIndex() < 0)
+    m_ui.board->setCurrentIndex(m_ui.board->findText("Uno"));
+}
+
 void glitch_canvas_settings::setFileName(const QString &fileName)
 {
   m_fileName = fileName;
 }
 
+void glitch_canvas_settings::setFootprint
+(const glitch_footprint_arduino *footprint)
+{
+  m_footprint = footprint;
+  slotUpdateFootprint();
+}
+
 void glitch_canvas_settings::setName(const QString &name)
 {
   if(name.trimmed().isEmpty())
@@ -292,16 +432,41 @@ void glitch_canvas_settings::setSettings
 {
   QColor color(hash.value(CANVAS_BACKGROUND_COLOR).toString());
 
+  setBoard(hash.value(BOARD).toString());
+
   m_ui.background_color->setStyleSheet
     (QString("QPushButton {background-color: %1}").arg(color.name()));
   m_ui.background_color->setText(color.name());
   setName(hash.value(CANVAS_NAME).toString());
+
+  QMapIterator<QString, QVariant> it(hash.value(THEMES).toMap());
+  QMap<QString, QString> themes;
+
+  while(it.hasNext())
+    {
+      it.next();
+      themes[it.key()] = it.value().toString();
+    }
+
+  setThemes(themes);
   setResult(QDialog::Accepted);
   setViewportUpdateMode
     (QGraphicsView::ViewportUpdateMode(hash.value(VIEW_UPDATE_MODE).toInt()));
   emit accepted(false);
 }
 
+void glitch_canvas_settings::setThemes(const QMap<QString, QString> &themes)
+{
+  for(int i = 0; i < m_ui.themes->rowCount(); i++)
+    {
+      auto item1 = m_ui.themes->item(i, 0);
+      auto item2 = m_ui.themes->item(i, 1);
+
+      if(item1 && item2)
+	item2->setText(themes.value(item1->text()));
+    }
+}
+
 void glitch_canvas_settings::setViewportUpdateMode
 (const QGraphicsView::ViewportUpdateMode mode)
 {
@@ -340,6 +505,12 @@ void glitch_canvas_settings::setViewportUpdateMode
     m_ui.update_mode->setCurrentIndex(1); // Full.
 }
 
+void glitch_canvas_settings::showEvent(QShowEvent *event)
+{
+  QDialog::showEvent(event);
+  slotUpdateFootprint();
+}
+
 void glitch_canvas_settings::slotSelectBackgroundColor(void)
 {
   QColorDialog dialog(this);
@@ -358,3 +529,71 @@ void glitch_canvas_settings::slotSelectBackgroundColor(void)
       m_ui.background_color->setText(color.name());
     }
 }
+
+void glitch_canvas_settings::slotUpdateFootprint(void)
+{
+  if(!isVisible())
+    return;
+
+  m_ui.footprint->setRowCount(0);
+  m_ui.footprint->setSortingEnabled(false);
+
+  if(!m_footprint)
+    {
+      m_ui.footprint_totals->clear();
+      return;
+    }
+
+  auto board(glitch_footprint_arduino::board(m_ui.board->currentText()));
+  auto total(m_footprint->total());
+
+  m_ui.footprint_totals->setText
+    (tr("Flash: %1 of %2 bytes (%3%). SRAM: %4 of %5 bytes (%6%).").
+     arg(total.flash).
+     arg(board.flash).
+     arg(100.0 * static_cast<double> (total.flash) /
+	 static_cast<double> (qMax(static_cast<qint64> (1), board.flash)),
+	 0, 'f', 1).
+     arg(total.sram).
+     arg(board.sram).
+     arg(100.0 * static_cast<double> (total.sram) /
+	 static_cast<double> (qMax(static_cast<qint64> (1), board.sram)),
+	 0, 'f', 1));
+
+  QList<QPair<QString, QMap<QString, glitch_footprint_arduino::Footprint> > >
+    list;
+
+  list << qMakePair(tr("Function"), m_footprint->functions());
+  list << qMakePair(tr("Type"), m_footprint->types());
+
+  for(int i = 0; i < list.size(); i++)
+    {
+      QMapIterator<QString, glitch_footprint_arduino::Footprint> it
+	(list.at(i).second);
+
+      while(it.hasNext())
+	{
+	  it.next();
+
+	  auto row = m_ui.footprint->rowCount();
+
+	  m_ui.footprint->setRowCount(row + 1);
+	  m_ui.footprint->setItem
+	    (row, 0, new QTableWidgetItem(list.at(i).first));
+	  m_ui.footprint->setItem(row, 1, new QTableWidgetItem(it.key()));
+
+	  for(int j = 2; j < 4; j++)
+	    {
+	      auto item = new QTableWidgetItem();
+
+	      item->setData
+		(Qt::DisplayRole, j == 2 ? it.value().flash : it.value().sram);
+	      item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+	      m_ui.footprint->setItem(row, j, item);
+	    }
+	}
+    }
+
+  m_ui.footprint->setSortingEnabled(true);
+  m_ui.footprint->resizeColumnsToContents();
+}
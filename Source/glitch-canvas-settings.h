@@ -33,6 +33,8 @@
 
 #include "ui_glitch-canvas-settings.h"
 
+class glitch_footprint_arduino;
+
 class glitch_canvas_settings: public QDialog
 {
   Q_OBJECT
@@ -40,9 +42,11 @@ class glitch_canvas_settings: public QDialog
  public:
   enum Settings
   {
+    BOARD,
     CANVAS_BACKGROUND_COLOR,
     CANVAS_NAME,
     REDO_UNDO_STACK_SIZE,
+    THEMES,
     VIEW_UPDATE_MODE
   };
 
@@ -51,21 +55,31 @@ class glitch_canvas_settings: public QDialog
   QColor canvasBackgroundColor(void) const;
   QGraphicsView::ViewportUpdateMode viewportUpdateMode(void) const;
   QHash<glitch_canvas_settings::Settings, QVariant> settings(void) const;
+  QMap<QString, QString> themes(void) const;
+  QString board(void) const;
   QString name(void) const;
   bool save(QString &error) const;
   int redoUndoStackSize(void) const;
   void prepare(void);
+  void setBoard(const QString &board);
   void setFileName(const QString &fileName);
+  void setFootprint(const glitch_footprint_arduino *footprint);
   void setName(const QString &name);
   void setRedoUndoStackSize(const int value);
   void setSettings
     (const QHash<glitch_canvas_settings::Settings, QVariant> &hash);
+  void setThemes(const QMap<QString, QString> &themes);
   void setViewportUpdateMode(const QGraphicsView::ViewportUpdateMode mode);
 
  private:
   QString m_fileName;
   Ui_glitch_canvas_settings m_ui;
+  const glitch_footprint_arduino *m_footprint;
   QString defaultName(void) const;
+  void showEvent(QShowEvent *event);
+
+ public slots:
+  void slotUpdateFootprint(void);
 
  private slots:
   void accept(void);
@@ -25,18 +25,26 @@
 ** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <QObject>
+
 #include "glitch-common.h"
-#include "glitch-misc.h"
+#include "glitch-trace.h"
 
-quint64 glitch_common::s_dbId = 0;
+QAtomicInteger<quint64> glitch_common::s_dbId(0);
 
 QSqlDatabase glitch_common::sqliteDatabase(void)
 {
+  GLITCH_TRACE_SCOPE("glitch_common::sqliteDatabase");
+
+  /*
+  ** Connections may be created on worker threads.
+  */
+
   QSqlDatabase db;
+  quint64 id = s_dbId.fetchAndAddOrdered(1) + 1;
 
-  s_dbId += 1;
   db = QSqlDatabase::addDatabase
-    ("QSQLITE", QString("glitch_database_%1_%2").arg(qrand()).arg(s_dbId));
+    ("QSQLITE", QString("glitch_database_%1_%2").arg(qrand()).arg(id));
   return db;
 }
 
@@ -51,6 +59,43 @@ QString glitch_common::projectTypeToString(const ProjectType projectType)
     }
 }
 
+bool glitch_common::parseArguments(const QStringList &arguments,
+				   const QStringList &keys,
+				   QMap<QString, qint64> &values,
+				   QString &error)
+{
+  /*
+  ** Command-line parameters have the form key=value. Values are
+  ** non-negative integers. Keys are matched against the complete
+  ** list of keys, including pin keys such as a0, so malformed pin
+  ** indexes are unknown parameters.
+  */
+
+  values.clear();
+
+  for(const auto &argument : arguments)
+    {
+      QString key(argument.section('=', 0, 0).trimmed().toLower());
+      bool ok = true;
+      auto value = argument.section('=', 1).trimmed().toLongLong(&ok);
+
+      if(!argument.contains('=') || !ok || value < 0)
+	{
+	  error = QObject::tr("Invalid parameter %1.").arg(argument);
+	  return false;
+	}
+      else if(!keys.contains(key))
+	{
+	  error = QObject::tr("Unknown parameter %1.").arg(key);
+	  return false;
+	}
+
+      values[key] = value;
+    }
+
+  return true;
+}
+
 void glitch_common::discardDatabase(const QString &connectionName)
 {
   QSqlDatabase::removeDatabase(connectionName);
@@ -28,7 +28,10 @@
 #ifndef _glitch_common_h_
 #define _glitch_common_h_
 
+#include <QAtomicInteger>
+#include <QMap>
 #include <QSqlDatabase>
+#include <QStringList>
 
 class glitch_common
 {
@@ -41,12 +44,16 @@ class glitch_common
 
   static QSqlDatabase sqliteDatabase(void);
   static QString projectTypeToString(const ProjectType projectType);
+  static bool parseArguments(const QStringList &arguments,
+			     const QStringList &keys,
+			     QMap<QString, qint64> &values,
+			     QString &error);
   static void discardDatabase(const QString &connectioName);
 
  private:
   glitch_common(void);
   ~glitch_common(void);
-  static quint64 s_dbId;
+  static QAtomicInteger<quint64> s_dbId;
 };
 
 #endif
@@ -0,0 +1,37 @@
+HEADERS	       += Source/Arduino/glitch-code-generator-arduino.h \
+                  Source/Arduino/glitch-cost-model-arduino.h \
+                  Source/Arduino/glitch-footprint-arduino.h \
+                  Source/Arduino/glitch-native-arduino.h \
+                  Source/Arduino/glitch-optimizer-arduino.h \
+                  Source/Arduino/glitch-simulator-arduino.h \
+                  Source/glitch-batch-export.h \
+                  Source/glitch-call-graph.h \
+                  Source/glitch-common.h \
+                  Source/glitch-diagram.h \
+                  Source/glitch-diagram-generator.h \
+                  Source/glitch-diagram-object.h \
+                  Source/glitch-pin-trace.h \
+                  Source/glitch-proximity.h \
+                  Source/glitch-ring-buffer.h \
+                  Source/glitch-serial-log.h \
+                  Source/glitch-style-sheet-pool.h \
+                  Source/glitch-trace.h \
+                  Source/glitch-wire-graph.h
+SOURCES	       += Source/Arduino/glitch-code-generator-arduino.cc \
+                  Source/Arduino/glitch-cost-model-arduino.cc \
+                  Source/Arduino/glitch-footprint-arduino.cc \
+                  Source/Arduino/glitch-native-arduino.cc \
+                  Source/Arduino/glitch-optimizer-arduino.cc \
+                  Source/Arduino/glitch-simulator-arduino.cc \
+                  Source/glitch-batch-export.cc \
+                  Source/glitch-call-graph.cc \
+                  Source/glitch-common.cc \
+                  Source/glitch-diagram.cc \
+                  Source/glitch-diagram-generator.cc \
+                  Source/glitch-diagram-object.cc \
+                  Source/glitch-pin-trace.cc \
+                  Source/glitch-proximity.cc \
+                  Source/glitch-serial-log.cc \
+                  Source/glitch-style-sheet-pool.cc \
+                  Source/glitch-trace.cc \
+                  Source/glitch-wire-graph.cc
@@ -0,0 +1,351 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <iostream>
+#include <limits>
+
+#include "glitch-common.h"
+#include "glitch-diagram-generator.h"
+#include "glitch-diagram-object.h"
+#include "glitch-diagram.h"
+#include "glitch-style-sheet-pool.h"
+
+static bool insert(QSqlQuery &query,
+		   const glitch_diagram_object &object,
+		   QString &error)
+{
+  /*
+  ** The query is prepared once and executed for every object.
+  */
+
+  query.bindValue(0, object.id());
+  query.bindValue(1, object.parentId());
+  query.bindValue
+    (2, glitch_diagram_object::pointToString(object.position()));
+  query.bindValue
+    (3, glitch_diagram_object::propertiesToString(object.properties()));
+  query.bindValue
+    (4,
+     object.styleSheet().isEmpty() ?
+     QString("") : glitch_style_sheet_pool::hash(object.styleSheet()));
+  query.bindValue(5, object.type());
+
+  if(!query.exec())
+    {
+      error = query.lastError().text();
+      return false;
+    }
+
+  return true;
+}
+
+static int int_value(const QMap<QString, qint64> &values,
+		     const QString &key,
+		     const int defaultValue)
+{
+  return static_cast<int>
+    (qMin(values.value(key, defaultValue),
+	  static_cast<qint64> (std::numeric_limits<int>::max())));
+}
+
+glitch_diagram_generator::Parameters glitch_diagram_generator::
+defaultParameters(void)
+{
+  Parameters parameters;
+
+  parameters.canvasObjects = 0;
+  parameters.clones = 1;
+  parameters.functions = 100;
+  parameters.nesting = 1;
+  parameters.objects = 10;
+  parameters.styleSheets = 0;
+  return parameters;
+}
+
+QString glitch_diagram_generator::styleSheet(const Parameters &parameters,
+					     const qint64 id)
+{
+  if(parameters.styleSheets <= 0)
+    return "";
+
+  auto i = static_cast<int> (id % parameters.styleSheets);
+
+  return QString("background-color: rgb(%1, %2, %3);").
+    arg((i * 37) % 256).arg((i * 73) % 256).arg((i * 151) % 256);
+}
+
+bool glitch_diagram_generator::generate(const QString &fileName,
+					const Parameters &parameters,
+					QString &error)
+{
+  /*
+  ** The diagram contains loop(), setup(), the function definitions,
+  ** and the canvas objects. Each function's body contains objects and
+  ** clones of the following functions (nesting). The loop() body
+  ** contains the clones of every function.
+  */
+
+  QFile::remove(fileName);
+
+  QString connectionName("");
+  bool ok = true;
+
+  {
+    QSqlDatabase db(glitch_common::sqliteDatabase());
+
+    connectionName = db.connectionName();
+    db.setDatabaseName(fileName);
+
+    if((ok = db.open()))
+      {
+	glitch_diagram::createTables(db);
+
+	QSqlQuery query(db);
+
+	query.exec("PRAGMA journal_mode = OFF");
+	query.exec("PRAGMA synchronous = OFF");
+	db.transaction();
+	query.prepare("INSERT INTO diagram (name, type) VALUES (?, ?)");
+	query.addBindValue(QFileInfo(fileName).completeBaseName());
+	query.addBindValue("ArduinoProject");
+
+	if(!(ok = query.exec()))
+	  error = query.lastError().text();
+
+	query.prepare("INSERT INTO objects "
+		      "(myoid, parent_oid, position, properties, "
+		      "stylesheet, type) "
+		      "VALUES (?, ?, ?, ?, ?, ?)");
+
+	glitch_diagram_object object;
+	qint64 id = 2;
+
+	object.setId(1);
+	object.setPosition(QPointF(10.0, 10.0));
+	object.setProperty("position_locked", true);
+	object.setStyleSheet(styleSheet(parameters, 1));
+	object.setType("arduino-loop");
+	ok = ok && insert(query, object, error);
+	object.setId(2);
+	object.setPosition(QPointF(200.0, 10.0));
+	object.setStyleSheet(styleSheet(parameters, 2));
+	object.setType("arduino-setup");
+	ok = ok && insert(query, object, error);
+
+	for(int i = 0; ok && i < parameters.functions; i++)
+	  {
+	    QString name(QString("function_%1()").arg(i));
+	    int row = 0;
+
+	    id += 1;
+
+	    qint64 functionId = id;
+
+	    object = glitch_diagram_object();
+	    object.setId(functionId);
+	    object.setPosition
+	      (QPointF(10.0 + 250.0 * (i % 20), 100.0 + 60.0 * (i / 20)));
+	    object.setProperty("clone", false);
+	    object.setProperty("name", name);
+	    object.setProperty("position_locked", false);
+	    object.setProperty("return_type", i % 2 ? "int" : "void");
+	    object.setStyleSheet(styleSheet(parameters, functionId));
+	    object.setType("arduino-function");
+	    ok = insert(query, object, error);
+
+	    for(int j = 1; ok && j <= parameters.nesting; j++)
+	      {
+		if(i + j >= parameters.functions)
+		  break;
+
+		id += 1;
+		object.setId(id);
+		object.setParentId(functionId);
+		object.setPosition(QPointF(10.0, 10.0 + 60.0 * row++));
+		object.setProperty("clone", true);
+		object.setProperty
+		  ("name", QString("function_%1()").arg(i + j));
+		object.setProperty
+		  ("return_type", (i + j) % 2 ? "int" : "void");
+		object.setStyleSheet(styleSheet(parameters, id));
+		ok = insert(query, object, error);
+	      }
+
+	    for(int j = 0; ok && j < parameters.objects; j++)
+	      {
+		id += 1;
+		object = glitch_diagram_object();
+		object.setId(id);
+		object.setParentId(functionId);
+		object.setPosition(QPointF(10.0, 10.0 + 60.0 * row++));
+		object.setProperty("position_locked", false);
+		object.setStyleSheet(styleSheet(parameters, id));
+
+		if(j % 3 == 2)
+		  {
+		    object.setProperty("operator", j % 2 ? "or" : "and");
+		    object.setType("arduino-logicaloperator");
+		  }
+		else
+		  object.setType("arduino-analogread");
+
+		ok = insert(query, object, error);
+	      }
+
+	    for(int j = 0; ok && j < parameters.clones; j++)
+	      {
+		id += 1;
+		object = glitch_diagram_object();
+		object.setId(id);
+		object.setParentId(1);
+		object.setPosition(QPointF(10.0 + 250.0 * j, 10.0 + 60.0 * i));
+		object.setProperty("clone", true);
+		object.setProperty("name", name);
+		object.setProperty("position_locked", false);
+		object.setProperty("return_type", i % 2 ? "int" : "void");
+		object.setStyleSheet(styleSheet(parameters, id));
+		object.setType("arduino-function");
+		ok = insert(query, object, error);
+	      }
+	  }
+
+	int rows = (parameters.functions + 19) / 20 + 1;
+
+	for(int i = 0; ok && i < parameters.canvasObjects; i++)
+	  {
+	    id += 1;
+	    object = glitch_diagram_object();
+	    object.setId(id);
+	    object.setPosition
+	      (QPointF(10.0 + 150.0 * (i % 50),
+		       100.0 + 60.0 * (rows + i / 50)));
+	    object.setProperty("position_locked", false);
+	    object.setStyleSheet(styleSheet(parameters, id));
+	    object.setType("arduino-analogread");
+	    ok = insert(query, object, error);
+	  }
+
+	for(int i = 0; ok && i < parameters.styleSheets; i++)
+	  ok = glitch_style_sheet_pool::save
+	    (db, styleSheet(parameters, i), error);
+
+	/*
+	** Identifiers issued by glitch_view::nextId() must follow the
+	** generated identifiers.
+	*/
+
+	query.prepare("INSERT INTO sequence (value) VALUES (?)");
+	query.addBindValue(id);
+
+	if(ok && !(ok = query.exec()))
+	  error = query.lastError().text();
+
+	if(ok)
+	  ok = db.commit();
+	else
+	  db.rollback();
+      }
+    else
+      error = db.lastError().text();
+
+    db.close();
+  }
+
+  glitch_common::discardDatabase(connectionName);
+  return ok;
+}
+
+int glitch_diagram_generator::exec(const QString &fileName,
+				   const QStringList &arguments)
+{
+  QMap<QString, qint64> values;
+  QString error("");
+  QStringList keys;
+
+  keys << "canvas"
+       << "clones"
+       << "functions"
+       << "nesting"
+       << "objects"
+       << "stylesheets";
+
+  if(!glitch_common::parseArguments(arguments, keys, values, error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  auto parameters(defaultParameters());
+
+  parameters.canvasObjects = int_value
+    (values, "canvas", parameters.canvasObjects);
+  parameters.clones = int_value(values, "clones", parameters.clones);
+  parameters.functions = int_value
+    (values, "functions", parameters.functions);
+  parameters.nesting = int_value(values, "nesting", parameters.nesting);
+  parameters.objects = int_value(values, "objects", parameters.objects);
+  parameters.styleSheets = int_value
+    (values, "stylesheets", parameters.styleSheets);
+
+  QElapsedTimer timer;
+
+  timer.start();
+
+  if(!generate(fileName, parameters, error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout << fileName.toStdString()
+	    << ": "
+	    << count(parameters)
+	    << " object(s) in "
+	    << timer.elapsed()
+	    << " ms."
+	    << std::endl;
+  return EXIT_SUCCESS;
+}
+
+qint64 glitch_diagram_generator::count(const Parameters &parameters)
+{
+  qint64 count = 2 + parameters.canvasObjects;
+
+  for(int i = 0; i < parameters.functions; i++)
+    count += 1 +
+      parameters.clones +
+      parameters.objects +
+      qMin(parameters.nesting, parameters.functions - i - 1);
+
+  return count;
+}
@@ -0,0 +1,259 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include "glitch-diagram-object.h"
+#include "glitch-style-sheet-pool.h"
+
+glitch_diagram_object::glitch_diagram_object
+(const QMap<QString, QVariant> &values)
+{
+  /*
+  ** Keys other than the column keys are properties.
+  */
+
+  QMapIterator<QString, QVariant> it(values);
+
+  m_id = values.value("myoid", 0).toLongLong();
+  m_parentId = values.value("parentId", -1).toLongLong();
+  m_position = values.value("position").toPointF();
+  m_styleSheet = values.value("stylesheet").toString();
+  m_type = values.value("type").toString();
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      if(!(it.key() == "myoid" ||
+	   it.key() == "parentId" ||
+	   it.key() == "position" ||
+	   it.key() == "properties" ||
+	   it.key() == "stylesheet" ||
+	   it.key() == "type"))
+	m_properties[it.key()] = it.value();
+    }
+}
+
+glitch_diagram_object::glitch_diagram_object(void)
+{
+  m_id = 0;
+  m_parentId = -1;
+}
+
+glitch_diagram_object::~glitch_diagram_object()
+{
+}
+
+QMap<QString, QVariant> glitch_diagram_object::parseProperties
+(const QString &properties)
+{
+  QMap<QString, QVariant> map;
+
+  for(const auto &property : properties.split('&', QString::SkipEmptyParts))
+    {
+      int index = property.indexOf(" = ");
+
+      if(index > 0)
+	map[property.left(index).trimmed()] =
+	  property.mid(index + 3).remove('"');
+    }
+
+  return map;
+}
+
+QMap<QString, QVariant> glitch_diagram_object::properties(void) const
+{
+  return m_properties;
+}
+
+QMap<QString, QVariant> glitch_diagram_object::values(void) const
+{
+  /*
+  ** The values of an object, as understood by
+  ** glitch_object::createFromValues() and the code generators.
+  */
+
+  auto values(m_properties);
+
+  values["myoid"] = m_id;
+  values["parentId"] = m_parentId;
+  values["position"] = m_position;
+  values["properties"] = propertiesToString(m_properties);
+  values["stylesheet"] = m_styleSheet;
+  values["type"] = m_type;
+  return values;
+}
+
+QPointF glitch_diagram_object::pointFromString(const QString &text)
+{
+  QStringList list(QString(text).remove("(").remove(")").split(","));
+
+  return {qAbs(list.value(0).toDouble()),
+	  qAbs(list.value(1).toDouble())};
+}
+
+QPointF glitch_diagram_object::position(void) const
+{
+  return m_position;
+}
+
+QString glitch_diagram_object::pointToString(const QPointF &point)
+{
+  return QString("(%1,%2)").arg(point.x()).arg(point.y());
+}
+
+QString glitch_diagram_object::propertiesToString
+(const QMap<QString, QVariant> &properties)
+{
+  QMapIterator<QString, QVariant> it(properties);
+  QString string("");
+
+  while(it.hasNext())
+    {
+      it.next();
+      string.append(it.key());
+      string.append(" = ");
+      string.append("\"");
+      string.append(it.value().toString());
+      string.append("\"");
+
+      if(it.hasNext())
+	string.append("&");
+    }
+
+  return string;
+}
+
+QString glitch_diagram_object::styleSheet(void) const
+{
+  return m_styleSheet;
+}
+
+QString glitch_diagram_object::type(void) const
+{
+  return m_type;
+}
+
+QVariant glitch_diagram_object::property(const QString &name) const
+{
+  return m_properties.value(name);
+}
+
+bool glitch_diagram_object::save(const QSqlDatabase &db, QString &error) const
+{
+  QSqlQuery query(db);
+
+  query.prepare("INSERT OR REPLACE INTO objects "
+		"(myoid, parent_oid, position, properties, stylesheet, type) "
+		"VALUES(?, ?, ?, ?, ?, ?)");
+  query.addBindValue(m_id);
+  query.addBindValue(m_parentId);
+  query.addBindValue(pointToString(m_position));
+  query.addBindValue(propertiesToString(m_properties));
+
+  /*
+  ** Style sheets are stored once in the stylesheets table.
+  */
+
+  query.addBindValue
+    (m_styleSheet.isEmpty() ?
+     QString("") : glitch_style_sheet_pool::hash(m_styleSheet));
+  query.addBindValue(m_type);
+
+  if(!query.exec())
+    {
+      error = query.lastError().text();
+      return false;
+    }
+
+  return glitch_style_sheet_pool::save(db, m_styleSheet, error);
+}
+
+qint64 glitch_diagram_object::id(void) const
+{
+  return m_id;
+}
+
+qint64 glitch_diagram_object::memoryEstimate(void) const
+{
+  /*
+  ** Map nodes are estimated at 48 bytes.
+  */
+
+  QMapIterator<QString, QVariant> it(m_properties);
+  qint64 bytes = static_cast<qint64> (sizeof(*this)) +
+    2 * (m_styleSheet.size() + m_type.size());
+
+  while(it.hasNext())
+    {
+      it.next();
+      bytes += 48 +
+	static_cast<qint64> (sizeof(QVariant)) +
+	2 * (it.key().size() + it.value().toString().size());
+    }
+
+  return bytes;
+}
+
+qint64 glitch_diagram_object::parentId(void) const
+{
+  return m_parentId;
+}
+
+void glitch_diagram_object::setId(const qint64 id)
+{
+  m_id = id;
+}
+
+void glitch_diagram_object::setParentId(const qint64 parentId)
+{
+  m_parentId = parentId;
+}
+
+void glitch_diagram_object::setPosition(const QPointF &position)
+{
+  m_position = position;
+}
+
+void glitch_diagram_object::setProperty(const QString &name,
+					const QVariant &value)
+{
+  m_properties[name] = value;
+}
+
+void glitch_diagram_object::setStyleSheet(const QString &styleSheet)
+{
+  m_styleSheet = styleSheet;
+}
+
+void glitch_diagram_object::setType(const QString &type)
+{
+  m_type = type;
+}
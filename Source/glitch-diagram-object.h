@@ -0,0 +1,72 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_diagram_object_h_
+#define _glitch_diagram_object_h_
+
+#include <QMap>
+#include <QPointF>
+#include <QSqlDatabase>
+#include <QVariant>
+
+class glitch_diagram_object
+{
+ public:
+  glitch_diagram_object(const QMap<QString, QVariant> &values);
+  glitch_diagram_object(void);
+  ~glitch_diagram_object();
+  QMap<QString, QVariant> properties(void) const;
+  QMap<QString, QVariant> values(void) const;
+  QPointF position(void) const;
+  QString styleSheet(void) const;
+  QString type(void) const;
+  QVariant property(const QString &name) const;
+  bool save(const QSqlDatabase &db, QString &error) const;
+  qint64 id(void) const;
+  qint64 memoryEstimate(void) const;
+  qint64 parentId(void) const;
+  static QMap<QString, QVariant> parseProperties(const QString &properties);
+  static QPointF pointFromString(const QString &text);
+  static QString pointToString(const QPointF &point);
+  static QString propertiesToString(const QMap<QString, QVariant> &properties);
+  void setId(const qint64 id);
+  void setParentId(const qint64 parentId);
+  void setPosition(const QPointF &position);
+  void setProperty(const QString &name, const QVariant &value);
+  void setStyleSheet(const QString &styleSheet);
+  void setType(const QString &type);
+
+ private:
+  QMap<QString, QVariant> m_properties;
+  QPointF m_position;
+  QString m_styleSheet;
+  QString m_type;
+  qint64 m_id;
+  qint64 m_parentId;
+};
+
+#endif
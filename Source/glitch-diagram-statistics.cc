@@ -0,0 +1,280 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QFileInfo>
+#include <QShortcut>
+#include <QUndoStack>
+
+#include <iostream>
+
+#include "Arduino/glitch-view-arduino.h"
+#include "glitch-diagram-object.h"
+#include "glitch-diagram-statistics.h"
+#include "glitch-misc.h"
+#include "glitch-object-view.h"
+#include "glitch-object.h"
+#include "glitch-undo-command.h"
+#include "glitch-view.h"
+
+static void collect(const QList<glitch_object *> &objects,
+		    QMap<QString, QPair<int, qint64> > &bodies,
+		    QMap<QString, QPair<int, qint64> > &types,
+		    QPair<int, qint64> &model)
+{
+  for(auto object : objects)
+    {
+      if(!object)
+	continue;
+
+      auto &type = types[object->type()];
+
+      model.first += 1;
+      model.second += glitch_diagram_object(object->values()).
+	memoryEstimate();
+      type.first += 1;
+      type.second += object->memoryEstimate();
+
+      auto view = object->editView();
+
+      if(view)
+	{
+	  auto &body = bodies
+	    [object->name().isEmpty() ? object->type() : object->name()];
+
+	  body.first += view->objects().size();
+	  body.second += view->memoryEstimate();
+	  collect(view->objects(), bodies, types, model);
+	}
+      else if(!object->pendingChildren().isEmpty())
+	{
+	  /*
+	  ** The body has not been opened. Its children are held in the
+	  ** model and are included in the object's estimate.
+	  */
+
+	  auto &body = bodies
+	    [object->name().isEmpty() ? object->type() : object->name()];
+
+	  for(const auto &child : object->pendingChildren())
+	    {
+	      body.first += 1;
+	      body.second += child.memoryEstimate();
+	      model.first += 1;
+	      model.second += child.memoryEstimate();
+	    }
+	}
+    }
+}
+
+static qint64 undo_stack_estimate(const QUndoStack *undoStack)
+{
+  if(!undoStack)
+    return 0;
+
+  qint64 bytes = static_cast<qint64> (sizeof(QUndoStack)) + 120;
+
+  for(int i = 0; i < undoStack->count(); i++)
+    if(undoStack->command(i))
+      bytes += static_cast<qint64> (sizeof(glitch_undo_command)) *
+	(1 + undoStack->command(i)->childCount());
+
+  return bytes;
+}
+
+glitch_diagram_statistics::glitch_diagram_statistics(QWidget *parent):
+  QDialog(parent)
+{
+  m_ui.setupUi(this);
+  connect(m_ui.refresh,
+	  SIGNAL(clicked(void)),
+	  this,
+	  SLOT(slotRefresh(void)));
+  new QShortcut(tr("Ctrl+W"),
+		this,
+		SLOT(close(void)));
+  setWindowModality(Qt::NonModal);
+}
+
+glitch_diagram_statistics::~glitch_diagram_statistics()
+{
+}
+
+QList<QStringList> glitch_diagram_statistics::statistics
+(const glitch_view *view)
+{
+  /*
+  ** Category, name, count, estimated bytes. Objects are counted by
+  ** type without their function bodies. Function bodies include
+  ** their windows, their views, and their objects. Model describes
+  ** the same objects held as glitch_diagram_object values.
+  */
+
+  QList<QStringList> list;
+
+  if(!view)
+    return list;
+
+  QMap<QString, QPair<int, qint64> > bodies;
+  QMap<QString, QPair<int, qint64> > types;
+  QPair<int, qint64> model(0, 0);
+
+  collect(view->objects(), bodies, types, model);
+
+  qint64 canvas = glitch_misc::memoryEstimate(view);
+  qint64 total = 0;
+  qint64 undo = undo_stack_estimate(view->undoStack());
+
+  for(const auto &type : types)
+    total += type.second;
+
+  for(const auto &body : bodies)
+    total += body.second;
+
+  total += canvas + undo;
+  list << (QStringList() << "Diagram"
+	                 << view->name()
+	                 << QString::number(model.first)
+	                 << QString::number(total));
+  list << (QStringList() << "Canvas"
+	                 << view->name()
+	                 << "1"
+	                 << QString::number(canvas));
+
+  QMapIterator<QString, QPair<int, qint64> > it(types);
+
+  while(it.hasNext())
+    {
+      it.next();
+      list << (QStringList() << "Type"
+	                     << it.key()
+	                     << QString::number(it.value().first)
+	                     << QString::number(it.value().second));
+    }
+
+  it = QMapIterator<QString, QPair<int, qint64> > (bodies);
+
+  while(it.hasNext())
+    {
+      it.next();
+      list << (QStringList() << "Function Body"
+	                     << it.key()
+	                     << QString::number(it.value().first)
+	                     << QString::number(it.value().second));
+    }
+
+  list << (QStringList() << "Undo Stack"
+	                 << ""
+	                 << QString::number(view->undoStack() ?
+					    view->undoStack()->count() : 0)
+	                 << QString::number(undo));
+  list << (QStringList() << "Model"
+	                 << ""
+	                 << QString::number(model.first)
+	                 << QString::number(model.second));
+
+  auto arduino = qobject_cast<const glitch_view_arduino *> (view);
+
+  if(arduino)
+    {
+      auto graph(arduino->callGraph());
+
+      for(const auto &name : graph.recursiveFunctions())
+	list << (QStringList() << "Recursive Function"
+		               << name
+		               << "1"
+		               << "0");
+
+      for(const auto &name : graph.deadFunctions())
+	list << (QStringList() << "Unused Function"
+		               << name
+		               << "1"
+		               << "0");
+    }
+
+  return list;
+}
+
+int glitch_diagram_statistics::dump(const QString &fileName)
+{
+  QFileInfo fileInfo(fileName);
+  QString error("");
+  glitch_view_arduino view
+    (fileInfo.absoluteFilePath(),
+     fileInfo.completeBaseName(),
+     true,
+     glitch_common::ArduinoProject,
+     nullptr);
+
+  if(!view.open(fileInfo.absoluteFilePath(), error))
+    {
+      std::cerr << error.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  for(const auto &row : statistics(&view))
+    std::cout << row.join('\t').toStdString() << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+void glitch_diagram_statistics::showEvent(QShowEvent *event)
+{
+  QDialog::showEvent(event);
+  slotRefresh();
+}
+
+void glitch_diagram_statistics::slotRefresh(void)
+{
+  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+  auto list(statistics(qobject_cast<glitch_view *> (parentWidget())));
+
+  m_ui.table->setRowCount(0);
+  m_ui.table->setSortingEnabled(false);
+  m_ui.table->setRowCount(list.size());
+
+  for(int i = 0; i < list.size(); i++)
+    for(int j = 0; j < list.at(i).size(); j++)
+      {
+	auto item = new QTableWidgetItem();
+
+	if(j >= 2)
+	  {
+	    item->setData(Qt::DisplayRole, list.at(i).at(j).toLongLong());
+	    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+	  }
+	else
+	  item->setText(list.at(i).at(j));
+
+	item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+	m_ui.table->setItem(i, j, item);
+      }
+
+  m_ui.table->setSortingEnabled(true);
+  m_ui.table->resizeColumnsToContents();
+  QApplication::restoreOverrideCursor();
+}
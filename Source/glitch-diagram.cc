@@ -0,0 +1,343 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QObject>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "glitch-common.h"
+#include "glitch-diagram.h"
+#include "glitch-trace.h"
+
+glitch_diagram::glitch_diagram(void)
+{
+}
+
+glitch_diagram::~glitch_diagram()
+{
+}
+
+QList<glitch_diagram::Wire> glitch_diagram::wires(void) const
+{
+  return m_wires;
+}
+
+QList<glitch_diagram_object> glitch_diagram::children
+(const qint64 parentId) const
+{
+  QList<glitch_diagram_object> list;
+
+  for(auto id : m_children.value(parentId))
+    list << m_objects.value(id);
+
+  return list;
+}
+
+QList<glitch_diagram_object> glitch_diagram::objects(void) const
+{
+  return m_objects.values();
+}
+
+QList<glitch_diagram_object> glitch_diagram::topLevelObjects(void) const
+{
+  return children(-1);
+}
+
+QString glitch_diagram::name(void) const
+{
+  return m_name;
+}
+
+QString glitch_diagram::type(void) const
+{
+  return m_type;
+}
+
+bool glitch_diagram::contains(const qint64 id) const
+{
+  return m_objects.contains(id);
+}
+
+bool glitch_diagram::load(const QString &fileName, QString &error)
+{
+  GLITCH_TRACE_SCOPE("glitch_diagram::load");
+
+  clear();
+
+  QString connectionName("");
+  bool ok = true;
+
+  {
+    QSqlDatabase db(glitch_common::sqliteDatabase());
+
+    connectionName = db.connectionName();
+    db.setDatabaseName(fileName);
+
+    if((ok = db.open()))
+      {
+	QSqlQuery query(db);
+
+	query.setForwardOnly(true);
+
+	if(query.exec("SELECT name, type FROM diagram"))
+	  if(query.next())
+	    {
+	      m_name = query.value(0).toString().trimmed();
+	      m_type = query.value(1).toString().trimmed();
+	    }
+
+	m_styleSheets.load(db);
+
+	if(query.exec("SELECT myoid, parent_oid, position, properties, "
+		      "stylesheet, type FROM objects ORDER BY "
+		      "parent_oid, myoid"))
+	  while(query.next())
+	    {
+	      glitch_diagram_object object;
+
+	      object.setId(query.value(0).toLongLong());
+	      object.setParentId(query.value(1).toLongLong());
+	      object.setPosition
+		(glitch_diagram_object::
+		 pointFromString(query.value(2).toString().trimmed()));
+
+	      auto properties
+		(glitch_diagram_object::
+		 parseProperties(query.value(3).toString().trimmed()));
+	      QMapIterator<QString, QVariant> it(properties);
+
+	      while(it.hasNext())
+		{
+		  it.next();
+		  object.setProperty(it.key(), it.value());
+		}
+
+	      object.setStyleSheet
+		(m_styleSheets.resolve(query.value(4).toString().trimmed()));
+	      object.setType(query.value(5).toString().toLower().trimmed());
+	      addObject(object);
+	    }
+	else
+	  {
+	    error = QObject::tr
+	      ("An error occurred while accessing the objects table.");
+	    ok = false;
+	  }
+
+	if(ok && query.exec("SELECT object_input_oid, object_output_oid, "
+			    "parent_oid FROM wires"))
+	  while(query.next())
+	    {
+	      Wire wire;
+
+	      wire.inputId = query.value(0).toLongLong();
+	      wire.outputId = query.value(1).toLongLong();
+	      wire.parentId = query.value(2).toLongLong();
+	      m_wires << wire;
+	    }
+      }
+    else
+      error = QObject::tr("Unable to open %1.").arg(fileName);
+
+    db.close();
+  }
+
+  glitch_common::discardDatabase(connectionName);
+  return ok;
+}
+
+bool glitch_diagram::save(const QString &fileName, QString &error) const
+{
+  GLITCH_TRACE_SCOPE("glitch_diagram::save");
+
+  QString connectionName("");
+  bool ok = true;
+
+  {
+    QSqlDatabase db(glitch_common::sqliteDatabase());
+
+    connectionName = db.connectionName();
+    db.setDatabaseName(fileName);
+
+    if((ok = db.open()))
+      {
+	createTables(db);
+	db.transaction();
+
+	QSqlQuery query(db);
+
+	query.exec("DELETE FROM diagram");
+	query.exec("DELETE FROM objects");
+	query.exec("DELETE FROM stylesheets");
+	query.exec("DELETE FROM wires");
+	query.prepare("INSERT OR REPLACE INTO diagram (name, type) "
+		      "VALUES (?, ?)");
+	query.addBindValue(m_name);
+	query.addBindValue(m_type);
+
+	if(!(ok = query.exec()))
+	  error = query.lastError().text();
+
+	QHashIterator<qint64, glitch_diagram_object> it(m_objects);
+
+	while(ok && it.hasNext())
+	  {
+	    it.next();
+	    ok = it.value().save(db, error);
+	  }
+
+	for(int i = 0; ok && i < m_wires.size(); i++)
+	  {
+	    query.prepare("INSERT OR REPLACE INTO wires "
+			  "(object_input_oid, object_output_oid, parent_oid) "
+			  "VALUES (?, ?, ?)");
+	    query.addBindValue(m_wires.at(i).inputId);
+	    query.addBindValue(m_wires.at(i).outputId);
+	    query.addBindValue(m_wires.at(i).parentId);
+
+	    if(!(ok = query.exec()))
+	      error = query.lastError().text();
+	  }
+
+	if(ok)
+	  db.commit();
+	else
+	  db.rollback();
+      }
+    else
+      error = db.lastError().text();
+
+    db.close();
+  }
+
+  glitch_common::discardDatabase(connectionName);
+  return ok;
+}
+
+glitch_diagram_object glitch_diagram::object(const qint64 id) const
+{
+  return m_objects.value(id);
+}
+
+glitch_wire_graph glitch_diagram::wireGraph(const qint64 parentId) const
+{
+  glitch_wire_graph graph;
+
+  for(const auto &wire : m_wires)
+    if(wire.parentId == parentId)
+      graph.addWire(wire.outputId, wire.inputId);
+
+  return graph;
+}
+
+int glitch_diagram::count(void) const
+{
+  return m_objects.size();
+}
+
+void glitch_diagram::addObject(const glitch_diagram_object &object)
+{
+  if(m_objects.contains(object.id()))
+    m_children[m_objects.value(object.id()).parentId()].removeOne(object.id());
+
+  m_children[object.parentId()] << object.id();
+  m_objects[object.id()] = object;
+}
+
+void glitch_diagram::addWire(const Wire &wire)
+{
+  m_wires << wire;
+}
+
+void glitch_diagram::clear(void)
+{
+  m_children.clear();
+  m_name.clear();
+  m_objects.clear();
+  m_styleSheets.clear();
+  m_type.clear();
+  m_wires.clear();
+}
+
+void glitch_diagram::createTables(const QSqlDatabase &db)
+{
+  QSqlQuery query(db);
+
+  query.exec("CREATE TABLE IF NOT EXISTS diagram ("
+	     "name TEXT NOT NULL PRIMARY KEY, "
+	     "type TEXT NOT NULL)");
+  query.exec("CREATE TABLE IF NOT EXISTS objects ("
+	     "myoid INTEGER NOT NULL UNIQUE, "
+	     "parent_oid INTEGER NOT NULL DEFAULT -1, "
+	     "position TEXT NOT NULL, "
+	     "properties TEXT, "
+	     "stylesheet TEXT, "
+	     "type TEXT NOT NULL, "
+	     "PRIMARY KEY (myoid, parent_oid))");
+  query.exec("CREATE TABLE IF NOT EXISTS sequence ("
+	     "value INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT)");
+  query.exec("CREATE TABLE IF NOT EXISTS stylesheets ("
+	     "hash TEXT NOT NULL PRIMARY KEY, "
+	     "stylesheet TEXT NOT NULL)");
+  query.exec("CREATE TABLE IF NOT EXISTS wires ("
+	     "object_input_oid INTEGER NOT NULL, "
+	     "object_output_oid INTEGER NOT NULL, "
+	     "parent_oid INTEGER NOT NULL, "
+	     "PRIMARY KEY (object_input_oid, "
+	     "object_output_oid, parent_oid))");
+}
+
+void glitch_diagram::removeObject(const qint64 id)
+{
+  if(!m_objects.contains(id))
+    return;
+
+  /*
+  ** Remove the object's descendants as well.
+  */
+
+  for(auto child : m_children.value(id))
+    removeObject(child);
+
+  m_children.remove(id);
+  m_children[m_objects.value(id).parentId()].removeOne(id);
+  m_objects.remove(id);
+
+  for(int i = m_wires.size() - 1; i >= 0; i--)
+    if(m_wires.at(i).inputId == id || m_wires.at(i).outputId == id)
+      m_wires.removeAt(i);
+}
+
+void glitch_diagram::setName(const QString &name)
+{
+  m_name = name;
+}
+
+void glitch_diagram::setType(const QString &type)
+{
+  m_type = type;
+}
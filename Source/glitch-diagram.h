@@ -0,0 +1,79 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_diagram_h_
+#define _glitch_diagram_h_
+
+#include <QHash>
+#include <QList>
+
+#include "glitch-diagram-object.h"
+#include "glitch-style-sheet-pool.h"
+#include "glitch-wire-graph.h"
+
+class glitch_diagram
+{
+ public:
+  struct Wire
+  {
+    qint64 inputId;
+    qint64 outputId;
+    qint64 parentId;
+  };
+
+  glitch_diagram(void);
+  ~glitch_diagram();
+  QList<Wire> wires(void) const;
+  QList<glitch_diagram_object> children(const qint64 parentId) const;
+  QList<glitch_diagram_object> objects(void) const;
+  QList<glitch_diagram_object> topLevelObjects(void) const;
+  QString name(void) const;
+  QString type(void) const;
+  bool contains(const qint64 id) const;
+  bool load(const QString &fileName, QString &error);
+  bool save(const QString &fileName, QString &error) const;
+  glitch_diagram_object object(const qint64 id) const;
+  glitch_wire_graph wireGraph(const qint64 parentId) const;
+  int count(void) const;
+  static void createTables(const QSqlDatabase &db);
+  void addObject(const glitch_diagram_object &object);
+  void addWire(const Wire &wire);
+  void clear(void);
+  void removeObject(const qint64 id);
+  void setName(const QString &name);
+  void setType(const QString &type);
+
+ private:
+  QHash<qint64, QList<qint64> > m_children;
+  QHash<qint64, glitch_diagram_object> m_objects;
+  QList<Wire> m_wires;
+  QString m_name;
+  QString m_type;
+  glitch_style_sheet_pool m_styleSheets;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QScrollBar>
+#include <QShortcut>
+
+#include "glitch-generated-source.h"
+#include "glitch-view.h"
+
+glitch_generated_source::glitch_generated_source(QWidget *parent):
+  QDialog(parent)
+{
+  m_refreshTimer.setInterval(250);
+  m_refreshTimer.setSingleShot(true);
+  m_ui.setupUi(this);
+  m_ui.text->setFont(QFont("Courier"));
+  new QShortcut(tr("Ctrl+W"),
+		this,
+		SLOT(close(void)));
+  connect(&m_refreshTimer,
+	  SIGNAL(timeout(void)),
+	  this,
+	  SLOT(slotRefresh(void)));
+  connect(m_ui.optimize,
+	  SIGNAL(toggled(bool)),
+	  this,
+	  SLOT(slotRefresh(void)));
+
+  if(qobject_cast<glitch_view *> (parent))
+    connect(qobject_cast<glitch_view *> (parent),
+	    SIGNAL(changed(void)),
+	    this,
+	    SLOT(slotChanged(void)));
+
+  setWindowModality(Qt::NonModal);
+}
+
+glitch_generated_source::~glitch_generated_source()
+{
+}
+
+void glitch_generated_source::showEvent(QShowEvent *event)
+{
+  QDialog::showEvent(event);
+  slotRefresh();
+}
+
+void glitch_generated_source::slotChanged(void)
+{
+  /*
+  ** Coalesce bursts of changes.
+  */
+
+  if(isVisible())
+    m_refreshTimer.start();
+}
+
+void glitch_generated_source::slotRefresh(void)
+{
+  auto view = qobject_cast<glitch_view *> (parentWidget());
+
+  if(!view)
+    return;
+
+  QString report("");
+  QString source
+    (m_ui.optimize->isChecked() ? view->optimizedSource(report) :
+     view->source());
+
+  m_ui.report->setText(report);
+  m_ui.report->setVisible(!report.isEmpty());
+
+  if(source == m_ui.text->toPlainText())
+    return;
+
+  int h = m_ui.text->horizontalScrollBar()->value();
+  int v = m_ui.text->verticalScrollBar()->value();
+
+  m_ui.text->setPlainText(source);
+  m_ui.text->horizontalScrollBar()->setValue(h);
+  m_ui.text->verticalScrollBar()->setValue(v);
+}
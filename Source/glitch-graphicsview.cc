@@ -25,13 +25,55 @@
 ** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <QGraphicsProxyWidget>
 #include <QMouseEvent>
+#include <QShortcut>
+#include <QUndoStack>
+
+#include <algorithm>
 
 #include "glitch-graphicsview.h"
+#include "glitch-scene.h"
 #include "glitch-view.h"
 
+static QString update_mode_to_string(const QGraphicsView::ViewportUpdateMode m)
+{
+  switch(m)
+    {
+    case QGraphicsView::BoundingRectViewportUpdate:
+      return "Bounding Rectangle";
+    case QGraphicsView::FullViewportUpdate:
+      return "Full";
+    case QGraphicsView::MinimalViewportUpdate:
+      return "Minimal";
+    case QGraphicsView::NoViewportUpdate:
+      return "None";
+    case QGraphicsView::SmartViewportUpdate:
+      return "Smart";
+    default:
+      return "";
+    }
+}
+
 glitch_graphicsview::glitch_graphicsview(QWidget *parent):QGraphicsView(parent)
 {
+  connect(&m_statisticsTimer,
+	  SIGNAL(timeout(void)),
+	  this,
+	  SLOT(slotUpdateStatistics(void)));
+  m_exposedArea = 0;
+  m_paintTimes.fill(-1, 120);
+  m_paintTimesIndex = 0;
+  m_showStatistics = false;
+  m_totalProxies = 0;
+  m_undoChildren = 0;
+  m_undoCommands = -1;
+  m_undoIndex = 0;
+  m_visibleProxies = 0;
+  m_statisticsTimer.setInterval(500);
+  new QShortcut(tr("Ctrl+Alt+H"),
+		this,
+		SLOT(slotToggleStatistics(void)));
 }
 
 bool glitch_graphicsview::containsFunction(const QString &name) const
@@ -44,6 +86,94 @@ bool glitch_graphicsview::containsFunction(const QString &name) const
     return false;
 }
 
+bool glitch_graphicsview::statisticsVisible(void) const
+{
+  return m_showStatistics;
+}
+
+qint64 glitch_graphicsview::percentile(const int p) const
+{
+  QVector<qint64> times;
+
+  for(auto time : m_paintTimes)
+    if(time >= 0)
+      times << time;
+
+  if(times.isEmpty())
+    return 0;
+
+  std::sort(times.begin(), times.end());
+  return times.at(qMin(times.size() - 1, (times.size() * p) / 100));
+}
+
+void glitch_graphicsview::drawForeground(QPainter *painter, const QRectF &rect)
+{
+  QGraphicsView::drawForeground(painter, rect);
+
+  if(m_showStatistics && painter)
+    {
+      /*
+      ** The overlay is not included in the paint time.
+      */
+
+      if(m_paintTimer.isValid())
+	{
+	  m_paintTimes[m_paintTimesIndex] = m_paintTimer.nsecsElapsed() / 1000;
+	  m_paintTimesIndex = (m_paintTimesIndex + 1) % m_paintTimes.size();
+	  m_paintTimer.invalidate();
+	}
+
+      drawStatistics(painter);
+    }
+}
+
+void glitch_graphicsview::drawStatistics(QPainter *painter)
+{
+  /*
+  ** The statistics describe the previous frames. The counts are
+  ** refreshed by the statistics timer, not here.
+  */
+
+  QStringList lines;
+
+  lines << tr("Paint: %1 us (p50), %2 us (p99)").
+    arg(percentile(50)).arg(percentile(99));
+  lines << tr("Exposed Area: %1 px").arg(m_exposedArea);
+  lines << tr("Proxies: %1 visible, %2 total").
+    arg(m_visibleProxies).arg(m_totalProxies);
+  lines << tr("Update Mode: %1").
+    arg(update_mode_to_string(viewportUpdateMode()));
+
+  if(m_undoCommands >= 0)
+    lines << tr("Undo Stack: %1 command(s), %2 child command(s), "
+		"index %3").
+      arg(m_undoCommands).arg(m_undoChildren).arg(m_undoIndex);
+
+  painter->save();
+  painter->resetTransform();
+
+  QFontMetrics fontMetrics(painter->font());
+  int height = fontMetrics.lineSpacing();
+  int width = 0;
+
+  for(const auto &line : lines)
+#if QT_VERSION >= 0x050b00
+    width = qMax(width, fontMetrics.horizontalAdvance(line));
+#else
+    width = qMax(width, fontMetrics.width(line));
+#endif
+
+  m_statisticsRect = QRect(5, 5, width + 10, height * lines.size() + 10);
+  painter->fillRect(m_statisticsRect, QColor(0, 0, 0, 175));
+  painter->setPen(Qt::white);
+
+  for(int i = 0; i < lines.size(); i++)
+    painter->drawText
+      (10, 10 + fontMetrics.ascent() + height * i, lines.at(i));
+
+  painter->restore();
+}
+
 void glitch_graphicsview::enterEvent(QEvent *event)
 {
   QGraphicsView::enterEvent(event);
@@ -56,6 +186,31 @@ void glitch_graphicsview::leaveEvent(QEvent *event)
   emit mouseLeaveEvent();
 }
 
+void glitch_graphicsview::paintEvent(QPaintEvent *event)
+{
+  if(!m_showStatistics)
+    {
+      QGraphicsView::paintEvent(event);
+      return;
+    }
+
+  m_paintTimer.start();
+  QGraphicsView::paintEvent(event);
+  m_paintTimer.invalidate();
+
+  if(event)
+    {
+      m_exposedArea = 0;
+
+#if QT_VERSION >= 0x050800
+      for(const auto &rect : event->region())
+#else
+      for(const auto &rect : event->region().rects())
+#endif
+	m_exposedArea += static_cast<qint64> (rect.width()) * rect.height();
+    }
+}
+
 void glitch_graphicsview::mousePressEvent(QMouseEvent *event)
 {
   QGraphicsView::mousePressEvent(event);
@@ -68,3 +223,65 @@ void glitch_graphicsview::mousePressEvent(QMouseEvent *event)
       emit customContextMenuRequested
 	(event ? mapToParent(event->pos()) : QPoint());
 }
+
+void glitch_graphicsview::setStatisticsVisible(const bool state)
+{
+  m_paintTimes.fill(-1);
+  m_paintTimesIndex = 0;
+  m_showStatistics = state;
+
+  if(m_showStatistics)
+    {
+      m_statisticsTimer.start();
+      slotUpdateStatistics();
+    }
+  else
+    m_statisticsTimer.stop();
+
+  viewport()->update();
+}
+
+void glitch_graphicsview::slotToggleStatistics(void)
+{
+  setStatisticsVisible(!m_showStatistics);
+}
+
+void glitch_graphicsview::slotUpdateStatistics(void)
+{
+  m_totalProxies = 0;
+  m_undoChildren = 0;
+  m_undoCommands = -1;
+  m_undoIndex = 0;
+  m_visibleProxies = 0;
+
+  if(scene())
+    {
+      for(auto item : scene()->items())
+	if(qgraphicsitem_cast<QGraphicsProxyWidget *> (item))
+	  m_totalProxies += 1;
+
+      for(auto item : scene()->items(mapToScene(viewport()->rect())))
+	if(qgraphicsitem_cast<QGraphicsProxyWidget *> (item))
+	  m_visibleProxies += 1;
+    }
+
+  auto glitchScene = qobject_cast<glitch_scene *> (scene());
+
+  if(glitchScene && glitchScene->undoStack())
+    {
+      auto undoStack = glitchScene->undoStack();
+
+      for(int i = 0; i < undoStack->count(); i++)
+	if(undoStack->command(i))
+	  m_undoChildren += undoStack->command(i)->childCount();
+
+      m_undoCommands = undoStack->count();
+      m_undoIndex = undoStack->index();
+    }
+
+  /*
+  ** Partial updates may not include the statistics rectangle.
+  */
+
+  viewport()->update(m_statisticsRect);
+}
@@ -28,7 +28,10 @@
 #ifndef _glitch_graphicsview_h_
 #define _glitch_graphicsview_h_
 
+#include <QElapsedTimer>
 #include <QGraphicsView>
+#include <QTimer>
+#include <QVector>
 
 class glitch_graphicsview: public QGraphicsView
 {
@@ -37,11 +40,35 @@ class glitch_graphicsview: public QGraphicsView
  public:
   glitch_graphicsview(QWidget *parent);
   bool containsFunction(const QString &name) const;
+  bool statisticsVisible(void) const;
+  void setStatisticsVisible(const bool state);
+
+ private:
+  QElapsedTimer m_paintTimer;
+  QRect m_statisticsRect;
+  QTimer m_statisticsTimer;
+  QVector<qint64> m_paintTimes;
+  bool m_showStatistics;
+  int m_paintTimesIndex;
+  int m_totalProxies;
+  int m_undoChildren;
+  int m_undoCommands;
+  int m_undoIndex;
+  int m_visibleProxies;
+  qint64 m_exposedArea;
+  qint64 percentile(const int p) const;
+  void drawStatistics(QPainter *painter);
+
+ private slots:
+  void slotToggleStatistics(void);
+  void slotUpdateStatistics(void);
 
  protected:
+  void drawForeground(QPainter *painter, const QRectF &rect);
   void enterEvent(QEvent *event);
   void leaveEvent(QEvent *event);
   void mousePressEvent(QMouseEvent *event);
+  void paintEvent(QPaintEvent *event);
 
  signals:
   void mouseEnterEvent(void);
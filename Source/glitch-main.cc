@@ -37,19 +37,47 @@
 #endif
 #endif
 
+#include "Arduino/glitch-native-arduino.h"
+#include "Arduino/glitch-simulator-arduino.h"
+#include "glitch-batch-export.h"
+#include "glitch-diagram-generator.h"
+#include "glitch-diagram-statistics.h"
 #include "glitch-misc.h"
+#include "glitch-trace.h"
 #include "glitch-ui.h"
 #include "glitch-version.h"
 
 int main(int argc, char *argv[])
 {
+  /*
+  ** Tracing is enabled first so that every mode is traced.
+  */
+
+  glitch_trace::enable(qgetenv("GLITCH_TRACE"));
+
+  for(int i = 0; i < argc; i++)
+    if(argv && argv[i] && strncmp(argv[i], "--trace=", 8) == 0)
+      glitch_trace::enable(argv[i] + 8);
+
   for(int i = 0; i < argc; i++)
     if(argv && argv[i] && strcmp(argv[i], "--help") == 0)
       {
 	std::cout << "Glitch [options]" << std::endl;
+	std::cout << "--batch-export directory" << std::endl;
+	std::cout << "--diagram-statistics file-name" << std::endl;
+	std::cout << "--generate-diagram file-name [canvas=n] [clones=n] "
+		  << "[functions=n] [nesting=n] [objects=n] [stylesheets=n]"
+		  << std::endl;
 	std::cout << "--help" << std::endl;
 	std::cout << "--new-arduino-diagram name" << std::endl;
 	std::cout << "--open-arduino-diagram absolute-file-name" << std::endl;
+	std::cout << "--run-native file-name [iterations=n] [a0=n ... a5=n] "
+		  << "[d0=n ... d19=n] [optimize=n]"
+		  << std::endl;
+	std::cout << "--simulate file-name [iterations=n] [a0=n ... a5=n] "
+		  << "[d0=n ... d19=n] [interval=n] [seek=n]"
+		  << std::endl;
+	std::cout << "--trace=file-name" << std::endl;
 	std::cout << "--version" << std::endl;
 	return EXIT_SUCCESS;
       }
@@ -59,6 +87,121 @@ int main(int argc, char *argv[])
 		  << std::endl;
 	return EXIT_SUCCESS;
       }
+    else if(argv && argv[i] && strcmp(argv[i], "--batch-export") == 0)
+      {
+	/*
+	** A display is not required.
+	*/
+
+	QCoreApplication qcoreapplication(argc, argv);
+
+	QCoreApplication::setApplicationName("Glitch");
+	QCoreApplication::setApplicationVersion(GLITCH_VERSION_STR);
+
+	if(i + 1 < argc && argv[i + 1])
+	  return glitch_batch_export::exec(argv[i + 1]);
+
+	std::cerr << "Incorrect usage of --batch-export." << std::endl;
+	return EXIT_FAILURE;
+      }
+    else if(argv && argv[i] && strcmp(argv[i], "--diagram-statistics") == 0)
+      {
+	/*
+	** Widgets are required. A display is not.
+	*/
+
+	if(qgetenv("QT_QPA_PLATFORM").isEmpty())
+	  qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication qapplication(argc, argv);
+
+	QCoreApplication::setApplicationName("Glitch");
+	QCoreApplication::setApplicationVersion(GLITCH_VERSION_STR);
+
+	if(i + 1 < argc && argv[i + 1])
+	  return glitch_diagram_statistics::dump(argv[i + 1]);
+
+	std::cerr << "Incorrect usage of --diagram-statistics." << std::endl;
+	return EXIT_FAILURE;
+      }
+    else if(argv && argv[i] && strcmp(argv[i], "--generate-diagram") == 0)
+      {
+	QCoreApplication qcoreapplication(argc, argv);
+
+	QCoreApplication::setApplicationName("Glitch");
+	QCoreApplication::setApplicationVersion(GLITCH_VERSION_STR);
+
+	if(!(i + 1 < argc && argv[i + 1]))
+	  {
+	    std::cerr << "Incorrect usage of --generate-diagram."
+		      << std::endl;
+	    return EXIT_FAILURE;
+	  }
+
+	QStringList arguments;
+
+	for(int j = i + 2; j < argc; j++)
+	  if(argv[j] && strncmp(argv[j], "--", 2) != 0)
+	    arguments << argv[j];
+	  else
+	    break;
+
+	return glitch_diagram_generator::exec(argv[i + 1], arguments);
+      }
+    else if(argv && argv[i] && strcmp(argv[i], "--run-native") == 0)
+      {
+	/*
+	** A display is not required.
+	*/
+
+	QCoreApplication qcoreapplication(argc, argv);
+
+	QCoreApplication::setApplicationName("Glitch");
+	QCoreApplication::setApplicationVersion(GLITCH_VERSION_STR);
+
+	if(!(i + 1 < argc && argv[i + 1]))
+	  {
+	    std::cerr << "Incorrect usage of --run-native." << std::endl;
+	    return EXIT_FAILURE;
+	  }
+
+	QStringList arguments;
+
+	for(int j = i + 2; j < argc; j++)
+	  if(argv[j] && strncmp(argv[j], "--", 2) != 0)
+	    arguments << argv[j];
+	  else
+	    break;
+
+	return glitch_native_arduino::exec(argv[i + 1], arguments);
+      }
+    else if(argv && argv[i] && strcmp(argv[i], "--simulate") == 0)
+      {
+	/*
+	** A display is not required.
+	*/
+
+	QCoreApplication qcoreapplication(argc, argv);
+
+	QCoreApplication::setApplicationName("Glitch");
+	QCoreApplication::setApplicationVersion(GLITCH_VERSION_STR);
+
+	if(!(i + 1 < argc && argv[i + 1]))
+	  {
+	    std::cerr << "Incorrect usage of --simulate." << std::endl;
+	    return EXIT_FAILURE;
+	  }
+
+	QStringList arguments;
+
+	for(int j = i + 2; j < argc; j++)
+	  if(argv[j] && strncmp(argv[j], "--", 2) != 0)
+	    arguments << argv[j];
+	  else
+	    break;
+
+	return glitch_simulator_arduino::exec(argv[i + 1], arguments);
+      }
 
   QApplication qapplication(argc, argv);
 
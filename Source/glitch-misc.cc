@@ -29,17 +29,10 @@
 #include <QDir>
 #include <QIcon>
 #include <QMessageBox>
+#include <QWidget>
 
 #include "glitch-misc.h"
 
-QPointF glitch_misc::dbPointToPointF(const QString &text)
-{
-  QStringList list(QString(text).remove("(").remove(")").split(","));
-
-  return {qAbs(list.value(0).toDouble()),
-	  qAbs(list.value(1).toDouble())};
-}
-
 QString glitch_misc::homePath(void)
 {
   QByteArray homepath(qgetenv("GLITCH_HOME"));
@@ -54,6 +47,34 @@ QString glitch_misc::homePath(void)
     return homepath.constData();
 }
 
+qint64 glitch_misc::memoryEstimate(const QObject *object)
+{
+  /*
+  ** The sizes of Qt's private structures are approximations of
+  ** Qt 5 on 64-bit hosts.
+  */
+
+  if(!object)
+    return 0;
+
+  auto widget = qobject_cast<const QWidget *> (object);
+  qint64 bytes = 0;
+
+  if(widget)
+    bytes += static_cast<qint64> (sizeof(QWidget)) +
+      720 +
+      2 * widget->styleSheet().size();
+  else
+    bytes += static_cast<qint64> (sizeof(QObject)) + 120;
+
+  bytes += 2 * object->objectName().size();
+
+  for(auto child : object->children())
+    bytes += memoryEstimate(child);
+
+  return bytes;
+}
+
 void glitch_misc::showErrorDialog(const QString &text, QWidget *parent)
 {
   QMessageBox mb(parent);
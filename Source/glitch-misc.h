@@ -34,8 +34,8 @@
 class glitch_misc
 {
  public:
-  static QPointF dbPointToPointF(const QString &text);
   static QString homePath(void);
+  static qint64 memoryEstimate(const QObject *object);
   static void showErrorDialog(const QString &text, QWidget *parent);
 
  private:
@@ -0,0 +1,166 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QAction>
+
+#include "glitch-floating-context-menu.h"
+#include "glitch-object-actions.h"
+
+glitch_object_actions::glitch_object_actions(QWidget *parent):QObject(parent)
+{
+  m_parent = parent;
+}
+
+glitch_object_actions::~glitch_object_actions()
+{
+  if(m_floatingContextMenu)
+    m_floatingContextMenu->deleteLater();
+}
+
+QAction *glitch_object_actions::action
+(const glitch_object::DefaultMenuActions action) const
+{
+  return m_actions.value(action);
+}
+
+QAction *glitch_object_actions::bind
+(const glitch_object::DefaultMenuActions action,
+ glitch_object *object,
+ const char *member)
+{
+  /*
+  ** The actions are shared by the objects of a view. An action is
+  ** created on first use. The actions are connected to a single object,
+  ** the object whose menu was most recently requested.
+  */
+
+  if(!object || !member)
+    return nullptr;
+
+  if(m_object != object)
+    {
+      closeFloatingContextMenu(m_object);
+
+      if(m_object)
+	for(auto a : m_actions)
+	  disconnect(a, nullptr, m_object, nullptr);
+
+      m_object = object;
+    }
+
+  auto a = m_actions.value(action);
+
+  if(!a)
+    {
+      a = new QAction(text(action), this);
+      a->setCheckable(action == glitch_object::DefaultMenuActions::
+		      LOCK_POSITION);
+      a->setData(action);
+      m_actions[action] = a;
+    }
+
+  a->setEnabled(true);
+  connect(a,
+	  SIGNAL(triggered(void)),
+	  object,
+	  member,
+	  Qt::UniqueConnection);
+  return a;
+}
+
+QString glitch_object_actions::text
+(const glitch_object::DefaultMenuActions action)
+{
+  switch(action)
+    {
+    case glitch_object::DefaultMenuActions::DELETE:
+      {
+	return tr("&Delete");
+      }
+    case glitch_object::DefaultMenuActions::EDIT:
+      {
+	return tr("&Edit...");
+      }
+    case glitch_object::DefaultMenuActions::LOCK_POSITION:
+      {
+	return tr("&Lock Position");
+      }
+    case glitch_object::DefaultMenuActions::SET_FUNCTION_NAME:
+      {
+	return tr("Set Function &Name...");
+      }
+    case glitch_object::DefaultMenuActions::SET_STYLE_SHEET:
+      {
+	return tr("&Set Style Sheet...");
+      }
+    default:
+      {
+	break;
+      }
+    }
+
+  return "";
+}
+
+glitch_object *glitch_object_actions::object(void) const
+{
+  return m_object;
+}
+
+int glitch_object_actions::count(void) const
+{
+  return m_actions.size();
+}
+
+void glitch_object_actions::closeFloatingContextMenu
+(const glitch_object *object)
+{
+  if(m_floatingContextMenu && m_object == object)
+    m_floatingContextMenu->close();
+}
+
+void glitch_object_actions::showFloatingContextMenu
+(glitch_object *object, const QList<QAction *> &actions)
+{
+  /*
+  ** The floating menu holds the shared actions, which are connected
+  ** to one object at a time. A view therefore has one floating menu.
+  ** Requesting the menu of another object closes it.
+  */
+
+  if(!object || m_object != object)
+    return;
+
+  if(!m_floatingContextMenu)
+    m_floatingContextMenu = new glitch_floating_context_menu(m_parent);
+
+  m_floatingContextMenu->addActions(actions);
+  m_floatingContextMenu->setWindowTitle
+    (tr("Glitch: Floating Context Menu (%1)").
+     arg(object->name().isEmpty() ? object->type() : object->name()));
+  m_floatingContextMenu->show();
+}
@@ -0,0 +1,63 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_object_actions_h_
+#define _glitch_object_actions_h_
+
+#include <QMap>
+#include <QPointer>
+
+#include "glitch-object.h"
+
+class glitch_floating_context_menu;
+
+class glitch_object_actions: public QObject
+{
+  Q_OBJECT
+
+ public:
+  glitch_object_actions(QWidget *parent);
+  ~glitch_object_actions();
+  QAction *action(const glitch_object::DefaultMenuActions action) const;
+  QAction *bind(const glitch_object::DefaultMenuActions action,
+		glitch_object *object,
+		const char *member);
+  glitch_object *object(void) const;
+  int count(void) const;
+  void closeFloatingContextMenu(const glitch_object *object);
+  void showFloatingContextMenu(glitch_object *object,
+			       const QList<QAction *> &actions);
+
+ private:
+  QMap<glitch_object::DefaultMenuActions, QAction *> m_actions;
+  QPointer<QWidget> m_parent;
+  QPointer<glitch_floating_context_menu> m_floatingContextMenu;
+  QPointer<glitch_object> m_object;
+  static QString text(const glitch_object::DefaultMenuActions action);
+};
+
+#endif
@@ -29,11 +29,14 @@
 #include <QSqlError>
 #include <QTimer>
 
+#include "Arduino/glitch-code-generator-arduino.h"
 #include "glitch-alignment.h"
+#include "glitch-misc.h"
 #include "glitch-object.h"
 #include "glitch-object-view.h"
 #include "glitch-proxy-widget.h"
 #include "glitch-scene.h"
+#include "glitch-trace.h"
 #include "glitch-ui.h"
 #include "glitch-view.h"
 
@@ -42,6 +45,7 @@ glitch_object_view::glitch_object_view
  const quint64 id,
  QWidget *parent):QGraphicsView(parent)
 {
+  m_codeIsValid = false;
   m_id = id;
   m_projectType = projectType;
   m_scene = new glitch_scene(m_projectType, this);
@@ -62,10 +66,18 @@ glitch_object_view::glitch_object_view
 	  SIGNAL(changed(void)),
 	  this,
 	  SIGNAL(changed(void)));
+  connect(m_scene,
+	  SIGNAL(changed(void)),
+	  this,
+	  SLOT(slotInvalidateCode(void)));
   connect(m_scene,
 	  SIGNAL(sceneResized(void)),
 	  this,
 	  SLOT(slotSceneResized(void)));
+  connect(m_undoStack,
+	  SIGNAL(indexChanged(int)),
+	  this,
+	  SLOT(slotInvalidateCode(void)));
   connect(this,
 	  SIGNAL(customContextMenuRequested(const QPoint &)),
 	  this,
@@ -78,6 +90,48 @@ glitch_object_view::~glitch_object_view()
     m_alignment->deleteLater();
 }
 
+QString glitch_object_view::code(void)
+{
+  GLITCH_TRACE_SCOPE("glitch_object_view::code");
+
+  /*
+  ** The generated source of the view's objects. The source is
+  ** regenerated only if the view has changed since the last request
+  ** and if the structure of the view's objects differs.
+  */
+
+  if(m_codeIsValid)
+    return m_code;
+
+  QList<QMap<QString, QVariant> > statements(this->statements());
+
+  m_codeIsValid = true;
+
+  switch(m_projectType)
+    {
+    case glitch_common::ArduinoProject:
+      {
+	QByteArray hash(glitch_code_generator_arduino::hash(statements));
+
+	if(hash != m_codeHash)
+	  {
+	    m_code = glitch_code_generator_arduino::body(statements);
+	    m_codeHash = hash;
+	  }
+
+	break;
+      }
+    default:
+      {
+	m_code.clear();
+	m_codeHash.clear();
+	break;
+      }
+    }
+
+  return m_code;
+}
+
 QUndoStack *glitch_object_view::undoStack(void) const
 {
   return m_undoStack;
@@ -88,6 +142,48 @@ glitch_scene *glitch_object_view::scene(void) const
   return m_scene;
 }
 
+QList<QMap<QString, QVariant> > glitch_object_view::statements(void) const
+{
+  /*
+  ** The values of the view's objects in the order of interpretation.
+  ** The scene maintains the positional order.
+  */
+
+  QList<QMap<QString, QVariant> > statements;
+
+  for(auto object : m_scene->orderedObjects())
+    statements << object->values();
+
+  glitch_code_generator_arduino::order(statements, m_scene->wireGraph());
+  return statements;
+}
+
+QList<glitch_object *> glitch_object_view::objects(void) const
+{
+  return m_scene->objects();
+}
+
+qint64 glitch_object_view::memoryEstimate(void) const
+{
+  /*
+  ** The view's window, the view, the scene, the undo stack, and the
+  ** objects. Nested views are included.
+  */
+
+  qint64 bytes = glitch_misc::memoryEstimate(window());
+
+  for(auto object : m_scene->objects())
+    if(object)
+      {
+	bytes += object->memoryEstimate();
+
+	if(object->editView())
+	  bytes += object->editView()->memoryEstimate();
+      }
+
+  return bytes;
+}
+
 quint64 glitch_object_view::id(void) const
 {
   return m_id;
@@ -139,6 +235,9 @@ void glitch_object_view::save(const QSqlDatabase &db, QString &error)
       if(!error.isEmpty())
 	break;
     }
+
+  if(error.isEmpty())
+    m_scene->saveWires(db, static_cast<qint64> (m_id), error);
 }
 
 void glitch_object_view::setSceneRect(const QSize &size)
@@ -164,6 +263,21 @@ void glitch_object_view::slotCustomContextMenuRequested(const QPoint &point)
   menu.addAction(tr("&Alignment Tool..."),
 		 this,
 		 SLOT(slotShowAlignment(void)));
+  menu.addSeparator();
+  menu.addAction(tr("&Connect Selected Objects"),
+		 m_scene,
+		 SLOT(slotWireSelectedObjects(void)));
+  menu.addAction(tr("D&isconnect Selected Objects"),
+		 m_scene,
+		 SLOT(slotUnwireSelectedObjects(void)));
+  menu.addSeparator();
+
+  auto action = menu.addAction(tr("Show Statement &Order"),
+			       m_scene,
+			       SLOT(slotShowOrderHints(bool)));
+
+  action->setCheckable(true);
+  action->setChecked(m_scene->showOrderHints());
   menu.exec(mapToGlobal(point));
 }
 
@@ -172,6 +286,11 @@ void glitch_object_view::slotDelete(void)
   m_scene->deleteItems();
 }
 
+void glitch_object_view::slotInvalidateCode(void)
+{
+  m_codeIsValid = false;
+}
+
 void glitch_object_view::slotParentWindowClosed(void)
 {
   if(m_alignment)
@@ -190,6 +309,7 @@ void glitch_object_view::slotRedo(void)
     {
       m_undoStack->redo();
       adjustScrollBars();
+      emit changed();
     }
 }
 
@@ -233,5 +353,6 @@ void glitch_object_view::slotUndo(void)
     {
       m_undoStack->undo();
       adjustScrollBars();
+      emit changed();
     }
 }
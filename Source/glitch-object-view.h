@@ -48,16 +48,23 @@ class glitch_object_view: public QGraphicsView
 		     const quint64 id,
 		     QWidget *parent);
   ~glitch_object_view();
+  QList<QMap<QString, QVariant> > statements(void) const;
+  QList<glitch_object *> objects(void) const;
+  QString code(void);
   QUndoStack *undoStack(void) const;
   glitch_scene* scene(void) const;
+  qint64 memoryEstimate(void) const;
   quint64 id(void) const;
   void artificialDrop(const QPointF &point, glitch_object *object);
   void save(const QSqlDatabase &db, QString &error);
   void setSceneRect(const QSize &size);
 
  private:
+  QByteArray m_codeHash;
   QPointer<glitch_alignment> m_alignment;
+  QString m_code;
   QUndoStack *m_undoStack;
+  bool m_codeIsValid;
   glitch_common::ProjectType m_projectType;
   glitch_scene *m_scene;
   quint64 m_id;
@@ -76,6 +83,9 @@ class glitch_object_view: public QGraphicsView
   void slotShowAlignment(void);
   void slotUndo(void);
 
+ public slots:
+  void slotInvalidateCode(void);
+
  signals:
   void changed(void);
   void copy(void);
@@ -26,14 +26,17 @@
 */
 
 #include <QScrollBar>
-#include <QSqlError>
-#include <QSqlQuery>
 #include <QUndoStack>
 #include <QtDebug>
 
+#include <algorithm>
+
+#include "Arduino/glitch-code-generator-arduino.h"
 #include "Arduino/glitch-object-analog-read-arduino.h"
 #include "Arduino/glitch-object-function-arduino.h"
-#include "glitch-floating-context-menu.h"
+#include "glitch-diagram-object.h"
+#include "glitch-object-actions.h"
+#include "glitch-misc.h"
 #include "glitch-object-view.h"
 #include "glitch-object.h"
 #include "glitch-scene.h"
@@ -41,13 +44,32 @@
 #include "glitch-undo-command.h"
 #include "glitch-view.h"
 
+static bool action_less_than(QAction *a1, QAction *a2)
+{
+  return a1->data().toInt() < a2->data().toInt();
+}
+
+static QString property_name(const glitch_object::Properties property)
+{
+  switch(property)
+    {
+    case glitch_object::POSITION_LOCKED:
+      {
+	return "position_locked";
+      }
+    default:
+      {
+	return "";
+      }
+    }
+}
+
 glitch_object::glitch_object(QWidget *parent):QWidget(nullptr)
 {
-  m_contextMenu = new glitch_floating_context_menu(parent);
   m_id = 1;
   m_initialized = false;
   m_parent = parent;
-  m_properties[Properties::POSITION_LOCKED] = false;
+  m_model.setProperty("position_locked", false);
 
   auto p = parent;
 
@@ -71,18 +93,14 @@ glitch_object::glitch_object(QWidget *parent):QWidget(nullptr)
 
 glitch_object::glitch_object(const quint64 id, QWidget *parent):QWidget(nullptr)
 {
-  m_contextMenu = new glitch_floating_context_menu(parent);
   m_id = id;
   m_initialized = false;
   m_parent = parent;
-  m_properties[Properties::POSITION_LOCKED] = false;
+  m_model.setProperty("position_locked", false);
 }
 
 glitch_object::~glitch_object()
 {
-  if(m_contextMenu)
-    m_contextMenu->deleteLater();
-
   qDebug() << "Done!";
 }
 
@@ -99,9 +117,45 @@ QPointer<glitch_proxy_widget> glitch_object::proxy(void) const
   return m_proxy;
 }
 
+QMap<QString, QVariant> glitch_object::values(void) const
+{
+  /*
+  ** The values of an object, as understood by createFromValues(). The
+  ** model holds the object's properties and style sheet. The object's
+  ** placement is read from its widget.
+  */
+
+  auto values(m_model.properties());
+
+  if(qobject_cast<glitch_object_view *> (m_parent))
+    values["parentId"] = qobject_cast<glitch_object_view *> (m_parent)->id();
+  else
+    values["parentId"] = -1;
+
+  values["myoid"] = m_id;
+  values["position"] = QPointF(pos());
+  values["stylesheet"] = m_model.styleSheet();
+  values["type"] = m_type;
+  return values;
+}
+
+QString glitch_object::code(void) const
+{
+  return "";
+}
+
 QString glitch_object::name(void) const
 {
-  return m_name;
+  return m_model.property("name").toString();
+}
+
+QString glitch_object::styleSheet(void) const
+{
+  /*
+  ** The object's own style sheet. The theme of its type is not included.
+  */
+
+  return m_model.styleSheet();
 }
 
 QString glitch_object::type(void) const
@@ -109,6 +163,25 @@ QString glitch_object::type(void) const
   return m_type;
 }
 
+QList<QMap<QString, QVariant> > glitch_object::statements(void) const
+{
+  /*
+  ** The values of the object's children in the order of
+  ** interpretation.
+  */
+
+  if(m_editView)
+    return m_editView->statements();
+  else
+    return glitch_code_generator_arduino::statements
+      (m_pendingChildren, m_pendingWires);
+}
+
+QList<glitch_diagram_object> glitch_object::pendingChildren(void) const
+{
+  return m_pendingChildren;
+}
+
 bool glitch_object::mouseOverScrollBar(const QPointF &point) const
 {
   foreach(auto scrollBar, findChildren<QScrollBar *> ())
@@ -123,7 +196,7 @@ bool glitch_object::mouseOverScrollBar(const QPointF &point) const
 
 bool glitch_object::positionLocked(void) const
 {
-  return m_properties.value(Properties::POSITION_LOCKED).toBool();
+  return m_model.property("position_locked").toBool();
 }
 
 glitch_object *glitch_object::createFromValues
@@ -149,88 +222,187 @@ glitch_object *glitch_object::createFromValues
   return object;
 }
 
+glitch_object_actions *glitch_object::objectActions(void) const
+{
+  auto scene = m_proxy ?
+    qobject_cast<glitch_scene *> (m_proxy->scene()) : nullptr;
+
+  if(scene)
+    return scene->objectActions();
+  else
+    return nullptr;
+}
+
 glitch_object_view *glitch_object::editView(void) const
 {
   return nullptr;
 }
 
+glitch_wire_graph glitch_object::pendingWires(void) const
+{
+  return m_pendingWires;
+}
+
 quint64 glitch_object::id(void) const
 {
   return m_id;
 }
 
+qint64 glitch_object::memoryEstimate(void) const
+{
+  /*
+  ** The object and its proxy. The object's edit view is estimated
+  ** separately. Context menu actions are shared by the view's objects.
+  */
+
+  qint64 bytes = glitch_misc::memoryEstimate(this);
+
+  if(m_proxy)
+    bytes += static_cast<qint64> (sizeof(glitch_proxy_widget)) + 360;
+
+  for(const auto &child : m_pendingChildren)
+    bytes += child.memoryEstimate();
+
+  return bytes;
+}
+
 void glitch_object::addChild(const QPointF &point, glitch_object *object)
 {
   Q_UNUSED(object);
   Q_UNUSED(point);
 }
 
+QAction *glitch_object::addSharedAction
+(QMenu &menu, const DefaultMenuActions action, const char *member)
+{
+  /*
+  ** The view's action is connected to this object and added to the
+  ** menu.
+  */
+
+  auto actions = objectActions();
+
+  if(!actions)
+    return nullptr;
+
+  auto a = actions->bind(action, this, member);
+
+  if(a)
+    menu.addAction(a);
+
+  return a;
+}
+
 void glitch_object::addDefaultActions(QMenu &menu)
 {
-  createActions();
+  addSharedAction
+    (menu, DefaultMenuActions::DELETE, SIGNAL(deletedViaContextMenu(void)));
+  addSharedAction
+    (menu, DefaultMenuActions::LOCK_POSITION, SLOT(slotLockPosition(void)));
+  addSharedAction
+    (menu, DefaultMenuActions::SET_STYLE_SHEET, SLOT(slotSetStyleSheet(void)));
+
+  auto actions = objectActions();
+
+  if(actions)
+    {
+      auto action = actions->action(DefaultMenuActions::DELETE);
+
+      if(action)
+	action->setEnabled(!isMandatory());
+
+      action = actions->action(DefaultMenuActions::LOCK_POSITION);
+
+      if(action)
+	{
+	  action->setChecked
+	    (positionLocked());
+	  action->setEnabled(!isMandatory());
+	}
+    }
+
+  /*
+  ** Order the menu's actions by their data. Actions having equal
+  ** data, or none, retain their order.
+  */
+
+  QList<QAction *> list;
+
+  for(auto action : menu.actions())
+    if(!action->isSeparator())
+      list << action;
 
-  QMapIterator<DefaultMenuActions, QAction *> it(m_actions);
-  int i = 0;
+  std::stable_sort(list.begin(), list.end(), action_less_than);
+  menu.clear();
 
-  while(it.hasNext())
+  for(int i = 0; i < list.size(); i++)
     {
-      it.next();
-      menu.addAction(it.value());
+      menu.addAction(list.at(i));
 
-      if(i++ == 2 && it.hasNext())
+      if(i == 2 && i + 1 < list.size())
 	menu.addSeparator();
     }
 }
 
-void glitch_object::closeEditWindow(void)
+void glitch_object::addPendingChild(const glitch_diagram_object &child)
 {
+  /*
+  ** Children of an object whose edit view has not been created are
+  ** held in the model. The widgets are created by
+  ** createPendingChildren().
+  */
+
+  if(hasView())
+    m_pendingChildren << child;
 }
 
-void glitch_object::createActions(void)
+void glitch_object::addPendingWire(const qint64 output, const qint64 input)
 {
-  if(!m_actions.contains(DefaultMenuActions::DELETE))
-    {
-      auto action = new QAction(tr("&Delete"), this);
-
-      action->setData(DefaultMenuActions::DELETE);
-      action->setEnabled(!isMandatory());
-      connect(action,
-	      SIGNAL(triggered(void)),
-	      this,
-	      SIGNAL(deletedViaContextMenu(void)));
-      m_actions[DefaultMenuActions::DELETE] = action;
-    }
+  if(hasView())
+    m_pendingWires.addWire(output, input);
+}
 
-  if(!m_actions.contains(DefaultMenuActions::LOCK_POSITION))
-    {
-      auto action = new QAction(tr("&Lock Position"), this);
-
-      action->setCheckable(true);
-      action->setChecked
-	(m_properties.value(Properties::POSITION_LOCKED).toBool());
-      action->setData(DefaultMenuActions::LOCK_POSITION);
-      action->setEnabled(!isMandatory());
-      connect(action,
-	      SIGNAL(triggered(void)),
-	      this,
-	      SLOT(slotLockPosition(void)));
-      m_actions[DefaultMenuActions::LOCK_POSITION] = action;
-    }
+void glitch_object::applyStyleSheets(void)
+{
+  /*
+  ** The object's own style sheet follows the theme so that its
+  ** declarations override the theme's.
+  */
+
+  QString styleSheet;
+
+  if(m_themeStyleSheet.trimmed().isEmpty())
+    styleSheet = m_model.styleSheet();
+  else if(m_model.styleSheet().trimmed().isEmpty())
+    styleSheet = m_themeStyleSheet;
   else
-    m_actions[DefaultMenuActions::LOCK_POSITION]->
-      setChecked(m_properties.value(Properties::POSITION_LOCKED).toBool());
+    styleSheet = m_themeStyleSheet + "\n" + m_model.styleSheet();
+
+  if(QWidget::styleSheet() != styleSheet)
+    QWidget::setStyleSheet(styleSheet);
+}
+
+void glitch_object::closeEditWindow(void)
+{
+}
 
-  if(!m_actions.contains(DefaultMenuActions::SET_STYLE_SHEET))
+void glitch_object::createPendingChildren(void)
+{
+  if(!m_editView)
+    return;
+
+  for(const auto &child : m_pendingChildren)
     {
-      auto action = new QAction(tr("&Set Style Sheet..."), this);
-
-      action->setData(DefaultMenuActions::SET_STYLE_SHEET);
-      connect(action,
-	      SIGNAL(triggered(void)),
-	      this,
-	      SLOT(slotSetStyleSheet(void)));
-      m_actions[DefaultMenuActions::SET_STYLE_SHEET] = action;
+      QString error("");
+
+      m_editView->artificialDrop
+	(child.position(),
+	 createFromValues(child.values(), error, m_editView));
     }
+
+  m_editView->scene()->addWires(m_pendingWires);
+  m_pendingChildren.clear();
+  m_pendingWires.clear();
 }
 
 void glitch_object::move(const QPoint &point)
@@ -240,7 +412,7 @@ void glitch_object::move(const QPoint &point)
 
 void glitch_object::move(int x, int y)
 {
-  if(m_properties.value(Properties::POSITION_LOCKED).toBool())
+  if(positionLocked())
     return;
 
   bool isChanged = false;
@@ -271,69 +443,24 @@ void glitch_object::prepareContextMenu(void)
 
 void glitch_object::save(const QSqlDatabase &db, QString &error)
 {
-  QSqlQuery query(db);
-
-  query.prepare("INSERT OR REPLACE INTO objects "
-		"(myoid, parent_oid, position, stylesheet, type) "
-		"VALUES(?, ?, ?, ?, ?)");
-  query.addBindValue(m_id);
+  glitch_diagram_object(values()).save(db, error);
 
-  if(qobject_cast<glitch_object_view *> (m_parent))
-    query.addBindValue(qobject_cast<glitch_object_view *> (m_parent)->id());
-  else
-    query.addBindValue(-1);
-
-  query.addBindValue(QString("(%1,%2)").arg(pos().x()).arg(pos().y()));
-  query.addBindValue(styleSheet());
-  query.addBindValue(m_type);
-  query.exec();
-
-  if(query.lastError().isValid())
-    error = query.lastError().text();
-
-  if(error.isEmpty())
-    saveProperties(QMap<QString, QVariant> (), db, error);
-}
-
-void glitch_object::saveProperties(const QMap<QString, QVariant> &p,
-				   const QSqlDatabase &db,
-				   QString &error)
-{
-  QMap<QString, QVariant> properties(p);
-
-  properties["position_locked"] = m_properties.value
-    (Properties::POSITION_LOCKED).toBool();
-
-  QMapIterator<QString, QVariant> it(properties);
-  QSqlQuery query(db);
-  QString string("");
-
-  while(it.hasNext())
+  for(const auto &child : m_pendingChildren)
     {
-      it.next();
-      string.append(it.key());
-      string.append(" = ");
-      string.append("\"");
-      string.append(it.value().toString());
-      string.append("\"");
-
-      if(it.hasNext())
-	string.append("&");
-    }
+      if(!error.isEmpty())
+	break;
 
-  query.prepare("UPDATE objects SET properties = ? WHERE myoid = ?");
-  query.addBindValue(string);
-  query.addBindValue(m_id);
-  query.exec();
+      child.save(db, error);
+    }
 
-  if(query.lastError().isValid())
-    error = query.lastError().text();
+  if(error.isEmpty())
+    m_pendingWires.save(db, static_cast<qint64> (m_id), error);
 }
 
 void glitch_object::setName(const QString &name)
 {
   if(!name.trimmed().isEmpty())
-    m_name = name.trimmed();
+    m_model.setProperty("name", name.trimmed());
 }
 
 void glitch_object::setProperties(const QStringList &list)
@@ -344,24 +471,29 @@ void glitch_object::setProperties(const QStringList &list)
 	QString str(list.at(i).mid(18));
 
 	str.remove("\"");
-	m_properties[Properties::POSITION_LOCKED] = QVariant(str).toBool();
+	m_model.setProperty("position_locked", QVariant(str).toBool());
       }
-
-  createActions();
 }
 
 void glitch_object::setProperty(const Properties property,
 				const QVariant &value)
 {
-  m_properties[property] = value;
+  if(!property_name(property).isEmpty())
+    m_model.setProperty(property_name(property), value);
 
   switch(property)
     {
     case Properties::POSITION_LOCKED:
       {
-	if(m_actions.contains(DefaultMenuActions::LOCK_POSITION))
-	  m_actions.value(DefaultMenuActions::LOCK_POSITION)->setChecked
-	    (value.toBool());
+	auto actions = objectActions();
+
+	if(actions && actions->object() == this)
+	  {
+	    auto action = actions->action(DefaultMenuActions::LOCK_POSITION);
+
+	    if(action)
+	      action->setChecked(value.toBool());
+	  }
 
 	if(m_proxy)
 	  m_proxy->setFlag(QGraphicsItem::ItemIsMovable, !value.toBool());
@@ -375,6 +507,13 @@ void glitch_object::setProperty(const Properties property,
     }
 }
 
+void glitch_object::setPendingChildren
+(const QList<glitch_diagram_object> &children)
+{
+  if(hasView() && !m_editView)
+    m_pendingChildren = children;
+}
+
 void glitch_object::setProxy(const QPointer<glitch_proxy_widget> &proxy)
 {
   m_proxy = proxy;
@@ -382,7 +521,22 @@ void glitch_object::setProxy(const QPointer<glitch_proxy_widget> &proxy)
   if(m_proxy)
     m_proxy->setFlag
       (QGraphicsItem::ItemIsMovable,
-       !m_properties.value(Properties::POSITION_LOCKED).toBool());
+       !positionLocked());
+}
+
+void glitch_object::setStyleSheet(const QString &styleSheet)
+{
+  m_model.setStyleSheet(styleSheet);
+  applyStyleSheets();
+}
+
+void glitch_object::setThemeStyleSheet(const QString &styleSheet)
+{
+  if(m_themeStyleSheet == styleSheet)
+    return;
+
+  m_themeStyleSheet = styleSheet;
+  applyStyleSheets();
 }
 
 void glitch_object::setUndoStack(QUndoStack *undoStack)
@@ -396,7 +550,10 @@ void glitch_object::setUndoStack(QUndoStack *undoStack)
 
 void glitch_object::simulateDelete(void)
 {
-  m_contextMenu->close();
+  auto actions = objectActions();
+
+  if(actions)
+    actions->closeFloatingContextMenu(this);
 }
 
 void glitch_object::slotLockPosition(void)
@@ -404,8 +561,8 @@ void glitch_object::slotLockPosition(void)
   if(m_undoStack)
     {
       auto undoCommand = new glitch_undo_command
-	(!m_properties.value(Properties::POSITION_LOCKED).toBool(),
-	 m_properties.value(Properties::POSITION_LOCKED),
+	(!positionLocked(),
+	 positionLocked(),
 	 glitch_undo_command::PROPERTY_CHANGED,
 	 Properties::POSITION_LOCKED,
 	 this);
@@ -416,8 +573,7 @@ void glitch_object::slotLockPosition(void)
       m_undoStack->push(undoCommand);
     }
   else
-    m_properties[Properties::POSITION_LOCKED] =
-      !m_properties.value(Properties::POSITION_LOCKED).toBool();
+    m_model.setProperty("position_locked", !positionLocked());
 
   emit changed();
 }
@@ -432,6 +588,33 @@ void glitch_object::slotSetStyleSheet(void)
 
   if(dialog->exec() == QDialog::Accepted)
     {
+      auto scene = m_proxy ?
+	qobject_cast<glitch_scene *> (m_proxy->scene()) : nullptr;
+
+      if(scene)
+	{
+	  /*
+	  ** The style sheet is applied to the selected objects if this
+	  ** object is selected.
+	  */
+
+	  QList<glitch_object *> objects;
+
+	  if(m_proxy->isSelected())
+	    objects = scene->selectedObjects();
+
+	  if(!objects.contains(this))
+	    objects << this;
+
+	  auto styleSheet(dialog->styleSheet());
+
+	  if(this->styleSheet() != string)
+	    setStyleSheet(string); // Previewed.
+
+	  scene->applyStyleSheet(objects, styleSheet);
+	  return;
+	}
+
       setStyleSheet(dialog->styleSheet());
 
       if(m_undoStack)
@@ -453,9 +636,13 @@ void glitch_object::slotSetStyleSheet(void)
 
 void glitch_object::slotShowContextMenu(void)
 {
-  QMenu menu; // Not used.
+  auto actions = objectActions();
+
+  if(!actions)
+    return;
+
+  QMenu menu; // Not shown.
 
   addActions(menu);
-  m_contextMenu->addActions(m_actions.values());
-  m_contextMenu->show();
+  actions->showFloatingContextMenu(this, menu.actions());
 }
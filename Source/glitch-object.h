@@ -33,10 +33,12 @@
 #include <QSqlDatabase>
 #include <QWidget>
 
+#include "glitch-diagram-object.h"
 #include "glitch-proxy-widget.h"
+#include "glitch-wire-graph.h"
 
 class QUndoStack;
-class glitch_floating_context_menu;
+class glitch_object_actions;
 class glitch_object_view;
 
 class glitch_object: public QWidget
@@ -61,19 +63,26 @@ class glitch_object: public QWidget
 
   glitch_object(QWidget *parent);
   glitch_object(const quint64 id, QWidget *parent);
+  QList<QMap<QString, QVariant> > statements(void) const;
+  QList<glitch_diagram_object> pendingChildren(void) const;
   QPointF scenePos(void) const;
   QPointer<glitch_proxy_widget> proxy(void) const;
+  QString styleSheet(void) const;
   QString type(void) const;
   bool mouseOverScrollBar(const QPointF &point) const;
   bool positionLocked(void) const;
+  glitch_wire_graph pendingWires(void) const;
   quint64 id(void) const;
   static glitch_object *createFromValues
     (const QMap<QString, QVariant> &values, QString &error, QWidget *parent);
+  virtual QMap<QString, QVariant> values(void) const;
+  virtual QString code(void) const;
   virtual QString name(void) const;
   virtual bool hasView(void) const = 0;
   virtual bool isMandatory(void) const = 0;
   virtual glitch_object *clone(QWidget *parent) const = 0;
   virtual glitch_object_view *editView(void) const;
+  virtual qint64 memoryEstimate(void) const;
   virtual void addActions(QMenu &menu) = 0;
   virtual void addChild(const QPointF &point, glitch_object *object);
   virtual void closeEditWindow(void);
@@ -81,37 +90,44 @@ class glitch_object: public QWidget
   virtual void setName(const QString &name);
   virtual void setProperty(const Properties property, const QVariant &value);
   virtual ~glitch_object();
+  void addPendingChild(const glitch_diagram_object &child);
+  void addPendingWire(const qint64 output, const qint64 input);
   void move(const QPoint &point);
   void move(int x, int y);
+  void setPendingChildren(const QList<glitch_diagram_object> &children);
   void setProxy(const QPointer<glitch_proxy_widget> &proxy);
+  void setStyleSheet(const QString &styleSheet);
+  void setThemeStyleSheet(const QString &styleSheet);
   void setUndoStack(QUndoStack *undoStack);
   void simulateDelete(void);
 
  private:
+  QString m_themeStyleSheet;
   static quint64 s_id;
+  void applyStyleSheets(void);
 
  private slots:
   void slotLockPosition(void);
   void slotShowContextMenu(void);
 
  protected:
-  QHash<Properties, QVariant> m_properties;
-  QMap<DefaultMenuActions, QAction *> m_actions;
+  QList<glitch_diagram_object> m_pendingChildren;
   QPointer<QUndoStack> m_undoStack;
   QPointer<QWidget> m_parent;
-  QPointer<glitch_floating_context_menu> m_contextMenu;
   QPointer<glitch_object_view> m_editView;
   QPointer<glitch_proxy_widget> m_proxy;
-  QString m_name;
   QString m_type;
   bool m_initialized;
+  glitch_diagram_object m_model;
+  glitch_wire_graph m_pendingWires;
   quint64 m_id;
-  virtual void createActions(void);
+  QAction *addSharedAction(QMenu &menu,
+			   const DefaultMenuActions action,
+			   const char *member);
+  glitch_object_actions *objectActions(void) const;
   void addDefaultActions(QMenu &menu);
+  void createPendingChildren(void);
   void prepareContextMenu(void);
-  void saveProperties(const QMap<QString, QVariant> &p,
-		      const QSqlDatabase &db,
-		      QString &error);
   void setProperties(const QStringList &list);
 
  protected slots:
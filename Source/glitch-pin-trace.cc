@@ -0,0 +1,501 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QObject>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <limits>
+
+#include "glitch-pin-trace.h"
+
+/*
+** Every level summarizes sixteen entries of the level below it.
+** Six levels cover more than sixteen million samples.
+*/
+
+static const int s_factor = 16;
+static const int s_levels = 6;
+
+/*
+** Samples per channel which may wait for the consumer.
+*/
+
+static const int s_capacity = 16384;
+
+/*
+** A blocking producer yields a number of times and then sleeps for
+** increasing intervals. It stops waiting once it has slept for the
+** given time.
+*/
+
+static const int s_waitYields = 64;
+static const unsigned long s_waitMicros = 100000;
+static const unsigned long s_waitSleepMaximum = 1024;
+
+static QString vcd_identifier(int index)
+{
+  /*
+  ** Identifiers consist of the printable characters ! through ~.
+  */
+
+  QString identifier("");
+
+  do
+    {
+      identifier.append(QChar('!' + index % 94));
+      index /= 94;
+    }
+  while(index > 0);
+
+  return identifier;
+}
+
+static QString vcd_value(const qint32 value, const int width)
+{
+  if(width == 1)
+    return value ? "1" : "0";
+  else
+    return QString("b%1 ").arg(static_cast<quint32> (value), 0, 2);
+}
+
+static bool sample_less_than(const glitch_pin_trace::Sample &sample,
+			     const quint64 time)
+{
+  return sample.time < time;
+}
+
+glitch_pin_trace::glitch_pin_trace(void)
+{
+  m_blocking.store(false);
+  m_dropped.store(0);
+  m_duration = 0;
+}
+
+glitch_pin_trace::~glitch_pin_trace()
+{
+  for(const auto &channel : m_channels)
+    delete channel.buffer;
+}
+
+QString glitch_pin_trace::name(const int channel) const
+{
+  if(channel >= 0 && channel < m_channels.size())
+    return m_channels.at(channel).name;
+  else
+    return "";
+}
+
+QVector<glitch_pin_trace::Extent> glitch_pin_trace::extents
+(const int channel,
+ const quint64 begin,
+ const quint64 end,
+ const int columns) const
+{
+  /*
+  ** The extremes of every column. A column also contains the value
+  ** which was held when the column began. Empty columns have a
+  ** minimum which exceeds their maximum.
+  */
+
+  QVector<Extent> extents;
+
+  if(channel < 0 || channel >= m_channels.size() || columns <= 0)
+    return extents;
+
+  const auto &c(m_channels.at(channel));
+  auto first = c.samples.constBegin();
+  auto last = c.samples.constEnd();
+  auto span = static_cast<double> (end - qMin(begin, end));
+
+  extents.resize(columns);
+
+  for(int i = 0; i < columns; i++)
+    {
+      auto b = begin + static_cast<quint64> (span * i / columns);
+      auto e = begin + static_cast<quint64> (span * (i + 1) / columns);
+
+      if(i == columns - 1)
+	e = end + 1;
+
+      first = std::lower_bound(first, last, b, sample_less_than);
+
+      auto to = std::lower_bound(first, last, e, sample_less_than);
+      qint64 from = first - c.samples.constBegin();
+
+      if(from > 0)
+	from -= 1;
+
+      extents[i] = extent(c, from, to - c.samples.constBegin());
+    }
+
+  return extents;
+}
+
+bool glitch_pin_trace::exportVcd(const QString &fileName, QString &error) const
+{
+  /*
+  ** Value Change Dump, IEEE 1364. Time is expressed in microseconds.
+  */
+
+  QSaveFile file(fileName);
+
+  if(!file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+    {
+      error = file.errorString();
+      return false;
+    }
+
+  QTextStream stream(&file);
+
+  stream << "$version Glitch $end\n"
+	 << "$timescale 1us $end\n"
+	 << "$scope module arduino $end\n";
+
+  for(int i = 0; i < m_channels.size(); i++)
+    stream << "$var wire "
+	   << m_channels.at(i).width
+	   << " "
+	   << vcd_identifier(i)
+	   << " "
+	   << QString(m_channels.at(i).name).remove(' ')
+	   << " $end\n";
+
+  stream << "$upscope $end\n"
+	 << "$enddefinitions $end\n"
+	 << "#0\n"
+	 << "$dumpvars\n";
+
+  for(int i = 0; i < m_channels.size(); i++)
+    stream << (m_channels.at(i).width == 1 ? "x" : "bx ")
+	   << vcd_identifier(i)
+	   << "\n";
+
+  stream << "$end\n";
+
+  /*
+  ** Merge the channels. Only the last value of a channel at a given
+  ** time is written.
+  */
+
+  QVector<int> indexes(m_channels.size(), 0);
+  QVector<qint32> values(m_channels.size(), 0);
+  QVector<bool> written(m_channels.size(), false);
+  bool first = true;
+
+  forever
+    {
+      auto time = std::numeric_limits<quint64>::max();
+
+      for(int i = 0; i < m_channels.size(); i++)
+	if(indexes.at(i) < m_channels.at(i).samples.size())
+	  time = qMin
+	    (m_channels.at(i).samples.at(indexes.at(i)).time, time);
+
+      if(time == std::numeric_limits<quint64>::max())
+	break;
+
+      if(!first || time > 0)
+	stream << "#" << time << "\n";
+
+      first = false;
+
+      for(int i = 0; i < m_channels.size(); i++)
+	{
+	  const auto &samples(m_channels.at(i).samples);
+	  auto index = indexes.at(i);
+
+	  while(index < samples.size() && samples.at(index).time == time)
+	    index += 1;
+
+	  if(index == indexes.at(i))
+	    continue;
+
+	  auto value = samples.at(index - 1).value;
+
+	  indexes[i] = index;
+
+	  if(!written.at(i) || value != values.at(i))
+	    {
+	      stream << vcd_value(value, m_channels.at(i).width)
+		     << vcd_identifier(i)
+		     << "\n";
+	      values[i] = value;
+	      written[i] = true;
+	    }
+	}
+    }
+
+  stream.flush();
+
+  if(stream.status() != QTextStream::Ok || !file.commit())
+    {
+      error = file.errorString();
+      return false;
+    }
+
+  return true;
+}
+
+glitch_pin_trace::Extent glitch_pin_trace::extent
+(const Channel &channel, qint64 from, const qint64 to) const
+{
+  /*
+  ** The largest aligned summaries which fit within [from, to) are
+  ** combined. At most 2 * s_factor entries are visited per level.
+  */
+
+  Extent extent;
+  int level = 0;
+  qint64 size = 1;
+
+  extent.maximum = std::numeric_limits<qint32>::min();
+  extent.minimum = std::numeric_limits<qint32>::max();
+
+  while(from < to)
+    {
+      while(level < channel.levels.size() &&
+	    from % (s_factor * size) == 0 &&
+	    from + s_factor * size <= to)
+	{
+	  level += 1;
+	  size *= s_factor;
+	}
+
+      while(from + size > to)
+	{
+	  level -= 1;
+	  size /= s_factor;
+	}
+
+      if(level == 0)
+	{
+	  auto value = channel.samples.at(static_cast<int> (from)).value;
+
+	  extent.maximum = qMax(value, extent.maximum);
+	  extent.minimum = qMin(value, extent.minimum);
+	}
+      else
+	{
+	  const auto &e
+	    (channel.levels.at(level - 1).at(static_cast<int> (from / size)));
+
+	  extent.maximum = qMax(e.maximum, extent.maximum);
+	  extent.minimum = qMin(e.minimum, extent.minimum);
+	}
+
+      from += size;
+    }
+
+  return extent;
+}
+
+int glitch_pin_trace::addChannel(const QString &name, const int width)
+{
+  /*
+  ** Channels are added before the producer starts.
+  */
+
+  Channel channel;
+
+  channel.buffer = new glitch_ring_buffer<Sample> (s_capacity);
+  channel.levels.resize(s_levels);
+  channel.name = name;
+  channel.width = qBound(1, width, 32);
+  m_channels << channel;
+  return m_channels.size() - 1;
+}
+
+int glitch_pin_trace::count(void) const
+{
+  return m_channels.size();
+}
+
+int glitch_pin_trace::drain(void)
+{
+  /*
+  ** Consumer. Move the waiting samples into the history.
+  */
+
+  Sample sample;
+  int count = 0;
+
+  for(auto &channel : m_channels)
+    while(channel.buffer->pop(sample))
+      {
+	auto n = channel.samples.size();
+	int size = 1;
+
+	channel.samples << sample;
+
+	for(auto &level : channel.levels)
+	  {
+	    size *= s_factor;
+
+	    if(n / size == level.size())
+	      {
+		Extent extent;
+
+		extent.maximum = extent.minimum = sample.value;
+		level << extent;
+	      }
+	    else
+	      {
+		auto &extent(level.last());
+
+		extent.maximum = qMax(sample.value, extent.maximum);
+		extent.minimum = qMin(sample.value, extent.minimum);
+	      }
+	  }
+
+	count += 1;
+	m_duration = qMax(sample.time, m_duration);
+      }
+
+  return count;
+}
+
+int glitch_pin_trace::width(const int channel) const
+{
+  if(channel >= 0 && channel < m_channels.size())
+    return m_channels.at(channel).width;
+  else
+    return 0;
+}
+
+qint64 glitch_pin_trace::samples(const int channel) const
+{
+  if(channel >= 0 && channel < m_channels.size())
+    return m_channels.at(channel).samples.size();
+  else
+    return 0;
+}
+
+quint64 glitch_pin_trace::dropped(void) const
+{
+  return m_dropped.load();
+}
+
+quint64 glitch_pin_trace::duration(void) const
+{
+  return m_duration;
+}
+
+void glitch_pin_trace::clear(void)
+{
+  /*
+  ** Consumer. The producer must be idle.
+  */
+
+  Sample sample;
+
+  for(auto &channel : m_channels)
+    {
+      while(channel.buffer->pop(sample))
+	;
+
+      channel.levels.clear();
+      channel.levels.resize(s_levels);
+      channel.samples.clear();
+    }
+
+  m_dropped.store(0);
+  m_duration = 0;
+}
+
+void glitch_pin_trace::close(void)
+{
+  /*
+  ** The producer no longer waits for the consumer.
+  */
+
+  m_blocking.store(false);
+}
+
+void glitch_pin_trace::open(const bool blocking)
+{
+  /*
+  ** A blocking producer waits, for a limited time, if a buffer is
+  ** full. Otherwise, samples are dropped.
+  */
+
+  m_blocking.store(blocking);
+}
+
+void glitch_pin_trace::record(const int channel,
+			      const quint64 time,
+			      const qint32 value)
+{
+  /*
+  ** Producer.
+  */
+
+  if(channel < 0 || channel >= m_channels.size())
+    return;
+
+  Sample sample;
+
+  sample.time = time;
+  sample.value = value;
+
+  auto buffer = m_channels.at(channel).buffer;
+  int yields = 0;
+  unsigned long sleep = 1;
+  unsigned long slept = 0;
+
+  while(!buffer->push(sample))
+    if(m_blocking.load(std::memory_order_relaxed))
+      {
+	if(slept >= s_waitMicros)
+	  {
+	    /*
+	    ** The consumer is not keeping up. Samples are dropped
+	    ** until the trace is opened again.
+	    */
+
+	    m_blocking.store(false);
+	  }
+	else if(yields < s_waitYields)
+	  {
+	    QThread::yieldCurrentThread();
+	    yields += 1;
+	  }
+	else
+	  {
+	    QThread::usleep(sleep);
+	    slept += sleep;
+	    sleep = qMin(2 * sleep, s_waitSleepMaximum);
+	  }
+      }
+    else
+      {
+	m_dropped.fetch_add(1, std::memory_order_relaxed);
+	break;
+      }
+}
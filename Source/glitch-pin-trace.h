@@ -0,0 +1,91 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_pin_trace_h_
+#define _glitch_pin_trace_h_
+
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+#include "glitch-ring-buffer.h"
+
+class glitch_pin_trace
+{
+ public:
+  struct Extent
+  {
+    qint32 maximum;
+    qint32 minimum;
+  };
+
+  struct Sample
+  {
+    qint32 value;
+    quint64 time;
+  };
+
+  glitch_pin_trace(void);
+  ~glitch_pin_trace();
+  QString name(const int channel) const;
+  QVector<Extent> extents(const int channel,
+			  const quint64 begin,
+			  const quint64 end,
+			  const int columns) const;
+  bool exportVcd(const QString &fileName, QString &error) const;
+  int addChannel(const QString &name, const int width);
+  int count(void) const;
+  int drain(void);
+  int width(const int channel) const;
+  qint64 samples(const int channel) const;
+  quint64 dropped(void) const;
+  quint64 duration(void) const;
+  void clear(void);
+  void close(void);
+  void open(const bool blocking);
+  void record(const int channel, const quint64 time, const qint32 value);
+
+ private:
+  struct Channel
+  {
+    QString name;
+    QVector<QVector<Extent> > levels;
+    QVector<Sample> samples;
+    glitch_ring_buffer<Sample> *buffer;
+    int width;
+  };
+
+  QVector<Channel> m_channels;
+  quint64 m_duration;
+  std::atomic<bool> m_blocking;
+  std::atomic<quint64> m_dropped;
+  Extent extent(const Channel &channel, qint64 from, const qint64 to) const;
+  Q_DISABLE_COPY(glitch_pin_trace)
+};
+
+#endif
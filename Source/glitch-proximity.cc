@@ -0,0 +1,574 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "glitch-proximity.h"
+
+/*
+** Objects are kept in two structures. A map ordered by position is
+** the sweep which yields the top-down, left-to-right statement order.
+** An R-tree (Guttman, quadratic split) answers neighbor queries.
+** Both structures are updated in logarithmic time as objects move.
+*/
+
+static const int s_maximum = 8;
+static const int s_minimum = 3;
+
+glitch_proximity::glitch_proximity(void)
+{
+  m_root = new Node;
+  m_root->leaf = true;
+  m_root->parent = nullptr;
+}
+
+glitch_proximity::~glitch_proximity()
+{
+  destroy(m_root);
+}
+
+QList<qint64> glitch_proximity::intersecting(const QRectF &rect) const
+{
+  QList<qint64> ids;
+
+  intersecting(m_root, rect, ids);
+  return ids;
+}
+
+QList<qint64> glitch_proximity::nearest
+(const QPointF &point, const int count) const
+{
+  /*
+  ** A best-first traversal. Nodes and entries are visited in order of
+  ** their distances from the point.
+  */
+
+  QList<qint64> ids;
+  QMultiMap<qreal, QPair<Node *, int> > queue;
+
+  if(count <= 0 || m_rects.isEmpty())
+    return ids;
+
+  queue.insert(distance(point, m_root->bounds), qMakePair(m_root, -1));
+
+  while(!queue.isEmpty() && ids.size() < count)
+    {
+      auto it = queue.begin();
+      auto pair(it.value());
+
+      queue.erase(it);
+
+      if(pair.second >= 0)
+	ids << pair.first->entries.at(pair.second).id;
+      else if(pair.first->leaf)
+	for(int i = 0; i < pair.first->entries.size(); i++)
+	  queue.insert(distance(point, pair.first->entries.at(i).rect),
+		       qMakePair(pair.first, i));
+      else
+	for(auto child : pair.first->children)
+	  queue.insert(distance(point, child->bounds), qMakePair(child, -1));
+    }
+
+  return ids;
+}
+
+QList<qint64> glitch_proximity::order(void) const
+{
+  return m_order.values();
+}
+
+QRectF glitch_proximity::bounds(const QRectF &r1, const QRectF &r2)
+{
+  /*
+  ** QRectF::united() ignores empty rectangles.
+  */
+
+  return QRectF(QPointF(qMin(r1.left(), r2.left()), qMin(r1.top(), r2.top())),
+		QPointF(qMax(r1.right(), r2.right()),
+			qMax(r1.bottom(), r2.bottom())));
+}
+
+QRectF glitch_proximity::rect(const qint64 id) const
+{
+  return m_rects.value(id);
+}
+
+bool glitch_proximity::Key::operator<(const Key &other) const
+{
+  /*
+  ** Diagrams are interpreted from the top down. Objects sharing a row
+  ** are interpreted from left to right.
+  */
+
+  if(y != other.y)
+    return y < other.y;
+  else if(x != other.x)
+    return x < other.x;
+  else
+    return id < other.id;
+}
+
+bool glitch_proximity::contains(const qint64 id) const
+{
+  return m_rects.contains(id);
+}
+
+bool glitch_proximity::intersects(const QRectF &r1, const QRectF &r2)
+{
+  /*
+  ** QRectF::intersects() ignores empty rectangles.
+  */
+
+  return r1.left() <= r2.right() && r2.left() <= r1.right() &&
+    r1.top() <= r2.bottom() && r2.top() <= r1.bottom();
+}
+
+glitch_proximity::Node *glitch_proximity::divide(Node *node)
+{
+  /*
+  ** Move half of the node's entries or children to a new sibling.
+  */
+
+  QVector<QRectF> rects;
+  QVector<int> group1;
+  QVector<int> group2;
+
+  if(node->leaf)
+    for(const auto &entry : node->entries)
+      rects << entry.rect;
+  else
+    for(auto child : node->children)
+      rects << child->bounds;
+
+  split(rects, group1, group2);
+
+  auto sibling = new Node;
+
+  sibling->leaf = node->leaf;
+  sibling->parent = node->parent;
+
+  if(node->leaf)
+    {
+      QVector<Entry> entries(node->entries);
+
+      node->entries.clear();
+
+      for(auto i : group1)
+	node->entries << entries.at(i);
+
+      for(auto i : group2)
+	{
+	  m_leaves[entries.at(i).id] = sibling;
+	  sibling->entries << entries.at(i);
+	}
+    }
+  else
+    {
+      QVector<Node *> children(node->children);
+
+      node->children.clear();
+
+      for(auto i : group1)
+	node->children << children.at(i);
+
+      for(auto i : group2)
+	{
+	  children.at(i)->parent = sibling;
+	  sibling->children << children.at(i);
+	}
+    }
+
+  return sibling;
+}
+
+glitch_proximity::Node *glitch_proximity::leaf(const QRectF &rect) const
+{
+  /*
+  ** Descend through the children requiring the least enlargement.
+  */
+
+  auto node = m_root;
+
+  while(!node->leaf)
+    {
+      Node *best = nullptr;
+      qreal bestArea = 0.0;
+      qreal bestEnlargement = 0.0;
+
+      for(auto child : node->children)
+	{
+	  auto a = area(child->bounds);
+	  auto enlargement = area(bounds(child->bounds, rect)) - a;
+
+	  if(!best ||
+	     enlargement < bestEnlargement ||
+	     (enlargement == bestEnlargement && a < bestArea))
+	    {
+	      best = child;
+	      bestArea = a;
+	      bestEnlargement = enlargement;
+	    }
+	}
+
+      node = best;
+    }
+
+  return node;
+}
+
+int glitch_proximity::count(void) const
+{
+  return m_rects.size();
+}
+
+int glitch_proximity::index(const qint64 id) const
+{
+  /*
+  ** The position of the object in the statement order. The indexes
+  ** are computed once after every change.
+  */
+
+  if(m_indexes.isEmpty() && !m_order.isEmpty())
+    {
+      int i = 0;
+
+      for(auto value : m_order)
+	m_indexes[value] = i++;
+    }
+
+  return m_indexes.value(id, -1);
+}
+
+qreal glitch_proximity::area(const QRectF &rect)
+{
+  return qMax(0.0, rect.width()) * qMax(0.0, rect.height());
+}
+
+qreal glitch_proximity::distance(const QPointF &point, const QRectF &rect)
+{
+  auto dx = qMax(0.0, qMax(rect.left() - point.x(), point.x() - rect.right()));
+  auto dy = qMax(0.0, qMax(rect.top() - point.y(), point.y() - rect.bottom()));
+
+  return dx * dx + dy * dy;
+}
+
+void glitch_proximity::adjust(Node *node, Node *sibling)
+{
+  /*
+  ** Propagate bounds and splits toward the root.
+  */
+
+  while(true)
+    {
+      update(node);
+
+      if(sibling)
+	update(sibling);
+
+      if(node == m_root)
+	{
+	  if(sibling)
+	    {
+	      m_root = new Node;
+	      m_root->children << node << sibling;
+	      m_root->leaf = false;
+	      m_root->parent = nullptr;
+	      node->parent = sibling->parent = m_root;
+	      update(m_root);
+	    }
+
+	  break;
+	}
+
+      auto parent = node->parent;
+
+      if(sibling)
+	{
+	  parent->children << sibling;
+	  sibling->parent = parent;
+	  sibling = parent->children.size() > s_maximum ?
+	    divide(parent) : nullptr;
+	}
+
+      node = parent;
+    }
+}
+
+void glitch_proximity::clear(void)
+{
+  destroy(m_root);
+  m_indexes.clear();
+  m_leaves.clear();
+  m_order.clear();
+  m_rects.clear();
+  m_root = new Node;
+  m_root->leaf = true;
+  m_root->parent = nullptr;
+}
+
+void glitch_proximity::destroy(Node *node)
+{
+  if(!node)
+    return;
+
+  for(auto child : node->children)
+    destroy(child);
+
+  delete node;
+}
+
+void glitch_proximity::entries(Node *node, QVector<Entry> &entries) const
+{
+  if(node->leaf)
+    entries << node->entries;
+  else
+    for(auto child : node->children)
+      this->entries(child, entries);
+}
+
+void glitch_proximity::insert(const qint64 id, const QRectF &rect)
+{
+  /*
+  ** Insert an object or move an existing object.
+  */
+
+  if(m_rects.contains(id))
+    {
+      if(m_rects.value(id) == rect)
+	return;
+
+      remove(id);
+    }
+
+  Entry entry;
+  Key key;
+
+  entry.id = id;
+  entry.rect = rect;
+  key.id = id;
+  key.x = rect.left();
+  key.y = rect.top();
+  insertEntry(entry);
+  m_indexes.clear();
+  m_order[key] = id;
+  m_rects[id] = rect;
+}
+
+void glitch_proximity::insertEntry(const Entry &entry)
+{
+  auto node = leaf(entry.rect);
+
+  m_leaves[entry.id] = node;
+  node->entries << entry;
+  adjust(node, node->entries.size() > s_maximum ? divide(node) : nullptr);
+}
+
+void glitch_proximity::intersecting
+(Node *node, const QRectF &rect, QList<qint64> &ids) const
+{
+  if(node->leaf)
+    {
+      for(const auto &entry : node->entries)
+	if(intersects(entry.rect, rect))
+	  ids << entry.id;
+    }
+  else
+    for(auto child : node->children)
+      if(intersects(child->bounds, rect))
+	intersecting(child, rect, ids);
+}
+
+void glitch_proximity::remove(const qint64 id)
+{
+  if(!m_rects.contains(id))
+    return;
+
+  auto node = m_leaves.take(id);
+  auto rect(m_rects.take(id));
+  Key key;
+
+  key.id = id;
+  key.x = rect.left();
+  key.y = rect.top();
+  m_indexes.clear();
+  m_order.remove(key);
+
+  for(int i = 0; i < node->entries.size(); i++)
+    if(node->entries.at(i).id == id)
+      {
+	node->entries.removeAt(i);
+	break;
+      }
+
+  /*
+  ** Underfull nodes are removed. Their entries are inserted again.
+  */
+
+  QVector<Entry> orphans;
+
+  while(node != m_root)
+    {
+      auto parent = node->parent;
+
+      if(node->entries.size() + node->children.size() < s_minimum)
+	{
+	  parent->children.removeOne(node);
+	  entries(node, orphans);
+	  destroy(node);
+	}
+      else
+	update(node);
+
+      node = parent;
+    }
+
+  update(m_root);
+
+  while(!m_root->leaf && m_root->children.size() == 1)
+    {
+      auto child = m_root->children.at(0);
+
+      child->parent = nullptr;
+      delete m_root;
+      m_root = child;
+    }
+
+  if(!m_root->leaf && m_root->children.isEmpty())
+    m_root->leaf = true;
+
+  for(const auto &entry : orphans)
+    insertEntry(entry);
+}
+
+void glitch_proximity::split(const QVector<QRectF> &rects,
+			     QVector<int> &group1,
+			     QVector<int> &group2)
+{
+  /*
+  ** Quadratic split. The seeds are the pair wasting the most area.
+  ** The remaining rectangles are assigned by greatest preference.
+  */
+
+  int seed1 = 0;
+  int seed2 = 1;
+  qreal worst = -1.0;
+
+  for(int i = 0; i < rects.size(); i++)
+    for(int j = i + 1; j < rects.size(); j++)
+      {
+	auto d = area(bounds(rects.at(i), rects.at(j))) -
+	  area(rects.at(i)) - area(rects.at(j));
+
+	if(d > worst)
+	  {
+	    seed1 = i;
+	    seed2 = j;
+	    worst = d;
+	  }
+      }
+
+  QRectF b1(rects.at(seed1));
+  QRectF b2(rects.at(seed2));
+  QVector<int> remaining;
+
+  group1 << seed1;
+  group2 << seed2;
+
+  for(int i = 0; i < rects.size(); i++)
+    if(i != seed1 && i != seed2)
+      remaining << i;
+
+  while(!remaining.isEmpty())
+    {
+      if(group1.size() + remaining.size() <= s_minimum)
+	{
+	  group1 << remaining;
+	  break;
+	}
+      else if(group2.size() + remaining.size() <= s_minimum)
+	{
+	  group2 << remaining;
+	  break;
+	}
+
+      int best = 0;
+      qreal d1 = 0.0;
+      qreal d2 = 0.0;
+      qreal preference = -1.0;
+
+      for(int i = 0; i < remaining.size(); i++)
+	{
+	  auto r(rects.at(remaining.at(i)));
+	  auto e1 = area(bounds(b1, r)) - area(b1);
+	  auto e2 = area(bounds(b2, r)) - area(b2);
+
+	  if(qAbs(e1 - e2) > preference)
+	    {
+	      best = i;
+	      d1 = e1;
+	      d2 = e2;
+	      preference = qAbs(e1 - e2);
+	    }
+	}
+
+      auto i = remaining.takeAt(best);
+
+      if(d1 < d2 || (d1 == d2 && group1.size() <= group2.size()))
+	{
+	  b1 = bounds(b1, rects.at(i));
+	  group1 << i;
+	}
+      else
+	{
+	  b2 = bounds(b2, rects.at(i));
+	  group2 << i;
+	}
+    }
+}
+
+void glitch_proximity::update(Node *node)
+{
+  if(node->leaf)
+    {
+      if(node->entries.isEmpty())
+	node->bounds = QRectF();
+      else
+	{
+	  node->bounds = node->entries.at(0).rect;
+
+	  for(const auto &entry : node->entries)
+	    node->bounds = bounds(node->bounds, entry.rect);
+	}
+    }
+  else if(node->children.isEmpty())
+    node->bounds = QRectF();
+  else
+    {
+      node->bounds = node->children.at(0)->bounds;
+
+      for(auto child : node->children)
+	node->bounds = bounds(node->bounds, child->bounds);
+    }
+}
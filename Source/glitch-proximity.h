@@ -0,0 +1,100 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_proximity_h_
+#define _glitch_proximity_h_
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QRectF>
+#include <QVector>
+
+class glitch_proximity
+{
+ public:
+  glitch_proximity(void);
+  ~glitch_proximity();
+  QList<qint64> intersecting(const QRectF &rect) const;
+  QList<qint64> nearest(const QPointF &point, const int count) const;
+  QList<qint64> order(void) const;
+  QRectF rect(const qint64 id) const;
+  bool contains(const qint64 id) const;
+  int count(void) const;
+  int index(const qint64 id) const;
+  void clear(void);
+  void insert(const qint64 id, const QRectF &rect);
+  void remove(const qint64 id);
+
+ private:
+  struct Entry
+  {
+    QRectF rect;
+    qint64 id;
+  };
+
+  struct Key
+  {
+    bool operator<(const Key &other) const;
+    qint64 id;
+    qreal x;
+    qreal y;
+  };
+
+  struct Node
+  {
+    Node *parent;
+    QRectF bounds;
+    QVector<Entry> entries;
+    QVector<Node *> children;
+    bool leaf;
+  };
+
+  QHash<qint64, Node *> m_leaves;
+  QHash<qint64, QRectF> m_rects;
+  QMap<Key, qint64> m_order;
+  Node *m_root;
+  mutable QHash<qint64, int> m_indexes;
+  Q_DISABLE_COPY(glitch_proximity)
+  static QRectF bounds(const QRectF &r1, const QRectF &r2);
+  static bool intersects(const QRectF &r1, const QRectF &r2);
+  static qreal area(const QRectF &rect);
+  static qreal distance(const QPointF &point, const QRectF &rect);
+  static void split(const QVector<QRectF> &rects,
+		    QVector<int> &group1,
+		    QVector<int> &group2);
+  Node *divide(Node *node);
+  Node *leaf(const QRectF &rect) const;
+  void adjust(Node *node, Node *sibling);
+  void destroy(Node *node);
+  void entries(Node *node, QVector<Entry> &entries) const;
+  void insertEntry(const Entry &entry);
+  void intersecting(Node *node, const QRectF &rect, QList<qint64> &ids) const;
+  void update(Node *node);
+};
+
+#endif
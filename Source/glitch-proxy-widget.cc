@@ -35,6 +35,8 @@
 
 #include "glitch-object.h"
 #include "glitch-proxy-widget.h"
+#include "glitch-scene.h"
+#include "glitch-trace.h"
 
 glitch_proxy_widget::glitch_proxy_widget
 (QGraphicsItem *parent, Qt::WindowFlags wFlags):
@@ -120,6 +122,8 @@ void glitch_proxy_widget::mousePressEvent(QGraphicsSceneMouseEvent *event)
 void glitch_proxy_widget::paint
 (QPainter *painter, const QStyleOptionGraphicsItem *opt, QWidget *widget)
 {
+  GLITCH_TRACE_SCOPE("glitch_proxy_widget::paint");
+
   if(painter)
     painter->setRenderHints(QPainter::Antialiasing |
 			    QPainter::HighQualityAntialiasing | // OpenGL?
@@ -144,4 +148,65 @@ void glitch_proxy_widget::paint
     }
 
   QGraphicsProxyWidget::paint(painter, opt, widget);
+
+  auto scene = qobject_cast<glitch_scene *> (this->scene());
+
+  if(painter && scene)
+    {
+      /*
+      ** The object's share of the simulated time.
+      */
+
+      auto heat = scene->heat(this);
+
+      if(heat > 0.0)
+	painter->fillRect
+	  (boundingRect(),
+	   QColor(255,
+		  static_cast<int> (160.0 * (1.0 - heat)),
+		  0,
+		  static_cast<int> (48.0 + 112.0 * heat)));
+
+      /*
+      ** The object does not fit on the board.
+      */
+
+      if(scene->isOverBudget(this))
+	{
+	  QPen pen;
+
+	  pen.setColor(QColor(220, 20, 60));
+	  pen.setJoinStyle(Qt::RoundJoin);
+	  pen.setStyle(Qt::SolidLine);
+	  pen.setWidthF(3.0);
+	  painter->setBrush(Qt::NoBrush);
+	  painter->setPen(pen);
+	  painter->drawRect(boundingRect());
+	}
+    }
+
+  if(painter && scene && scene->showOrderHints())
+    {
+      /*
+      ** The object's position in the generated source.
+      */
+
+      auto index = scene->statementIndex(this);
+
+      if(index < 0)
+	return;
+
+      QFontMetrics fontMetrics(painter->font());
+      QString text(QString::number(index + 1));
+      QRectF rect
+	(0.0,
+	 0.0,
+	 static_cast<qreal> (fontMetrics.boundingRect(text).width()) + 8.0,
+	 static_cast<qreal> (fontMetrics.height()) + 2.0);
+
+      painter->setBrush(QColor(255, 215, 0, 220));
+      painter->setPen(Qt::black);
+      painter->drawRoundedRect(rect, 4.0, 4.0);
+      painter->drawText(rect, Qt::AlignCenter, text);
+    }
 }
@@ -0,0 +1,128 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_ring_buffer_h_
+#define _glitch_ring_buffer_h_
+
+#include <QVector>
+
+#include <atomic>
+
+/*
+** A bounded queue for one producer thread and one consumer thread.
+** The capacity is rounded up to a power of two. Neither side locks.
+*/
+
+template<typename T> class glitch_ring_buffer
+{
+ public:
+  glitch_ring_buffer(const int capacity)
+  {
+    int c = 2;
+
+    while(c < capacity && c < (1 << 30))
+      c <<= 1;
+
+    m_values.resize(c);
+    m_data = m_values.data();
+    m_head.store(0);
+    m_mask = static_cast<quint64> (c - 1);
+    m_tail.store(0);
+  }
+
+  ~glitch_ring_buffer()
+  {
+  }
+
+  bool isEmpty(void) const
+  {
+    return m_head.load(std::memory_order_acquire) ==
+      m_tail.load(std::memory_order_acquire);
+  }
+
+  bool pop(T &value)
+  {
+    /*
+    ** Consumer.
+    */
+
+    auto head = m_head.load(std::memory_order_acquire);
+    auto tail = m_tail.load(std::memory_order_relaxed);
+
+    if(head == tail)
+      return false;
+
+    value = m_data[tail & m_mask];
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool push(const T &value)
+  {
+    /*
+    ** Producer.
+    */
+
+    auto head = m_head.load(std::memory_order_relaxed);
+    auto tail = m_tail.load(std::memory_order_acquire);
+
+    if(head - tail > m_mask)
+      return false;
+
+    m_data[head & m_mask] = value;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  int capacity(void) const
+  {
+    return m_values.size();
+  }
+
+  int size(void) const
+  {
+    auto tail = m_tail.load(std::memory_order_acquire);
+
+    return static_cast<int> (m_head.load(std::memory_order_acquire) - tail);
+  }
+
+ private:
+  /*
+  ** The indexes are separated so that the threads do not share
+  ** a cache line.
+  */
+
+  QVector<T> m_values;
+  T *m_data;
+  quint64 m_mask;
+  std::atomic<quint64> m_head;
+  char m_padding[64];
+  std::atomic<quint64> m_tail;
+  Q_DISABLE_COPY(glitch_ring_buffer)
+};
+
+#endif
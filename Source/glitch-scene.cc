@@ -29,29 +29,54 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsView>
 #include <QMimeData>
+#include <QSqlDatabase>
 #include <QTableWidget>
 #include <QUndoStack>
 #include <QtDebug>
 
+#include <algorithm>
+
 #include "Arduino/glitch-object-analog-read-arduino.h"
 #include "Arduino/glitch-object-function-arduino.h"
 #include "Arduino/glitch-object-logical-operator-arduino.h"
 #include "Arduino/glitch-structures-arduino.h"
+#include "glitch-object-actions.h"
 #include "glitch-proxy-widget.h"
 #include "glitch-scene.h"
+#include "glitch-trace.h"
 #include "glitch-undo-command.h"
+#include "glitch-view.h"
 #include "glitch-graphicsview.h"
+#include "glitch-wire.h"
+
+static bool proxy_less_than(glitch_proxy_widget *p1, glitch_proxy_widget *p2)
+{
+  if(!p1 || !p2)
+    return false;
+  else if(!qFuzzyCompare(p1->x(), p2->x()))
+    return p1->x() < p2->x();
+  else
+    return p1->y() < p2->y();
+}
 
 glitch_scene::glitch_scene(const glitch_common::ProjectType projectType,
 			   QObject *parent):QGraphicsScene(parent)
 {
   m_mainScene = false;
   m_projectType = projectType;
+  m_showOrderHints = false;
   m_undoStack = nullptr;
 }
 
 glitch_scene::~glitch_scene()
 {
+  /*
+  ** Proxies held by the undo stack may outlive the scene's items.
+  */
+
+  for(const auto &proxy : m_proxies)
+    if(proxy)
+      disconnect(proxy, nullptr, this, nullptr);
 }
 
 QList<glitch_object *> glitch_scene::objects(void) const
@@ -72,6 +97,26 @@ QList<glitch_object *> glitch_scene::objects(void) const
   return widgets;
 }
 
+QList<glitch_object *> glitch_scene::orderedObjects(void) const
+{
+  /*
+  ** The objects in statement order. The order is maintained as objects
+  ** are added, moved, and removed.
+  */
+
+  QList<glitch_object *> widgets;
+
+  for(auto id : m_proximity.order())
+    {
+      auto proxy = m_proxies.value(id);
+
+      if(proxy && qobject_cast<glitch_object *> (proxy->widget()))
+	widgets << qobject_cast<glitch_object *> (proxy->widget());
+    }
+
+  return widgets;
+}
+
 QList<glitch_object *> glitch_scene::selectedObjects(void) const
 {
   QList<QGraphicsItem *> list(items());
@@ -97,6 +142,39 @@ QPointer<QUndoStack> glitch_scene::undoStack(void) const
   return m_undoStack;
 }
 
+bool glitch_scene::isOverBudget(glitch_proxy_widget *proxy) const
+{
+  if(m_overBudget.isEmpty())
+    return false;
+  else
+    return m_overBudget.contains(m_proxyIds.value(proxy, -1));
+}
+
+bool glitch_scene::saveWires(const QSqlDatabase &db,
+			     const qint64 parentId,
+			     QString &error) const
+{
+  return wireGraph().save(db, parentId, error);
+}
+
+bool glitch_scene::showOrderHints(void) const
+{
+  return m_showOrderHints;
+}
+
+glitch_object_actions *glitch_scene::objectActions(void)
+{
+  /*
+  ** The context menu actions of the objects of the scene's view.
+  ** Created on first use.
+  */
+
+  if(!m_objectActions && !views().isEmpty())
+    m_objectActions = new glitch_object_actions(views().value(0));
+
+  return m_objectActions;
+}
+
 bool glitch_scene::allowDrag(QGraphicsSceneDragDropEvent *event,
 			     const QString &text)
 {
@@ -196,6 +274,30 @@ glitch_proxy_widget *glitch_scene::addObject(glitch_object *object)
 	  SLOT(deleteLater(void)),
 	  Qt::UniqueConnection);
   object->setProxy(proxy);
+
+  /*
+  ** Apply the diagram's theme for the object's type.
+  */
+
+  QWidget *p = views().value(0);
+
+  do
+    {
+      if(!p)
+	break;
+
+      auto view = qobject_cast<glitch_view *> (p);
+
+      if(view)
+	{
+	  object->setThemeStyleSheet(view->themeStyleSheet(object->type()));
+	  break;
+	}
+
+      p = p->parentWidget();
+    }
+  while(true);
+
   proxy->setFlag(QGraphicsItem::ItemIsSelectable, true);
   proxy->setWidget(object);
   emit changed();
@@ -204,6 +306,11 @@ glitch_proxy_widget *glitch_scene::addObject(glitch_object *object)
     {
       auto function = qobject_cast<glitch_object_function_arduino *> (object);
 
+      connect(function,
+	      SIGNAL(changed(void)),
+	      this,
+	      SLOT(slotFunctionChanged(void)),
+	      Qt::UniqueConnection);
       connect(function,
 	      SIGNAL(nameChanged(const QString &,
 				 const QString &,
@@ -261,6 +368,123 @@ glitch_proxy_widget *glitch_scene::addObject(glitch_object *object)
   return proxy;
 }
 
+glitch_wire *glitch_scene::addWire(glitch_proxy_widget *output,
+				   glitch_proxy_widget *input)
+{
+  if(!input || !output || input == output)
+    return nullptr;
+  else if(input->scene() != this || output->scene() != this)
+    return nullptr;
+
+  for(auto wire : m_wires.value(output))
+    if(wire->input() == input)
+      return nullptr;
+
+  for(auto proxy : QList<glitch_proxy_widget *> () << input << output)
+    {
+      connect(proxy,
+	      SIGNAL(destroyed(QObject *)),
+	      this,
+	      SLOT(slotProxyDestroyed(QObject *)),
+	      Qt::UniqueConnection);
+      connect(proxy,
+	      SIGNAL(geometryChanged(void)),
+	      this,
+	      SLOT(slotProxyChanged(void)),
+	      Qt::UniqueConnection);
+    }
+
+  auto wire = new glitch_wire(output, input);
+
+  QGraphicsScene::addItem(wire);
+  m_statementIndexes.clear();
+  m_wires[input].insert(wire);
+  m_wires[output].insert(wire);
+
+  if(m_showOrderHints)
+    update();
+
+  emit changed();
+  return wire;
+}
+
+glitch_wire_graph glitch_scene::wireGraph(void) const
+{
+  /*
+  ** Wires of removed objects are retained for undo but are excluded.
+  */
+
+  QHashIterator<glitch_proxy_widget *, QSet<glitch_wire *> > it(m_wires);
+  glitch_wire_graph graph;
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      for(auto wire : it.value())
+	{
+	  if(wire->output() != it.key())
+	    continue;
+
+	  auto input = wire->input();
+	  auto output = wire->output();
+
+	  if(!input || !output)
+	    continue;
+	  else if(input->scene() != this || output->scene() != this)
+	    continue;
+
+	  auto i = qobject_cast<glitch_object *> (input->widget());
+	  auto o = qobject_cast<glitch_object *> (output->widget());
+
+	  if(i && o)
+	    graph.addWire(static_cast<qint64> (o->id()),
+			  static_cast<qint64> (i->id()));
+	}
+    }
+
+  return graph;
+}
+
+const glitch_proximity &glitch_scene::proximity(void) const
+{
+  return m_proximity;
+}
+
+int glitch_scene::statementIndex(glitch_proxy_widget *proxy) const
+{
+  /*
+  ** The position of the proxy's object in the generated source.
+  ** Computed once after every change.
+  */
+
+  if(!m_proxyIds.contains(proxy))
+    return -1;
+
+  if(m_statementIndexes.isEmpty())
+    {
+      auto graph(wireGraph());
+
+      if(graph.count() == 0)
+	return m_proximity.index(m_proxyIds.value(proxy));
+
+      int i = 0;
+
+      for(auto id : graph.order(m_proximity.order()))
+	m_statementIndexes[id] = i++;
+    }
+
+  return m_statementIndexes.value(m_proxyIds.value(proxy), -1);
+}
+
+qreal glitch_scene::heat(glitch_proxy_widget *proxy) const
+{
+  if(m_heat.isEmpty())
+    return 0.0;
+  else
+    return m_heat.value(m_proxyIds.value(proxy, -1), 0.0);
+}
+
 void glitch_scene::addItem(QGraphicsItem *item)
 {
   if(item && !item->scene())
@@ -271,6 +495,31 @@ void glitch_scene::addItem(QGraphicsItem *item)
   if(m_redoUndoProxies.contains(proxy) && proxy)
     m_redoUndoProxies[proxy] = 0;
 
+  auto object = proxy ? qobject_cast<glitch_object *> (proxy->widget()) :
+    nullptr;
+
+  if(object)
+    {
+      auto id = static_cast<qint64> (object->id());
+
+      connect(proxy,
+	      SIGNAL(destroyed(QObject *)),
+	      this,
+	      SLOT(slotProxyDestroyed(QObject *)),
+	      Qt::UniqueConnection);
+      connect(proxy,
+	      SIGNAL(geometryChanged(void)),
+	      this,
+	      SLOT(slotProxyChanged(void)),
+	      Qt::UniqueConnection);
+      m_proximity.insert(id, proxy->sceneBoundingRect());
+      m_proxies[id] = proxy;
+      m_proxyIds[proxy] = id;
+      m_statementIndexes.clear();
+    }
+
+  setWiresVisible(proxy, true);
+
   if(proxy && qobject_cast<glitch_object_function_arduino *> (proxy->widget()))
     emit functionAdded
       (qobject_cast<glitch_object_function_arduino *> (proxy->widget())->
@@ -279,6 +528,84 @@ void glitch_scene::addItem(QGraphicsItem *item)
        isClone());
 }
 
+void glitch_scene::addWires(const glitch_wire_graph &graph)
+{
+  if(graph.count() == 0)
+    return;
+
+  QHash<qint64, glitch_proxy_widget *> proxies;
+
+  for(auto i : items())
+    {
+      auto proxy = qgraphicsitem_cast<glitch_proxy_widget *> (i);
+
+      if(!proxy)
+	continue;
+
+      auto object = qobject_cast<glitch_object *> (proxy->widget());
+
+      if(object)
+	proxies[static_cast<qint64> (object->id())] = proxy;
+    }
+
+  for(const auto &wire : graph.wires())
+    addWire(proxies.value(wire.first), proxies.value(wire.second));
+}
+
+void glitch_scene::applyStyleSheet(const QList<glitch_object *> &objects,
+				   const QString &styleSheet)
+{
+  GLITCH_TRACE_SCOPE("glitch_scene::applyStyleSheet");
+
+  /*
+  ** Objects having the style sheet are not re-polished. The views are
+  ** updated once. A single undo command is recorded.
+  */
+
+  QList<glitch_object *> list;
+
+  for(auto object : objects)
+    if(object && object->styleSheet() != styleSheet)
+      list << object;
+
+  if(list.isEmpty())
+    return;
+
+  for(auto view : views())
+    view->setUpdatesEnabled(false);
+
+  if(m_undoStack && list.size() > 1)
+    m_undoStack->beginMacro(tr("stylesheets changed"));
+
+  for(auto object : list)
+    {
+      QString previousStyleSheet(object->styleSheet());
+
+      object->setStyleSheet(styleSheet);
+
+      if(m_undoStack)
+	{
+	  auto undoCommand = new glitch_undo_command
+	    (previousStyleSheet,
+	     glitch_undo_command::STYLESHEET_CHANGED,
+	     object);
+
+	  undoCommand->setText
+	    (tr("stylesheet changed (%1, %2)").
+	     arg(object->scenePos().x()).arg(object->scenePos().y()));
+	  m_undoStack->push(undoCommand);
+	}
+    }
+
+  if(m_undoStack && list.size() > 1)
+    m_undoStack->endMacro();
+
+  for(auto view : views())
+    view->setUpdatesEnabled(true);
+
+  emit changed();
+}
+
 void glitch_scene::artificialDrop(const QPointF &point, glitch_object *object)
 {
   if(!object)
@@ -350,6 +677,8 @@ void glitch_scene::deleteFunctionClones(const QString &name)
 
 void glitch_scene::deleteItems(void)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::deleteItems");
+
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
   QList<QGraphicsItem *> list;
@@ -420,6 +749,8 @@ void glitch_scene::deleteItems(void)
 
 void glitch_scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::dragEnterEvent");
+
   if(event && event->mimeData())
     {
       QString text(event->mimeData()->text().trimmed());
@@ -436,6 +767,8 @@ void glitch_scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 
 void glitch_scene::dragMoveEvent(QGraphicsSceneDragDropEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::dragMoveEvent");
+
   if(event && event->mimeData())
     {
       QString text(event->mimeData()->text().trimmed());
@@ -452,6 +785,8 @@ void glitch_scene::dragMoveEvent(QGraphicsSceneDragDropEvent *event)
 
 void glitch_scene::drawBackground(QPainter *painter, const QRectF &rect)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::drawBackground");
+
   if(!painter)
     {
       QGraphicsScene::drawBackground(painter, rect);
@@ -493,6 +828,8 @@ void glitch_scene::drawBackground(QPainter *painter, const QRectF &rect)
 
 void glitch_scene::dropEvent(QGraphicsSceneDragDropEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::dropEvent");
+
   if(event && event->mimeData())
     {
       QString text(event->mimeData()->text().trimmed());
@@ -558,6 +895,8 @@ void glitch_scene::dropEvent(QGraphicsSceneDragDropEvent *event)
 
 void glitch_scene::keyPressEvent(QKeyEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::keyPressEvent");
+
   if(!event)
     {
       QGraphicsScene::keyPressEvent(event);
@@ -688,6 +1027,8 @@ void glitch_scene::keyPressEvent(QKeyEvent *event)
 
 void glitch_scene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::mouseMoveEvent");
+
   if(event && !m_lastScenePos.isNull())
     {
       QList<QGraphicsItem *> list(selectedItems());
@@ -729,6 +1070,8 @@ void glitch_scene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
 void glitch_scene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::mousePressEvent");
+
   m_lastScenePos = QPointF();
   m_movedPoints.clear();
 
@@ -824,6 +1167,8 @@ void glitch_scene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 
 void glitch_scene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 {
+  GLITCH_TRACE_SCOPE("glitch_scene::mouseReleaseEvent");
+
   m_lastScenePos = QPointF();
 
   if(!m_movedPoints.isEmpty() && m_undoStack)
@@ -911,20 +1256,103 @@ void glitch_scene::removeItem(QGraphicsItem *item)
 
       if(object && !object->isClone())
 	emit functionDeleted(object->name());
+
+      if(m_proxyIds.contains(proxy))
+	{
+	  m_proximity.remove(m_proxyIds.value(proxy));
+	  m_statementIndexes.clear();
+	}
+
+      setWiresVisible(proxy, false);
     }
 }
 
+void glitch_scene::removeWire(glitch_proxy_widget *output,
+			      glitch_proxy_widget *input)
+{
+  for(auto wire : m_wires.value(output))
+    if(wire->input() == input)
+      {
+	m_wires[input].remove(wire);
+	m_wires[output].remove(wire);
+
+	if(m_wires.value(input).isEmpty())
+	  m_wires.remove(input);
+
+	if(m_wires.value(output).isEmpty())
+	  m_wires.remove(output);
+
+	delete wire;
+	m_statementIndexes.clear();
+
+	if(m_showOrderHints)
+	  update();
+
+	emit changed();
+	break;
+      }
+}
+
+void glitch_scene::setHeat(const QHash<qint64, qreal> &heat)
+{
+  /*
+  ** Values between zero and one, keyed by object identifiers.
+  ** The objects are tinted accordingly.
+  */
+
+  m_heat = heat;
+  update();
+}
+
 void glitch_scene::setMainScene(const bool state)
 {
   m_mainScene = state;
 }
 
+void glitch_scene::setOverBudget(const QSet<qint64> &ids)
+{
+  /*
+  ** Objects which do not fit on the board. They are outlined.
+  */
+
+  if(m_overBudget == ids)
+    return;
+
+  m_overBudget = ids;
+  update();
+}
+
 void glitch_scene::setUndoStack(QUndoStack *undoStack)
 {
   if(!m_undoStack)
     m_undoStack = undoStack;
 }
 
+void glitch_scene::setWiresVisible(glitch_proxy_widget *proxy,
+				   const bool state)
+{
+  for(auto wire : m_wires.value(proxy))
+    if(state)
+      {
+	if(wire->input() && wire->input()->scene() == this &&
+	   wire->output() && wire->output()->scene() == this)
+	  {
+	    wire->updatePath();
+	    wire->setVisible(true);
+	  }
+      }
+    else
+      wire->setVisible(false);
+}
+
+void glitch_scene::slotFunctionChanged(void)
+{
+  auto function = qobject_cast<glitch_object_function_arduino *> (sender());
+
+  if(function && !function->isClone())
+    emit functionChanged(function);
+}
+
 void glitch_scene::slotFunctionNameChanged(const QString &after,
 					   const QString &before,
 					   glitch_object *object)
@@ -970,6 +1398,97 @@ void glitch_scene::slotObjectDeletedViaContextMenu(void)
   emit changed();
 }
 
+void glitch_scene::slotProxyChanged(void)
+{
+  /*
+  ** Only the wires and the order of the moved object are updated.
+  */
+
+  auto proxy = qobject_cast<glitch_proxy_widget *> (sender());
+
+  if(!proxy || proxy->scene() != this || !m_proxyIds.contains(proxy))
+    return;
+
+  auto id = m_proxyIds.value(proxy);
+  auto after(proxy->sceneBoundingRect());
+  auto before(m_proximity.rect(id));
+
+  if(after != before)
+    {
+      m_proximity.insert(id, after);
+      m_statementIndexes.clear();
+
+      if(m_showOrderHints)
+	{
+	  /*
+	  ** The indexes of the objects between the former and the
+	  ** current rows may have changed.
+	  */
+
+	  QRectF band
+	    (sceneRect().left(),
+	     qMin(after.top(), before.top()),
+	     sceneRect().width(),
+	     qAbs(after.top() - before.top()));
+
+	  if(!m_wires.isEmpty())
+	    update();
+	  else
+	    for(auto i : m_proximity.intersecting(band))
+	      if(m_proxies.value(i))
+		m_proxies.value(i)->update();
+	}
+    }
+
+  for(auto wire : m_wires.value(proxy))
+    wire->updatePath();
+}
+
+void glitch_scene::slotProxyDestroyed(QObject *object)
+{
+  if(m_proxyIds.contains(object))
+    {
+      auto id = m_proxyIds.take(object);
+
+      m_proximity.remove(id);
+      m_proxies.remove(id);
+      m_statementIndexes.clear();
+    }
+
+  QMutableHashIterator<glitch_proxy_widget *, QSet<glitch_wire *> > it
+    (m_wires);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      if(it.key() != object)
+	continue;
+
+      auto wires(it.value());
+
+      it.remove();
+
+      for(auto wire : wires)
+	{
+	  auto proxy = wire->input() ? wire->input() : wire->output();
+
+	  if(m_wires.contains(proxy))
+	    {
+	      m_wires[proxy].remove(wire);
+
+	      if(m_wires.value(proxy).isEmpty())
+		m_wires.remove(proxy);
+	    }
+
+	  delete wire;
+	}
+
+      emit changed();
+      break;
+    }
+}
+
 void glitch_scene::slotRedo(void)
 {
   if(m_undoStack && m_undoStack->canRedo())
@@ -991,3 +1510,93 @@ void glitch_scene::slotUndo(void)
       QApplication::restoreOverrideCursor();
     }
 }
+
+void glitch_scene::slotShowOrderHints(bool state)
+{
+  m_showOrderHints = state;
+  update();
+}
+
+void glitch_scene::slotUnwireSelectedObjects(void)
+{
+  QList<QPair<glitch_proxy_widget *, glitch_proxy_widget *> > list;
+
+  for(auto i : selectedItems())
+    for(auto wire : m_wires.value(qgraphicsitem_cast<glitch_proxy_widget *> (i)))
+      {
+	auto pair(qMakePair(wire->output(), wire->input()));
+
+	if(!list.contains(pair))
+	  list << pair;
+      }
+
+  if(list.isEmpty())
+    return;
+
+  if(m_undoStack)
+    m_undoStack->beginMacro(tr("objects disconnected"));
+
+  for(const auto &pair : list)
+    if(m_undoStack)
+      m_undoStack->push
+	(new glitch_undo_command(glitch_undo_command::WIRE_DELETED,
+				 pair.first,
+				 pair.second,
+				 this));
+    else
+      removeWire(pair.first, pair.second);
+
+  if(m_undoStack)
+    m_undoStack->endMacro();
+}
+
+void glitch_scene::slotWireSelectedObjects(void)
+{
+  /*
+  ** The selected objects are chained from left to right, the output
+  ** of each object feeding the input of the next object.
+  */
+
+  QList<glitch_proxy_widget *> list;
+
+  for(auto i : selectedItems())
+    {
+      auto proxy = qgraphicsitem_cast<glitch_proxy_widget *> (i);
+
+      if(proxy && (proxy->flags() & QGraphicsItem::ItemIsSelectable))
+	list << proxy;
+    }
+
+  if(list.size() < 2)
+    return;
+
+  std::sort(list.begin(), list.end(), proxy_less_than);
+
+  if(m_undoStack)
+    m_undoStack->beginMacro(tr("objects connected"));
+
+  for(int i = 1; i < list.size(); i++)
+    if(m_undoStack)
+      {
+	bool exists = false;
+
+	for(auto wire : m_wires.value(list.at(i - 1)))
+	  if(wire->input() == list.at(i))
+	    {
+	      exists = true;
+	      break;
+	    }
+
+	if(!exists)
+	  m_undoStack->push
+	    (new glitch_undo_command(glitch_undo_command::WIRE_ADDED,
+				     list.at(i - 1),
+				     list.at(i),
+				     this));
+      }
+    else
+      addWire(list.at(i - 1), list.at(i));
+
+  if(m_undoStack)
+    m_undoStack->endMacro();
+}
@@ -31,12 +31,18 @@
 #include <QGraphicsScene>
 #include <QHash>
 #include <QPointer>
+#include <QSet>
 
 #include "glitch-common.h"
+#include "glitch-proximity.h"
+#include "glitch-wire-graph.h"
 
+class QSqlDatabase;
 class QUndoStack;
 class glitch_object;
+class glitch_object_actions;
 class glitch_proxy_widget;
+class glitch_wire;
 
 class glitch_scene: public QGraphicsScene
 {
@@ -46,24 +52,51 @@ class glitch_scene: public QGraphicsScene
   glitch_scene(const glitch_common::ProjectType projectType, QObject *parent);
   ~glitch_scene();
   QList<glitch_object *> objects(void) const;
+  QList<glitch_object *> orderedObjects(void) const;
   QList<glitch_object *> selectedObjects(void) const;
   QPointer<QUndoStack> undoStack(void) const;
+  bool isOverBudget(glitch_proxy_widget *proxy) const;
+  bool saveWires(const QSqlDatabase &db,
+		 const qint64 parentId,
+		 QString &error) const;
+  bool showOrderHints(void) const;
+  glitch_object_actions *objectActions(void);
   glitch_proxy_widget *addObject(glitch_object *object);
+  glitch_wire *addWire(glitch_proxy_widget *output, glitch_proxy_widget *input);
+  glitch_wire_graph wireGraph(void) const;
+  const glitch_proximity &proximity(void) const;
+  int statementIndex(glitch_proxy_widget *proxy) const;
+  qreal heat(glitch_proxy_widget *proxy) const;
   void addItem(QGraphicsItem *item);
+  void addWires(const glitch_wire_graph &graph);
+  void applyStyleSheet(const QList<glitch_object *> &objects,
+		       const QString &styleSheet);
   void artificialDrop(const QPointF &point, glitch_object *object);
   void deleteItems(void);
   void purgeRedoUndoProxies(void);
   void removeItem(QGraphicsItem *item);
+  void removeWire(glitch_proxy_widget *output, glitch_proxy_widget *input);
+  void setHeat(const QHash<qint64, qreal> &heat);
   void setMainScene(const bool state);
+  void setOverBudget(const QSet<qint64> &ids);
   void setUndoStack(QUndoStack *undoStack);
 
  private:
+  QHash<QObject *, qint64> m_proxyIds;
+  QHash<glitch_proxy_widget *, QSet<glitch_wire *> > m_wires;
   QHash<glitch_proxy_widget *, char> m_redoUndoProxies;
+  QHash<qint64, QPointer<glitch_proxy_widget> > m_proxies;
+  QHash<qint64, qreal> m_heat;
   QList<QPair<QPointF, glitch_proxy_widget *> > m_movedPoints;
+  QSet<qint64> m_overBudget;
   QPointF m_lastScenePos;
   QPointer<QUndoStack> m_undoStack;
+  QPointer<glitch_object_actions> m_objectActions;
   bool m_mainScene;
+  bool m_showOrderHints;
   glitch_common::ProjectType m_projectType;
+  glitch_proximity m_proximity;
+  mutable QHash<qint64, int> m_statementIndexes;
   bool allowDrag(QGraphicsSceneDragDropEvent *event, const QString &text);
   void bringToFront(glitch_proxy_widget *proxy);
   void deleteFunctionClones(const QString &name);
@@ -75,8 +108,15 @@ class glitch_scene: public QGraphicsScene
   void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
   void mousePressEvent(QGraphicsSceneMouseEvent *event);
   void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
+  void setWiresVisible(glitch_proxy_widget *proxy, const bool state);
+
+ public slots:
+  void slotShowOrderHints(bool state);
+  void slotUnwireSelectedObjects(void);
+  void slotWireSelectedObjects(void);
 
  private slots:
+  void slotFunctionChanged(void);
   void slotFunctionNameChanged(const QString &after,
 			       const QString &before,
 			       glitch_object *object);
@@ -84,12 +124,15 @@ class glitch_scene: public QGraphicsScene
 				     const QString &before,
 				     glitch_object *object);
   void slotObjectDeletedViaContextMenu(void);
+  void slotProxyChanged(void);
+  void slotProxyDestroyed(QObject *object);
   void slotRedo(void);
   void slotUndo(void);
 
  signals:
   void changed(void);
   void functionAdded(const QString &name, const bool isClone);
+  void functionChanged(glitch_object *object);
   void functionDeleted(const QString &name);
   void functionNameChanged(const QString &after,
 			   const QString &before,
@@ -0,0 +1,111 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "glitch-serial-log-model.h"
+#include "glitch-serial-log.h"
+
+glitch_serial_log_model::glitch_serial_log_model
+(const glitch_serial_log *log, QObject *parent):QAbstractListModel(parent)
+{
+  m_count = 0;
+  m_first = 0;
+  m_log = log;
+}
+
+glitch_serial_log_model::~glitch_serial_log_model()
+{
+}
+
+QVariant glitch_serial_log_model::data(const QModelIndex &index,
+				       int role) const
+{
+  if(!index.isValid() || !m_log || role != Qt::DisplayRole)
+    return QVariant();
+  else
+    return m_log->line(m_first + index.row());
+}
+
+int glitch_serial_log_model::rowCount(const QModelIndex &parent) const
+{
+  if(parent.isValid())
+    return 0;
+  else
+    return static_cast<int> (m_count);
+}
+
+void glitch_serial_log_model::refresh(void)
+{
+  /*
+  ** Rows of discarded lines are removed and rows of new lines are
+  ** appended. The last row may have been extended. A cleared log
+  ** resets the model.
+  */
+
+  if(!m_log)
+    return;
+
+  auto end = m_log->first() + m_log->count();
+  auto first = m_log->first();
+
+  if(end < m_first + m_count || first < m_first)
+    {
+      beginResetModel();
+      m_count = end - first;
+      m_first = first;
+      endResetModel();
+      return;
+    }
+
+  if(first > m_first)
+    {
+      auto removed = qMin(first - m_first, m_count);
+
+      if(removed > 0)
+	{
+	  beginRemoveRows(QModelIndex(), 0, static_cast<int> (removed - 1));
+	  m_count -= removed;
+	  m_first += removed;
+	  endRemoveRows();
+	}
+
+      if(m_count == 0)
+	m_first = first;
+    }
+
+  if(m_count > 0)
+    emit dataChanged(index(static_cast<int> (m_count - 1)),
+		     index(static_cast<int> (m_count - 1)));
+
+  if(end > m_first + m_count)
+    {
+      beginInsertRows(QModelIndex(),
+		      static_cast<int> (m_count),
+		      static_cast<int> (end - m_first - 1));
+      m_count = end - m_first;
+      endInsertRows();
+    }
+}
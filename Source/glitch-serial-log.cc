@@ -0,0 +1,373 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QObject>
+#include <QThread>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#include "glitch-serial-log.h"
+
+static const int s_capacity = 65536;
+static const int s_lineLength = 4096;
+
+/*
+** A blocking producer yields a number of times and then sleeps for
+** increasing intervals. It stops waiting once it has slept for the
+** given time.
+*/
+
+static const int s_waitYields = 64;
+static const unsigned long s_waitMicros = 100000;
+static const unsigned long s_waitSleepMaximum = 1024;
+
+glitch_serial_log::glitch_serial_log(const int lines):m_buffer(s_capacity)
+{
+  m_blocking.store(false);
+  m_dropped.store(0);
+  m_lines.resize(qMax(1, lines));
+  m_partial.reserve(s_lineLength);
+  m_subordinate = -1;
+  m_terminal = -1;
+  m_terminalDropped = 0;
+  clear();
+}
+
+glitch_serial_log::~glitch_serial_log()
+{
+  closeTerminal();
+}
+
+QString glitch_serial_log::line(const qint64 index) const
+{
+  /*
+  ** Lines are numbered from the start of the log. Lines which
+  ** preceded the first line have been discarded.
+  */
+
+  if(index < m_first || index >= m_first + m_count)
+    return QString();
+  else
+    return m_lines.at(slot(index));
+}
+
+QString glitch_serial_log::terminalName(void) const
+{
+  return m_terminalName;
+}
+
+bool glitch_serial_log::isTerminalOpen(void) const
+{
+  return m_terminal >= 0;
+}
+
+bool glitch_serial_log::openTerminal(QString &error)
+{
+#ifdef Q_OS_UNIX
+  if(m_terminal >= 0)
+    return true;
+
+  auto terminal = posix_openpt(O_NOCTTY | O_RDWR);
+
+  if(terminal < 0 || grantpt(terminal) != 0 || unlockpt(terminal) != 0)
+    {
+      error = QString::fromLocal8Bit(strerror(errno));
+
+      if(terminal >= 0)
+	::close(terminal);
+
+      return false;
+    }
+
+  /*
+  ** The subordinate side is held open and placed in raw mode so that
+  ** serial tools may attach and detach. Writes to the primary side
+  ** do not block. Output which the terminal does not accept is
+  ** queued, up to a limit.
+  */
+
+  auto name = ptsname(terminal);
+  auto subordinate = name ? ::open(name, O_NOCTTY | O_RDWR) : -1;
+
+  if(subordinate < 0)
+    {
+      error = QString::fromLocal8Bit(strerror(errno));
+      ::close(terminal);
+      return false;
+    }
+
+  struct termios attributes;
+
+  if(tcgetattr(subordinate, &attributes) == 0)
+    {
+      cfmakeraw(&attributes);
+      tcsetattr(subordinate, TCSANOW, &attributes);
+    }
+
+  fcntl(terminal, F_SETFL, fcntl(terminal, F_GETFL) | O_NONBLOCK);
+  m_subordinate = subordinate;
+  m_terminal = terminal;
+  m_terminalName = QString::fromLocal8Bit(name);
+  return true;
+#else
+  error = QObject::tr("Pseudo-terminals are not supported on this system.");
+  return false;
+#endif
+}
+
+int glitch_serial_log::drain(void)
+{
+  /*
+  ** Consumer. At most one buffer of bytes is drained so that a fast
+  ** producer cannot hold the consumer.
+  */
+
+  QByteArray bytes;
+  char byte;
+
+  while(bytes.size() < m_buffer.capacity() && m_buffer.pop(byte))
+    bytes.append(byte);
+
+  if(!bytes.isEmpty())
+    append(bytes);
+
+  /*
+  ** Pending terminal output is written even if nothing was drained.
+  */
+
+  writeTerminal(bytes);
+  return bytes.size();
+}
+
+int glitch_serial_log::slot(const qint64 index) const
+{
+  return static_cast<int> (index % static_cast<qint64> (m_lines.size()));
+}
+
+qint64 glitch_serial_log::count(void) const
+{
+  return m_count;
+}
+
+qint64 glitch_serial_log::first(void) const
+{
+  return m_first;
+}
+
+quint64 glitch_serial_log::dropped(void) const
+{
+  return m_dropped.load();
+}
+
+quint64 glitch_serial_log::terminalDropped(void) const
+{
+  return m_terminalDropped;
+}
+
+void glitch_serial_log::append(const QByteArray &bytes)
+{
+  /*
+  ** The oldest line is replaced if the history is full. The last line
+  ** is replaced until it is terminated. Long lines are divided.
+  */
+
+  for(auto byte : bytes)
+    {
+      if(m_terminated)
+	{
+	  if(m_count == static_cast<qint64> (m_lines.size()))
+	    {
+	      m_first += 1;
+	      m_count -= 1;
+	    }
+
+	  m_count += 1;
+	  m_terminated = false;
+	}
+
+      if(byte == '\n')
+	m_terminated = true;
+      else if(byte != '\r')
+	m_partial.append(byte);
+
+      if(m_terminated || m_partial.size() >= s_lineLength)
+	{
+	  m_lines[slot(m_first + m_count - 1)] = QString::fromUtf8(m_partial);
+	  m_partial.resize(0);
+	  m_terminated = true;
+	}
+    }
+
+  if(!m_terminated)
+    m_lines[slot(m_first + m_count - 1)] = QString::fromUtf8(m_partial);
+}
+
+void glitch_serial_log::clear(void)
+{
+  /*
+  ** The producer must be idle.
+  */
+
+  char byte;
+
+  while(m_buffer.pop(byte))
+    ;
+
+  for(auto &line : m_lines)
+    line.clear();
+
+  m_count = 0;
+  m_dropped.store(0);
+  m_first = 0;
+  m_partial.resize(0);
+  m_terminalDropped = 0;
+  m_terminated = true;
+}
+
+void glitch_serial_log::close(void)
+{
+  /*
+  ** The producer no longer waits for the consumer.
+  */
+
+  m_blocking.store(false);
+}
+
+void glitch_serial_log::closeTerminal(void)
+{
+#ifdef Q_OS_UNIX
+  if(m_subordinate >= 0)
+    ::close(m_subordinate);
+
+  if(m_terminal >= 0)
+    ::close(m_terminal);
+#endif
+
+  m_pending.clear();
+  m_subordinate = -1;
+  m_terminal = -1;
+  m_terminalName.clear();
+}
+
+void glitch_serial_log::open(const bool blocking)
+{
+  /*
+  ** A blocking producer waits, for a limited time, if the buffer is
+  ** full. Otherwise, bytes are dropped.
+  */
+
+  m_blocking.store(blocking);
+}
+
+void glitch_serial_log::write(const QByteArray &bytes)
+{
+  /*
+  ** Producer.
+  */
+
+  int yields = 0;
+  unsigned long sleep = 1;
+  unsigned long slept = 0;
+
+  for(auto byte : bytes)
+    while(!m_buffer.push(byte))
+      if(m_blocking.load(std::memory_order_relaxed))
+	{
+	  if(slept >= s_waitMicros)
+	    {
+	      /*
+	      ** The consumer is not keeping up. Bytes are dropped
+	      ** until the log is opened again.
+	      */
+
+	      m_blocking.store(false);
+	    }
+	  else if(yields < s_waitYields)
+	    {
+	      QThread::yieldCurrentThread();
+	      yields += 1;
+	    }
+	  else
+	    {
+	      QThread::usleep(sleep);
+	      slept += sleep;
+	      sleep = qMin(2 * sleep, s_waitSleepMaximum);
+	    }
+	}
+      else
+	{
+	  m_dropped.fetch_add(1, std::memory_order_relaxed);
+	  break;
+	}
+}
+
+void glitch_serial_log::writeTerminal(const QByteArray &bytes)
+{
+  /*
+  ** Bytes which the terminal does not accept are written by the next
+  ** drain. If more than one buffer is pending, the oldest bytes are
+  ** discarded and counted.
+  */
+
+#ifdef Q_OS_UNIX
+  if(m_terminal < 0)
+    return;
+
+  m_pending.append(bytes);
+
+  while(!m_pending.isEmpty())
+    {
+      auto rc = ::write(m_terminal,
+			m_pending.constData(),
+			static_cast<size_t> (m_pending.size()));
+
+      if(rc > 0)
+	m_pending.remove(0, static_cast<int> (rc));
+      else if(rc < 0 && errno == EINTR)
+	continue;
+      else
+	break;
+    }
+
+  if(m_pending.size() > s_capacity)
+    {
+      auto excess = m_pending.size() - s_capacity;
+
+      m_pending.remove(0, excess);
+      m_terminalDropped += static_cast<quint64> (excess);
+    }
+#else
+  Q_UNUSED(bytes);
+#endif
+}
@@ -0,0 +1,85 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_serial_log_h_
+#define _glitch_serial_log_h_
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+#include "glitch-ring-buffer.h"
+
+/*
+** Serial output of a simulation. Bytes are written by the thread which
+** runs the simulation and drained into a bounded history of lines.
+** The history may be mirrored to a pseudo-terminal.
+*/
+
+class glitch_serial_log
+{
+ public:
+  glitch_serial_log(const int lines);
+  ~glitch_serial_log();
+  QString line(const qint64 index) const;
+  QString terminalName(void) const;
+  bool isTerminalOpen(void) const;
+  bool openTerminal(QString &error);
+  int drain(void);
+  qint64 count(void) const;
+  qint64 first(void) const;
+  quint64 dropped(void) const;
+  quint64 terminalDropped(void) const;
+  void clear(void);
+  void close(void);
+  void closeTerminal(void);
+  void open(const bool blocking);
+  void write(const QByteArray &bytes);
+
+ private:
+  QByteArray m_partial;
+  QByteArray m_pending;
+  QString m_terminalName;
+  QVector<QString> m_lines;
+  glitch_ring_buffer<char> m_buffer;
+  bool m_terminated;
+  int m_subordinate;
+  int m_terminal;
+  qint64 m_count;
+  qint64 m_first;
+  std::atomic<bool> m_blocking;
+  std::atomic<quint64> m_dropped;
+  quint64 m_terminalDropped;
+  int slot(const qint64 index) const;
+  void append(const QByteArray &bytes);
+  void writeTerminal(const QByteArray &bytes);
+  Q_DISABLE_COPY(glitch_serial_log)
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QCryptographicHash>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "glitch-style-sheet-pool.h"
+
+glitch_style_sheet_pool::glitch_style_sheet_pool(void)
+{
+}
+
+glitch_style_sheet_pool::~glitch_style_sheet_pool()
+{
+}
+
+QString glitch_style_sheet_pool::hash(const QString &styleSheet)
+{
+  return QCryptographicHash::hash
+    (styleSheet.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+QString glitch_style_sheet_pool::intern(const QString &styleSheet)
+{
+  /*
+  ** Equal style sheets share a single string.
+  */
+
+  if(styleSheet.isEmpty())
+    return "";
+
+  auto it = m_styleSheets.constFind(styleSheet);
+
+  if(it != m_styleSheets.constEnd())
+    return *it;
+
+  m_styleSheets.insert(styleSheet);
+  return styleSheet;
+}
+
+QString glitch_style_sheet_pool::resolve(const QString &value)
+{
+  /*
+  ** The stylesheet column of the objects table contains either the
+  ** hash of a row of the stylesheets table or, in older diagrams, the
+  ** style sheet itself.
+  */
+
+  if(m_hashes.contains(value))
+    return m_hashes.value(value);
+  else
+    return intern(value);
+}
+
+bool glitch_style_sheet_pool::save(const QSqlDatabase &db,
+				   const QString &styleSheet,
+				   QString &error)
+{
+  if(styleSheet.isEmpty())
+    return true;
+
+  QSqlQuery query(db);
+
+  query.prepare("INSERT OR IGNORE INTO stylesheets (hash, stylesheet) "
+		"VALUES (?, ?)");
+  query.addBindValue(hash(styleSheet));
+  query.addBindValue(styleSheet);
+
+  if(!query.exec())
+    {
+      error = query.lastError().text();
+      return false;
+    }
+
+  return true;
+}
+
+int glitch_style_sheet_pool::count(void) const
+{
+  return m_styleSheets.size();
+}
+
+void glitch_style_sheet_pool::clear(void)
+{
+  m_hashes.clear();
+  m_styleSheets.clear();
+}
+
+void glitch_style_sheet_pool::load(const QSqlDatabase &db)
+{
+  /*
+  ** Older diagrams do not have a stylesheets table.
+  */
+
+  QSqlQuery query(db);
+
+  query.setForwardOnly(true);
+
+  if(query.exec("SELECT hash, stylesheet FROM stylesheets"))
+    while(query.next())
+      m_hashes[query.value(0).toString()] =
+	intern(query.value(1).toString().trimmed());
+}
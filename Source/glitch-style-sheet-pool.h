@@ -0,0 +1,56 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_style_sheet_pool_h_
+#define _glitch_style_sheet_pool_h_
+
+#include <QHash>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+
+class glitch_style_sheet_pool
+{
+ public:
+  glitch_style_sheet_pool(void);
+  ~glitch_style_sheet_pool();
+  QString intern(const QString &styleSheet);
+  QString resolve(const QString &value);
+  int count(void) const;
+  static QString hash(const QString &styleSheet);
+  static bool save(const QSqlDatabase &db,
+		   const QString &styleSheet,
+		   QString &error);
+  void clear(void);
+  void load(const QSqlDatabase &db);
+
+ private:
+  QHash<QString, QString> m_hashes;
+  QSet<QString> m_styleSheets;
+};
+
+#endif
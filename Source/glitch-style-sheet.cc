@@ -25,6 +25,7 @@
 ** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include "glitch-object.h"
 #include "glitch-style-sheet.h"
 
 glitch_style_sheet::glitch_style_sheet(QWidget *parent):QDialog(parent)
@@ -57,7 +58,14 @@ void glitch_style_sheet::setWidget(QWidget *widget)
 
   if(m_widget)
     {
-      m_ui.style_sheet->setPlainText(m_widget->styleSheet());
+      /*
+      ** Objects expose their own style sheets, without their themes.
+      */
+
+      auto object = qobject_cast<glitch_object *> (m_widget.data());
+
+      m_ui.style_sheet->setPlainText
+	(object ? object->styleSheet() : m_widget->styleSheet());
       m_ui.style_sheet->setReadOnly(false);
     }
   else
@@ -72,5 +80,10 @@ void glitch_style_sheet::slotPreview(void)
   if(!m_widget)
     return;
 
-  m_widget->setStyleSheet(m_ui.style_sheet->toPlainText());
+  auto object = qobject_cast<glitch_object *> (m_widget.data());
+
+  if(object)
+    object->setStyleSheet(m_ui.style_sheet->toPlainText());
+  else
+    m_widget->setStyleSheet(m_ui.style_sheet->toPlainText());
 }
@@ -0,0 +1,182 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QFile>
+#include <QMutex>
+#include <QTextStream>
+
+#include <cstdlib>
+
+#include "glitch-trace.h"
+
+struct glitch_trace_event
+{
+  const char *name;
+  qint64 begin;
+  qint64 end;
+};
+
+/*
+** Every thread appends to its own buffer of fixed capacity. Events
+** beyond the capacity are dropped and counted. An event is published
+** by the release of the count so that the writer may read the
+** published events of a thread which is still recording.
+*/
+
+struct glitch_trace_buffer
+{
+  glitch_trace_event *events;
+  int thread;
+  std::atomic<int> count;
+  std::atomic<quint64> dropped;
+};
+
+static const int s_capacity = 65536;
+
+/*
+** The mutex only protects the list of buffers, which changes once per
+** thread.
+*/
+
+static QList<glitch_trace_buffer *> s_buffers;
+static QMutex s_buffersMutex;
+static thread_local glitch_trace_buffer *s_buffer = nullptr;
+
+QElapsedTimer glitch_trace::s_timer;
+QString glitch_trace::s_fileName;
+std::atomic<bool> glitch_trace::s_enabled(false);
+
+static void glitch_trace_write(void)
+{
+  glitch_trace::write();
+}
+
+void glitch_trace::enable(const QString &fileName)
+{
+  if(fileName.trimmed().isEmpty() || isEnabled())
+    return;
+
+  s_fileName = fileName.trimmed();
+  s_timer.start();
+  s_enabled.store(true);
+  std::atexit(glitch_trace_write);
+}
+
+void glitch_trace::record(const char *name,
+			  const qint64 begin,
+			  const qint64 end)
+{
+  if(!isEnabled())
+    return;
+
+  if(Q_UNLIKELY(!s_buffer))
+    {
+      QMutexLocker locker(&s_buffersMutex);
+
+      s_buffer = new glitch_trace_buffer();
+      s_buffer->count.store(0);
+      s_buffer->dropped.store(0);
+      s_buffer->events = new glitch_trace_event[s_capacity];
+      s_buffer->thread = s_buffers.size() + 1;
+      s_buffers << s_buffer;
+    }
+
+  auto count = s_buffer->count.load(std::memory_order_relaxed);
+
+  if(count >= s_capacity)
+    {
+      s_buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+  auto &event(s_buffer->events[count]);
+
+  event.begin = begin;
+  event.end = end;
+  event.name = name;
+  s_buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void glitch_trace::write(void)
+{
+  /*
+  ** Chrome trace-event format, complete events. Perfetto and
+  ** chrome://tracing load the file.
+  */
+
+  if(!isEnabled())
+    return;
+
+  s_enabled.store(false);
+
+  QFile file(s_fileName);
+
+  if(!file.open(QIODevice::Text | QIODevice::Truncate | QIODevice::WriteOnly))
+    return;
+
+  /*
+  ** Recording stops before the buffers are read. Threads which are
+  ** still running only publish events which are not read.
+  */
+
+  QMutexLocker locker(&s_buffersMutex);
+  QTextStream stream(&file);
+  bool first = true;
+  quint64 dropped = 0;
+
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  for(auto buffer : s_buffers)
+    {
+      auto count = buffer->count.load(std::memory_order_acquire);
+
+      dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+      for(int i = 0; i < count; i++)
+	{
+	  const auto &event(buffer->events[i]);
+
+	  if(!first)
+	    stream << ",";
+
+	  first = false;
+	  stream << "\n{\"cat\":\"glitch\",\"dur\":"
+		 << event.end - event.begin
+		 << ",\"name\":\""
+		 << event.name
+		 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+		 << buffer->thread
+		 << ",\"ts\":"
+		 << event.begin
+		 << "}";
+	}
+    }
+
+  stream << "\n],\"otherData\":{\"dropped\":\""
+	 << dropped
+	 << "\"}}\n";
+}
@@ -0,0 +1,99 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_trace_h_
+#define _glitch_trace_h_
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+/*
+** GLITCH_TRACE_SCOPE("name") records the duration of the enclosing
+** scope. A disabled tracer costs a single relaxed load. Names must be
+** string literals.
+*/
+
+#define GLITCH_TRACE_SCOPE(name) glitch_trace_scope glitch_trace_scope_(name)
+
+class glitch_trace
+{
+ public:
+  static bool isEnabled(void)
+  {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+
+  static qint64 now(void)
+  {
+    return s_timer.nsecsElapsed() / 1000;
+  }
+
+  static void enable(const QString &fileName);
+  static void record(const char *name, const qint64 begin, const qint64 end);
+  static void write(void);
+
+ private:
+  glitch_trace(void);
+  ~glitch_trace();
+  static QElapsedTimer s_timer;
+  static QString s_fileName;
+  static std::atomic<bool> s_enabled;
+};
+
+class glitch_trace_scope
+{
+ public:
+  glitch_trace_scope(const char *name)
+  {
+    if(glitch_trace::isEnabled())
+      {
+	m_begin = glitch_trace::now();
+	m_name = name;
+      }
+    else
+      {
+	m_begin = 0;
+	m_name = nullptr;
+      }
+  }
+
+  ~glitch_trace_scope()
+  {
+    if(m_name)
+      glitch_trace::record(m_name, m_begin, glitch_trace::now());
+  }
+
+ private:
+  const char *m_name;
+  qint64 m_begin;
+  glitch_trace_scope(const glitch_trace_scope &);
+  glitch_trace_scope &operator=(const glitch_trace_scope &);
+};
+
+#endif
@@ -42,6 +42,7 @@
 #include "glitch-object.h"
 #include "glitch-scene.h"
 #include "glitch-separated-diagram-window.h"
+#include "glitch-trace.h"
 #include "glitch-ui.h"
 #include "glitch-undo-command.h"
 #include "ui_glitch-errors-dialog.h"
@@ -87,6 +88,10 @@ glitch_ui::glitch_ui(void):QMainWindow(nullptr)
 	  SIGNAL(triggered(void)),
 	  this,
 	  SLOT(slotOpenDiagram(void)));
+  connect(m_ui.action_Paint_Statistics,
+	  SIGNAL(triggered(bool)),
+	  this,
+	  SLOT(slotShowPaintStatistics(bool)));
   connect(m_ui.action_Paste,
 	  SIGNAL(triggered(void)),
 	  this,
@@ -123,6 +128,10 @@ glitch_ui::glitch_ui(void):QMainWindow(nullptr)
 	  SIGNAL(aboutToShow(void)),
 	  this,
 	  SLOT(slotAboutToShowTabsMenu(void)));
+  connect(m_ui.menu_Tools,
+	  SIGNAL(aboutToShow(void)),
+	  this,
+	  SLOT(slotAboutToShowToolsMenu(void)));
   connect(m_ui.tab,
 	  SIGNAL(currentChanged(int)),
 	  this,
@@ -160,6 +169,8 @@ copiedObjects(void)
 
 bool glitch_ui::openDiagram(const QString &fileName, QString &error)
 {
+  GLITCH_TRACE_SCOPE("glitch_ui::openDiagram");
+
   QFileInfo fileInfo(fileName);
 
   if(!fileInfo.isReadable() && !fileInfo.isWritable())
@@ -292,6 +303,10 @@ glitch_view_arduino *glitch_ui::newArduinoDiagram
 	  SIGNAL(unite(glitch_view *)),
 	  this,
 	  SLOT(slotUnite(glitch_view *)));
+  connect(view,
+	  SIGNAL(warning(const QString &)),
+	  m_ui.statusbar,
+	  SLOT(showMessage(const QString &)));
   connect(view->menuAction(),
 	  SIGNAL(triggered(void)),
 	  this,
@@ -354,6 +369,8 @@ void glitch_ui::closeEvent(QCloseEvent *event)
 
 void glitch_ui::copy(QGraphicsView *view)
 {
+  GLITCH_TRACE_SCOPE("glitch_ui::copy");
+
   if(!view || !view->scene())
     return;
 
@@ -447,6 +464,9 @@ void glitch_ui::parseCommandLineArguments(void)
 	    (tr("An error occurred while processing "
 		"the file %1. (%2)\n\n").arg(list.value(i)).arg(error));
       }
+    else if(list.at(i).startsWith("--trace="))
+      {
+      }
     else if(list.at(i) == "--version")
       {
       }
@@ -468,6 +488,8 @@ void glitch_ui::parseCommandLineArguments(void)
 
 void glitch_ui::paste(QGraphicsView *view, QUndoStack *undoStack)
 {
+  GLITCH_TRACE_SCOPE("glitch_ui::paste");
+
   if(s_copiedObjects.isEmpty() || !undoStack || !view)
     return;
 
@@ -558,6 +580,8 @@ void glitch_ui::prepareActionWidgets(void)
       m_ui.action_Close_Diagram->setEnabled(false);
       m_ui.action_Copy->setEnabled(false);
       m_ui.action_Delete->setEnabled(false);
+      m_ui.action_Paint_Statistics->setChecked(false);
+      m_ui.action_Paint_Statistics->setEnabled(false);
       m_ui.action_Paste->setEnabled(false);
       m_ui.action_Save_Current_Diagram->setEnabled(false);
       m_ui.action_Save_Current_Diagram_As->setEnabled(false);
@@ -574,6 +598,9 @@ void glitch_ui::prepareActionWidgets(void)
 	(m_currentView && !m_currentView->scene()->selectedItems().empty());
       m_ui.action_Delete->setEnabled
 	(m_currentView && !m_currentView->scene()->selectedItems().empty());
+      m_ui.action_Paint_Statistics->setChecked
+	(m_currentView && m_currentView->view()->statisticsVisible());
+      m_ui.action_Paint_Statistics->setEnabled(true);
       m_ui.action_Paste->setEnabled(!s_copiedObjects.isEmpty());
       m_ui.action_Save_Current_Diagram->setEnabled
 	(m_currentView && m_currentView->hasChanged());
@@ -796,6 +823,16 @@ void glitch_ui::slotAboutToShowTabsMenu(void)
     m_ui.menu_Tabs->addAction(tr("Empty"))->setEnabled(false);
 }
 
+void glitch_ui::slotAboutToShowToolsMenu(void)
+{
+  /*
+  ** The statistics may have been toggled from the view's shortcut.
+  */
+
+  m_ui.action_Paint_Statistics->setChecked
+    (m_currentView && m_currentView->view()->statisticsVisible());
+}
+
 void glitch_ui::slotArduinoViewDestroyed(void)
 {
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
@@ -1231,6 +1268,8 @@ void glitch_ui::slotSelectionChanged(void)
     {
       m_ui.action_Copy->setEnabled(false);
       m_ui.action_Delete->setEnabled(false);
+      m_ui.action_Paint_Statistics->setChecked(false);
+      m_ui.action_Paint_Statistics->setEnabled(false);
       m_ui.action_Paste->setEnabled(false);
       m_ui.action_Select_All->setEnabled(false);
     }
@@ -1283,6 +1322,14 @@ void glitch_ui::slotShowCanvasSettings(void)
     view->showCanvasSettings();
 }
 
+void glitch_ui::slotShowPaintStatistics(bool state)
+{
+  auto view = qobject_cast<glitch_view *> (m_ui.tab->currentWidget());
+
+  if(view)
+    view->view()->setStatisticsVisible(state);
+}
+
 void glitch_ui::slotShowStructures(void)
 {
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
@@ -78,6 +78,7 @@ class glitch_ui: public QMainWindow
 
  private slots:
   void slotAboutToShowTabsMenu(void);
+  void slotAboutToShowToolsMenu(void);
   void slotArduinoViewDestroyed(void);
   void slotClearCopiedWidgetsBuffer(void);
   void slotClearRecentFiles(void);
@@ -105,6 +106,7 @@ class glitch_ui: public QMainWindow
   void slotSeparate(glitch_view *view);
   void slotShowAlignment(void);
   void slotShowCanvasSettings(void);
+  void slotShowPaintStatistics(bool state);
   void slotShowStructures(void);
   void slotTabMoved(int from, int to);
   void slotUndo(void);
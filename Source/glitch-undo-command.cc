@@ -31,6 +31,7 @@
 #include "glitch-object.h"
 #include "glitch-proxy-widget.h"
 #include "glitch-scene.h"
+#include "glitch-trace.h"
 #include "glitch-undo-command.h"
 #include "glitch-user-functions.h"
 
@@ -137,6 +138,20 @@ glitch_undo_command::glitch_undo_command
   m_type = type;
 }
 
+glitch_undo_command::glitch_undo_command
+(const Types type,
+ glitch_proxy_widget *output,
+ glitch_proxy_widget *input,
+ glitch_scene *scene,
+ QUndoCommand *parent):QUndoCommand(parent)
+{
+  m_input = input;
+  m_property = glitch_object::XYZ_PROPERTY;
+  m_proxy = output;
+  m_scene = scene;
+  m_type = type;
+}
+
 glitch_undo_command::glitch_undo_command
 (const Types type,
  glitch_proxy_widget *proxy,
@@ -155,6 +170,8 @@ glitch_undo_command::~glitch_undo_command()
 
 void glitch_undo_command::redo(void)
 {
+  GLITCH_TRACE_SCOPE("glitch_undo_command::redo");
+
   switch(m_type)
     {
     case CANVAS_SETTINGS_CHANGED:
@@ -231,9 +248,27 @@ void glitch_undo_command::redo(void)
       }
     case STYLESHEET_CHANGED:
       {
-	if(m_object)
+	/*
+	** Setting an identical style sheet re-polishes the widget.
+	*/
+
+	if(m_object && m_object->styleSheet() != m_currentStyleSheet)
 	  m_object->setStyleSheet(m_currentStyleSheet);
 
+	break;
+      }
+    case WIRE_ADDED:
+      {
+	if(m_input && m_proxy && m_scene)
+	  m_scene->addWire(m_proxy, m_input);
+
+	break;
+      }
+    case WIRE_DELETED:
+      {
+	if(m_input && m_proxy && m_scene)
+	  m_scene->removeWire(m_proxy, m_input);
+
 	break;
       }
     default:
@@ -245,6 +280,8 @@ void glitch_undo_command::redo(void)
 
 void glitch_undo_command::undo(void)
 {
+  GLITCH_TRACE_SCOPE("glitch_undo_command::undo");
+
   switch(m_type)
     {
     case CANVAS_SETTINGS_CHANGED:
@@ -312,9 +349,23 @@ void glitch_undo_command::undo(void)
       }
     case STYLESHEET_CHANGED:
       {
-	if(m_object)
+	if(m_object && m_object->styleSheet() != m_previousStyleSheet)
 	  m_object->setStyleSheet(m_previousStyleSheet);
 
+	break;
+      }
+    case WIRE_ADDED:
+      {
+	if(m_input && m_proxy && m_scene)
+	  m_scene->removeWire(m_proxy, m_input);
+
+	break;
+      }
+    case WIRE_DELETED:
+      {
+	if(m_input && m_proxy && m_scene)
+	  m_scene->addWire(m_proxy, m_input);
+
 	break;
       }
     default:
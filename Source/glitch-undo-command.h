@@ -51,7 +51,9 @@ class glitch_undo_command: public QUndoCommand
     ITEM_MOVED,
     ITEM_RENAMED,
     PROPERTY_CHANGED,
-    STYLESHEET_CHANGED
+    STYLESHEET_CHANGED,
+    WIRE_ADDED,
+    WIRE_DELETED
   };
 
   glitch_undo_command(const QHash<glitch_canvas_settings::Settings,
@@ -79,6 +81,11 @@ class glitch_undo_command: public QUndoCommand
 		      const glitch_object::Properties property,
 		      glitch_object *object,
 		      QUndoCommand *parent = nullptr);
+  glitch_undo_command(const Types type,
+		      glitch_proxy_widget *output,
+		      glitch_proxy_widget *input,
+		      glitch_scene *scene,
+		      QUndoCommand *parent = nullptr);
   glitch_undo_command(const Types type,
 		      glitch_proxy_widget *proxy,
 		      glitch_scene *scene,
@@ -94,6 +101,7 @@ class glitch_undo_command: public QUndoCommand
   QPointF m_previousPosition;
   QPointer<glitch_canvas_settings> m_canvasSettings;
   QPointer<glitch_object> m_object;
+  QPointer<glitch_proxy_widget> m_input;
   QPointer<glitch_proxy_widget> m_proxy;
   QPointer<glitch_scene> m_scene;
   QPointer<glitch_user_functions> m_userFunctions;
@@ -36,6 +36,9 @@
 
 #include "Arduino/glitch-object-function-arduino.h"
 #include "glitch-alignment.h"
+#include "glitch-diagram.h"
+#include "glitch-diagram-statistics.h"
+#include "glitch-generated-source.h"
 #include "glitch-graphicsview.h"
 #include "glitch-misc.h"
 #include "glitch-object.h"
@@ -43,6 +46,7 @@
 #include "glitch-proxy-widget.h"
 #include "glitch-scene.h"
 #include "glitch-separated-diagram-window.h"
+#include "glitch-trace.h"
 #include "glitch-undo-command.h"
 #include "glitch-user-functions.h"
 #include "glitch-view.h"
@@ -203,6 +207,18 @@ QMenu *glitch_view::defaultContextMenu(void)
 		    this,
 		    SIGNAL(showStructures(void)));
 
+  menu->addSeparator();
+  menu->addAction(tr("&Connect Selected Objects"),
+		  m_scene,
+		  SLOT(slotWireSelectedObjects(void)));
+  menu->addAction(tr("D&isconnect Selected Objects"),
+		  m_scene,
+		  SLOT(slotUnwireSelectedObjects(void)));
+  action = menu->addAction(tr("Show Statement &Order"),
+			   m_scene,
+			   SLOT(slotShowOrderHints(bool)));
+  action->setCheckable(true);
+  action->setChecked(m_scene->showOrderHints());
   menu->addSeparator();
   action = menu->addAction(tr("Se&parate Canvas..."),
 			   this,
@@ -227,6 +243,18 @@ QMenu *glitch_view::defaultContextMenu(void)
 		  this,
 		  SLOT(slotShowCanvasSettings(void)));
   menu->addSeparator();
+  menu->addAction(tr("&Diagram Statistics..."),
+		  this,
+		  SLOT(slotShowDiagramStatistics(void)));
+  menu->addAction(tr("&Generated Source..."),
+		  this,
+		  SLOT(slotShowGeneratedSource(void)));
+
+  if(m_projectType == glitch_common::ArduinoProject)
+    menu->addAction(tr("Si&mulation..."),
+		    this,
+		    SLOT(slotShowSimulation(void)));
+
   menu->addAction(tr("&User Functions..."),
 		  this,
 		  SLOT(slotShowUserFunctions(void)));
@@ -238,11 +266,28 @@ QString glitch_view::name(void) const
   return m_canvasSettings->name();
 }
 
+QString glitch_view::optimizedSource(QString &report) const
+{
+  report.clear();
+  return source();
+}
+
+QString glitch_view::source(void) const
+{
+  return "";
+}
+
 QString glitch_view::redoText(void) const
 {
   return m_undoStack->redoText();
 }
 
+QString glitch_view::themeStyleSheet(const QString &type) const
+{
+  return m_settings.value(glitch_canvas_settings::THEMES).toMap().
+    value(type).toString();
+}
+
 QString glitch_view::undoText(void) const
 {
   return m_undoStack->undoText();
@@ -275,6 +320,8 @@ bool glitch_view::hasChanged(void) const
 
 bool glitch_view::open(const QString &fileName, QString &error)
 {
+  GLITCH_TRACE_SCOPE("glitch_view::open");
+
   QFileInfo fileInfo(fileName);
 
   if(!fileInfo.isReadable() && !fileInfo.isWritable())
@@ -292,87 +339,85 @@ bool glitch_view::open(const QString &fileName, QString &error)
 	     this,
 	     SLOT(slotChanged(void)));
 
-  QString connectionName("");
-  bool ok = true;
-
-  {
-    QSqlDatabase db(glitch_common::sqliteDatabase());
+  /*
+  ** The widgets are created from the diagram's model.
+  */
 
-    connectionName = db.connectionName();
-    db.setDatabaseName(fileName);
+  QHash<qint64, glitch_object *> objects;
+  glitch_diagram diagram;
+  bool ok = diagram.load(fileName, error);
 
-    if((ok = db.open()))
+  if(ok)
+    for(const auto &topLevelObject : diagram.topLevelObjects())
       {
-	QSqlQuery query(db);
+	/*
+	** Mandatory objects are created with the view. They adopt
+	** the children of their saved counterparts.
+	*/
 
-	query.setForwardOnly(true);
+	auto object = mandatoryObject(topLevelObject.type());
 
-	if(query.exec("SELECT myoid, parent_oid, position, properties, "
-		      "stylesheet, type FROM objects ORDER BY "
-		      "parent_oid, properties"))
+	if(object)
 	  {
-	    QHash<quint64, glitch_object *> parents;
+	    objects[topLevelObject.id()] = object;
 
-	    while(query.next())
+	    for(auto child : diagram.children(topLevelObject.id()))
 	      {
-		QMap<QString, QVariant> values;
-		QString point(query.value(2).toString().trimmed());
-		QString properties(query.value(3).toString().trimmed());
-		QString type(query.value(5).toString().toLower().trimmed());
-		quint64 id = query.value(0).toULongLong();
-
-		values["myoid"] = id;
-		values["parentId"] = query.value(1).toLongLong();
-		values["properties"] = properties;
-		values["stylesheet"] = query.value(4).toString().trimmed();
-		values["type"] = type;
-
-		if(query.value(1).toLongLong() == -1)
-		  {
-		    QString error("");
-		    auto object = glitch_object::createFromValues
-		      (values, error, this);
-
-		    if(object)
-		      {
-			auto proxy = m_scene->addObject(object);
-
-			if(proxy)
-			  {
-			    m_scene->addItem(proxy);
-			    object->setUndoStack(m_undoStack);
-			    parents[id] = object;
-			    proxy->setPos(glitch_misc::dbPointToPointF(point));
-			  }
-			else
-			  object->deleteLater();
-		      }
-		  }
-		else
-		  {
-		    auto object = parents.value(query.value(1).toULongLong());
-
-		    if(object && object->editView())
-		      object->addChild
-			(glitch_misc::
-			 dbPointToPointF(point),
-			 glitch_object::
-			 createFromValues(values, error, object->editView()));
-		  }
+		child.setParentId(static_cast<qint64> (object->id()));
+		object->addPendingChild(child);
 	      }
+
+	    continue;
 	  }
-	else
+
+	QString error("");
+
+	object = glitch_object::createFromValues
+	  (topLevelObject.values(), error, this);
+
+	if(!object)
+	  continue;
+
+	auto proxy = m_scene->addObject(object);
+
+	if(!proxy)
 	  {
-	    error = tr("An error occurred while accessing the objects table.");
-	    ok = false;
+	    object->deleteLater();
+	    continue;
 	  }
+
+	m_scene->addItem(proxy);
+	object->setUndoStack(m_undoStack);
+	objects[topLevelObject.id()] = object;
+	proxy->setPos(topLevelObject.position());
+
+	/*
+	** The widgets of a function's body are created when the
+	** function is first edited.
+	*/
+
+	if(!object->hasView())
+	  continue;
+
+	for(const auto &child : diagram.children(topLevelObject.id()))
+	  object->addPendingChild(child);
       }
 
-    db.close();
-  }
+  /*
+  ** Wires of a function's body are held with its pending children.
+  */
+
+  if(ok)
+    {
+      m_scene->addWires(diagram.wireGraph(-1));
+
+      for(const auto &wire : diagram.wires())
+	if(objects.value(wire.parentId))
+	  objects.value(wire.parentId)->addPendingWire
+	    (wire.outputId, wire.inputId);
+    }
 
   error = error.trimmed();
-  glitch_common::discardDatabase(connectionName);
   connect(m_scene,
 	  SIGNAL(changed(void)),
 	  this,
@@ -392,6 +437,8 @@ bool glitch_view::saveAs(const QString &fileName, QString &error)
 
 bool glitch_view::saveImplementation(const QString &fileName, QString &error)
 {
+  GLITCH_TRACE_SCOPE("glitch_view::saveImplementation");
+
   m_canvasSettings->setFileName(fileName);
   m_fileName = fileName;
 
@@ -412,6 +459,12 @@ bool glitch_view::saveImplementation(const QString &fileName, QString &error)
 
     if((ok = db.open()))
       {
+	/*
+	** Objects are written in a single transaction.
+	*/
+
+	db.transaction();
+
 	QSqlQuery query(db);
 
 	ok = query.exec("DELETE FROM diagram");
@@ -436,6 +489,7 @@ bool glitch_view::saveImplementation(const QString &fileName, QString &error)
 	  }
 
 	query.exec("DELETE FROM objects");
+	query.exec("DELETE FROM stylesheets");
 	query.exec("DELETE FROM wires");
 
 	QList<QGraphicsItem *> list(m_scene->items());
@@ -455,13 +509,25 @@ bool glitch_view::saveImplementation(const QString &fileName, QString &error)
 	    object->save(db, error);
 
 	    if(!error.isEmpty())
-	      break;
+	      {
+		ok = false;
+		break;
+	      }
 	  }
+
+	if(ok)
+	  ok = m_scene->saveWires(db, -1, error);
       }
     else
       error = db.lastError().text();
 
   done_label:
+
+    if(ok)
+      db.commit();
+    else
+      db.rollback();
+
     db.close();
   }
 
@@ -482,6 +548,12 @@ glitch_graphicsview *glitch_view::view(void) const
   return m_view;
 }
 
+glitch_object *glitch_view::mandatoryObject(const QString &type) const
+{
+  Q_UNUSED(type);
+  return nullptr;
+}
+
 glitch_scene *glitch_view::scene(void) const
 {
   return m_scene;
@@ -489,6 +561,8 @@ glitch_scene *glitch_view::scene(void) const
 
 quint64 glitch_view::nextId(void) const
 {
+  GLITCH_TRACE_SCOPE("glitch_view::nextId");
+
   QString connectionName("");
   quint64 id = 0;
 
@@ -527,6 +601,32 @@ void glitch_view::adjustScrollBars(void)
   QTimer::singleShot(250, this, SLOT(slotResizeScene(void)));
 }
 
+void glitch_view::applyThemes(void)
+{
+  GLITCH_TRACE_SCOPE("glitch_view::applyThemes");
+
+  /*
+  ** Themes are applied to all objects, including the objects of
+  ** materialized edit views, in a single pass.
+  */
+
+  auto themes(m_settings.value(glitch_canvas_settings::THEMES).toMap());
+  auto objects(m_scene->objects());
+
+  for(int i = 0; i < objects.size(); i++)
+    if(objects.at(i) && objects.at(i)->editView())
+      objects << objects.at(i)->editView()->objects();
+
+  m_view->setUpdatesEnabled(false);
+
+  for(auto object : objects)
+    if(object)
+      object->setThemeStyleSheet
+	(themes.value(object->type()).toString());
+
+  m_view->setUpdatesEnabled(true);
+}
+
 void glitch_view::beginMacro(const QString &text)
 {
   if(text.trimmed().isEmpty())
@@ -558,6 +658,8 @@ void glitch_view::endMacro(void)
 
 void glitch_view::prepareDatabaseTables(const QString &fileName) const
 {
+  GLITCH_TRACE_SCOPE("glitch_view::prepareDatabaseTables");
+
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
   QString connectionName("");
@@ -569,29 +671,7 @@ void glitch_view::prepareDatabaseTables(const QString &fileName) const
     db.setDatabaseName(fileName);
 
     if(db.open())
-      {
-	QSqlQuery query(db);
-
-	query.exec("CREATE TABLE IF NOT EXISTS diagram ("
-		   "name TEXT NOT NULL PRIMARY KEY, "
-		   "type TEXT NOT NULL)");
-	query.exec("CREATE TABLE IF NOT EXISTS objects ("
-		   "myoid INTEGER NOT NULL UNIQUE, "
-		   "parent_oid INTEGER NOT NULL DEFAULT -1, "
-		   "position TEXT NOT NULL, "
-		   "properties TEXT, "
-		   "stylesheet TEXT, "
-		   "type TEXT NOT NULL, "
-		   "PRIMARY KEY (myoid, parent_oid))");
-	query.exec("CREATE TABLE IF NOT EXISTS sequence ("
-		   "value INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT)");
-	query.exec("CREATE TABLE IF NOT EXISTS wires ("
-		   "object_input_oid INTEGER NOT NULL, "
-		   "object_output_oid INTEGER NOT NULL, "
-		   "parent_oid INTEGER NOT NULL, "
-		   "PRIMARY KEY (object_input_oid, "
-		   "object_output_oid, parent_oid))");
-      }
+      glitch_diagram::createTables(db);
 
     db.close();
   }
@@ -652,6 +732,8 @@ void glitch_view::save(void)
 
 void glitch_view::selectAll(void)
 {
+  GLITCH_TRACE_SCOPE("glitch_view::selectAll");
+
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
   QList<QGraphicsItem *> list(m_scene->items());
@@ -709,6 +791,34 @@ void glitch_view::showCanvasSettings(void)
   m_canvasSettings->raise();
 }
 
+void glitch_view::showDiagramStatistics(void)
+{
+  if(!m_diagramStatistics)
+    m_diagramStatistics = new glitch_diagram_statistics(this);
+
+  m_diagramStatistics->setWindowTitle
+    (tr("Glitch: Diagram Statistics (%1)").arg(name()));
+  m_diagramStatistics->showNormal();
+  m_diagramStatistics->activateWindow();
+  m_diagramStatistics->raise();
+}
+
+void glitch_view::showGeneratedSource(void)
+{
+  if(!m_generatedSource)
+    m_generatedSource = new glitch_generated_source(this);
+
+  m_generatedSource->setWindowTitle
+    (tr("Glitch: Generated Source (%1)").arg(name()));
+  m_generatedSource->showNormal();
+  m_generatedSource->activateWindow();
+  m_generatedSource->raise();
+}
+
+void glitch_view::showSimulation(void)
+{
+}
+
 void glitch_view::slotCanvasSettingsChanged(const bool undo)
 {
   QHash<glitch_canvas_settings::Settings, QVariant> hash(m_settings);
@@ -722,6 +832,10 @@ void glitch_view::slotCanvasSettingsChanged(const bool undo)
 
   m_view->setViewportUpdateMode(m_canvasSettings->viewportUpdateMode());
 
+  if(hash.value(glitch_canvas_settings::THEMES) !=
+     m_settings.value(glitch_canvas_settings::THEMES))
+    applyThemes();
+
   if(hash != m_settings && !hash.isEmpty())
     {
       if(undo)
@@ -887,6 +1001,21 @@ void glitch_view::slotShowCanvasSettings(void)
   showCanvasSettings();
 }
 
+void glitch_view::slotShowDiagramStatistics(void)
+{
+  showDiagramStatistics();
+}
+
+void glitch_view::slotShowGeneratedSource(void)
+{
+  showGeneratedSource();
+}
+
+void glitch_view::slotShowSimulation(void)
+{
+  showSimulation();
+}
+
 void glitch_view::slotShowUserFunctions(void)
 {
   m_userFunctions->showNormal();
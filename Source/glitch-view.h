@@ -37,6 +37,8 @@
 #include "ui_glitch-view.h"
 
 class glitch_alignment;
+class glitch_diagram_statistics;
+class glitch_generated_source;
 class glitch_graphicsview;
 class glitch_object;
 class glitch_object_start;
@@ -61,6 +63,7 @@ class glitch_view: public QWidget
   QMenu *defaultContextMenu(void);
   QString name(void) const;
   QString redoText(void) const;
+  QString themeStyleSheet(const QString &type) const;
   QString undoText(void) const;
   QUndoStack *undoStack(void) const;
   bool canRedo(void) const;
@@ -73,7 +76,10 @@ class glitch_view: public QWidget
   glitch_graphicsview *view(void) const;
   glitch_scene *scene(void) const;
   quint64 nextId(void) const;
+  virtual QString optimizedSource(QString &report) const;
+  virtual QString source(void) const;
   virtual bool open(const QString &fileName, QString &error);
+  virtual void showSimulation(void);
   void beginMacro(const QString &text);
   void deleteItems(void);
   void endMacro(void);
@@ -83,9 +89,12 @@ class glitch_view: public QWidget
   void selectAll(void);
   void showAlignment(void);
   void showCanvasSettings(void);
+  void showDiagramStatistics(void);
+  void showGeneratedSource(void);
   void undo(void);
 
  private:
+  void applyThemes(void);
   void prepareDatabaseTables(const QString &fileName) const;
   void prepareDefaultActions(void);
 
@@ -94,6 +103,8 @@ class glitch_view: public QWidget
   QHash<glitch_canvas_settings::Settings, QVariant> m_settings;
   QList<QAction *> m_defaultActions;
   QPointer<glitch_alignment> m_alignment;
+  QPointer<glitch_diagram_statistics> m_diagramStatistics;
+  QPointer<glitch_generated_source> m_generatedSource;
   QString m_fileName;
   QUndoStack *m_undoStack;
   Ui_glitch_view m_ui;
@@ -104,6 +115,7 @@ class glitch_view: public QWidget
   glitch_scene *m_scene;
   glitch_user_functions *m_userFunctions;
   bool saveImplementation(const QString &fileName, QString &error);
+  virtual glitch_object *mandatoryObject(const QString &type) const;
   void adjustScrollBars(void);
   void contextMenuEvent(QContextMenuEvent *event);
   void resizeEvent(QResizeEvent *event);
@@ -131,6 +143,9 @@ class glitch_view: public QWidget
   void slotSeparate(void);
   void slotShowAlignmentTool(void);
   void slotShowCanvasSettings(void);
+  void slotShowDiagramStatistics(void);
+  void slotShowGeneratedSource(void);
+  void slotShowSimulation(void);
   void slotShowUserFunctions(void);
   void slotUnite(void);
 
@@ -144,6 +159,7 @@ class glitch_view: public QWidget
   void separate(glitch_view *view);
   void showStructures(void);
   void unite(glitch_view *view);
+  void warning(const QString &text);
 };
 
 #endif
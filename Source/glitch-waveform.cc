@@ -0,0 +1,251 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QPainter>
+#include <QScrollBar>
+#include <QWheelEvent>
+
+#include <limits>
+
+#include "glitch-pin-trace.h"
+#include "glitch-waveform.h"
+
+static const int s_labelWidth = 70;
+static const int s_rowHeight = 36;
+static const int s_rulerHeight = 20;
+static const quint64 s_minimumSpan = 10;
+
+glitch_waveform::glitch_waveform(QWidget *parent):QAbstractScrollArea(parent)
+{
+  m_begin = 0;
+  m_duration = 0;
+  m_span = 1000;
+  m_trace = nullptr;
+  horizontalScrollBar()->setRange(0, 0);
+  setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+  setToolTip(tr("Ctrl + Wheel zooms."));
+  verticalScrollBar()->setRange(0, 0);
+}
+
+glitch_waveform::~glitch_waveform()
+{
+}
+
+quint64 glitch_waveform::step(void) const
+{
+  /*
+  ** Scroll bars are limited to integers.
+  */
+
+  auto range = m_duration > m_span ? m_duration - m_span : 0;
+
+  return qMax
+    (qMax(static_cast<quint64> (1), m_span / 100),
+     range / static_cast<quint64> (std::numeric_limits<int>::max()) + 1);
+}
+
+void glitch_waveform::paintEvent(QPaintEvent *event)
+{
+  Q_UNUSED(event);
+
+  QPainter painter(viewport());
+
+  painter.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+
+  if(!m_trace)
+    return;
+
+  auto columns = viewport()->width() - s_labelWidth;
+
+  if(columns <= 0)
+    return;
+
+  painter.setPen(palette().color(QPalette::Text));
+  painter.drawText
+    (QRect(s_labelWidth, 0, columns, s_rulerHeight),
+     Qt::AlignLeft | Qt::AlignVCenter,
+     tr("%1 us").arg(m_begin));
+  painter.drawText
+    (QRect(s_labelWidth, 0, columns, s_rulerHeight),
+     Qt::AlignRight | Qt::AlignVCenter,
+     tr("%1 us").arg(m_begin + m_span));
+
+  auto y = s_rulerHeight - verticalScrollBar()->value();
+
+  for(auto channel : m_channels)
+    {
+      if(y + s_rowHeight < s_rulerHeight)
+	{
+	  y += s_rowHeight;
+	  continue;
+	}
+      else if(y > viewport()->height())
+	break;
+
+      /*
+      ** Every column is a vertical line from the minimum
+      ** to the maximum of the column.
+      */
+
+      QVector<QLineF> lines;
+      auto extents
+	(m_trace->extents(channel, m_begin, m_begin + m_span, columns));
+      auto height = static_cast<qreal> (s_rowHeight - 8);
+      auto maximum = static_cast<qreal>
+	((static_cast<qint64> (1) << m_trace->width(channel)) - 1);
+
+      lines.reserve(extents.size());
+
+      for(int i = 0; i < extents.size(); i++)
+	{
+	  const auto &extent(extents.at(i));
+
+	  if(extent.minimum > extent.maximum)
+	    continue;
+
+	  auto x = static_cast<qreal> (s_labelWidth + i) + 0.5;
+
+	  lines << QLineF
+	    (x,
+	     y + 4 + height * (1.0 - extent.maximum / maximum),
+	     x,
+	     y + 4 + height * (1.0 - extent.minimum / maximum) + 0.5);
+	}
+
+      painter.setPen(palette().color(QPalette::Mid));
+      painter.drawLine(0, y + s_rowHeight - 1, width(), y + s_rowHeight - 1);
+      painter.setPen(palette().color(QPalette::Text));
+      painter.drawText
+	(QRect(4, y, s_labelWidth - 8, s_rowHeight),
+	 Qt::AlignLeft | Qt::AlignVCenter,
+	 m_trace->name(channel));
+      painter.setPen(QColor(0, 128, 0));
+      painter.drawLines(lines);
+      y += s_rowHeight;
+    }
+}
+
+void glitch_waveform::resizeEvent(QResizeEvent *event)
+{
+  QAbstractScrollArea::resizeEvent(event);
+  updateScrollBars();
+}
+
+void glitch_waveform::scrollContentsBy(int dx, int dy)
+{
+  Q_UNUSED(dx);
+  Q_UNUSED(dy);
+  m_begin = static_cast<quint64> (horizontalScrollBar()->value()) * step();
+  viewport()->update();
+}
+
+void glitch_waveform::setTrace(const glitch_pin_trace *trace)
+{
+  m_trace = trace;
+  slotTraceChanged();
+}
+
+void glitch_waveform::slotTraceChanged(void)
+{
+  /*
+  ** A view of the complete trace follows the trace.
+  */
+
+  auto follow = m_begin == 0 && m_span >= m_duration;
+
+  m_channels.clear();
+  m_duration = m_trace ? m_trace->duration() : 0;
+
+  if(m_trace)
+    for(int i = 0; i < m_trace->count(); i++)
+      if(m_trace->samples(i) > 0)
+	m_channels << i;
+
+  if(follow)
+    m_span = qMax(m_duration + 1, s_minimumSpan);
+
+  updateScrollBars();
+  viewport()->update();
+}
+
+void glitch_waveform::updateScrollBars(void)
+{
+  auto range = m_duration > m_span ? m_duration - m_span : 0;
+  auto step = this->step();
+
+  m_begin = qMin(m_begin, range);
+  horizontalScrollBar()->blockSignals(true);
+  horizontalScrollBar()->setRange(0, static_cast<int> (range / step));
+  horizontalScrollBar()->setPageStep
+    (static_cast<int> (qMin(m_span / step,
+			    static_cast<quint64>
+			    (std::numeric_limits<int>::max()))));
+  horizontalScrollBar()->setValue(static_cast<int> (m_begin / step));
+  horizontalScrollBar()->blockSignals(false);
+  verticalScrollBar()->setPageStep(viewport()->height());
+  verticalScrollBar()->setRange
+    (0,
+     qMax(0,
+	  s_rulerHeight +
+	  s_rowHeight * m_channels.size() -
+	  viewport()->height()));
+}
+
+void glitch_waveform::wheelEvent(QWheelEvent *event)
+{
+  if(!event || !(event->modifiers() & Qt::ControlModifier))
+    {
+      QAbstractScrollArea::wheelEvent(event);
+      return;
+    }
+
+  /*
+  ** Zoom about the cursor.
+  */
+
+#if QT_VERSION >= 0x050e00
+  auto x = static_cast<int> (event->position().x());
+#else
+  auto x = event->pos().x();
+#endif
+  auto columns = qMax(1, viewport()->width() - s_labelWidth);
+  auto fraction = qBound
+    (0.0, static_cast<qreal> (x - s_labelWidth) / columns, 1.0);
+  auto time = m_begin + static_cast<quint64> (fraction * m_span);
+
+  if(event->angleDelta().y() > 0)
+    m_span = qMax(m_span / 2, s_minimumSpan);
+  else
+    m_span = qMin(2 * m_span, qMax(m_duration + 1, s_minimumSpan));
+
+  auto offset = static_cast<quint64> (fraction * m_span);
+
+  m_begin = time > offset ? time - offset : 0;
+  updateScrollBars();
+  viewport()->update();
+  event->accept();
+}
@@ -0,0 +1,212 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QMap>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "glitch-wire-graph.h"
+
+/*
+** A wire connects the output of an object to the input of another
+** object. The adjacency of both ends is indexed so that an object's
+** wires are discovered in O(degree).
+*/
+
+glitch_wire_graph::glitch_wire_graph(void)
+{
+  m_count = 0;
+}
+
+glitch_wire_graph::~glitch_wire_graph()
+{
+}
+
+QList<QPair<qint64, qint64> > glitch_wire_graph::wires(void) const
+{
+  QHashIterator<qint64, QSet<qint64> > it(m_outputs);
+  QList<QPair<qint64, qint64> > list;
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      for(auto input : it.value())
+	list << qMakePair(it.key(), input);
+    }
+
+  return list;
+}
+
+QList<qint64> glitch_wire_graph::inputs(const qint64 id) const
+{
+  /*
+  ** The objects whose outputs are wired to the input of id.
+  */
+
+  return m_inputs.value(id).values();
+}
+
+QList<qint64> glitch_wire_graph::order(const QList<qint64> &ids) const
+{
+  /*
+  ** An evaluation order of ids such that every object follows the
+  ** objects which feed it. Independent objects retain their order
+  ** in ids, which is usually the order of their positions. Objects
+  ** which are part of a cycle are appended in their order in ids.
+  */
+
+  QHash<qint64, int> degrees;
+  QHash<qint64, int> indexes;
+  QMap<int, qint64> ready;
+
+  for(int i = 0; i < ids.size(); i++)
+    indexes[ids.at(i)] = i;
+
+  for(int i = 0; i < ids.size(); i++)
+    {
+      int degree = 0;
+
+      for(auto input : m_inputs.value(ids.at(i)))
+	if(indexes.contains(input))
+	  degree += 1;
+
+      if(degree == 0)
+	ready[i] = ids.at(i);
+      else
+	degrees[ids.at(i)] = degree;
+    }
+
+  QList<qint64> order;
+
+  while(!ready.isEmpty())
+    {
+      auto id = ready.take(ready.firstKey());
+
+      order << id;
+
+      for(auto output : m_outputs.value(id))
+	if(degrees.contains(output) && --degrees[output] == 0)
+	  {
+	    degrees.remove(output);
+	    ready[indexes.value(output)] = output;
+	  }
+    }
+
+  if(!degrees.isEmpty())
+    for(auto id : ids)
+      if(degrees.contains(id))
+	order << id;
+
+  return order;
+}
+
+QList<qint64> glitch_wire_graph::outputs(const qint64 id) const
+{
+  /*
+  ** The objects whose inputs are wired to the output of id.
+  */
+
+  return m_outputs.value(id).values();
+}
+
+bool glitch_wire_graph::contains(const qint64 output, const qint64 input) const
+{
+  return m_outputs.value(output).contains(input);
+}
+
+bool glitch_wire_graph::save(const QSqlDatabase &db,
+			     const qint64 parentId,
+			     QString &error) const
+{
+  QSqlQuery query(db);
+
+  for(const auto &wire : wires())
+    {
+      query.prepare("INSERT OR REPLACE INTO wires "
+		    "(object_input_oid, object_output_oid, parent_oid) "
+		    "VALUES (?, ?, ?)");
+      query.addBindValue(wire.second);
+      query.addBindValue(wire.first);
+      query.addBindValue(parentId);
+
+      if(!query.exec())
+	{
+	  error = query.lastError().text();
+	  return false;
+	}
+    }
+
+  return true;
+}
+
+int glitch_wire_graph::count(void) const
+{
+  return m_count;
+}
+
+void glitch_wire_graph::addWire(const qint64 output, const qint64 input)
+{
+  if(input == output || contains(output, input))
+    return;
+
+  m_count += 1;
+  m_inputs[input].insert(output);
+  m_outputs[output].insert(input);
+}
+
+void glitch_wire_graph::clear(void)
+{
+  m_count = 0;
+  m_inputs.clear();
+  m_outputs.clear();
+}
+
+void glitch_wire_graph::removeObject(const qint64 id)
+{
+  for(auto output : m_inputs.value(id))
+    removeWire(output, id);
+
+  for(auto input : m_outputs.value(id))
+    removeWire(id, input);
+}
+
+void glitch_wire_graph::removeWire(const qint64 output, const qint64 input)
+{
+  if(!contains(output, input))
+    return;
+
+  m_count -= 1;
+  m_inputs[input].remove(output);
+  m_outputs[output].remove(input);
+
+  if(m_inputs.value(input).isEmpty())
+    m_inputs.remove(input);
+
+  if(m_outputs.value(output).isEmpty())
+    m_outputs.remove(output);
+}
@@ -0,0 +1,62 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_wire_graph_h_
+#define _glitch_wire_graph_h_
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QSqlDatabase>
+
+class glitch_wire_graph
+{
+ public:
+  glitch_wire_graph(void);
+  ~glitch_wire_graph();
+  QList<QPair<qint64, qint64> > wires(void) const;
+  QList<qint64> inputs(const qint64 id) const;
+  QList<qint64> order(const QList<qint64> &ids) const;
+  QList<qint64> outputs(const qint64 id) const;
+  bool contains(const qint64 output, const qint64 input) const;
+  bool save(const QSqlDatabase &db,
+	    const qint64 parentId,
+	    QString &error) const;
+  int count(void) const;
+  void addWire(const qint64 output, const qint64 input);
+  void clear(void);
+  void removeObject(const qint64 id);
+  void removeWire(const qint64 output, const qint64 input);
+
+ private:
+  QHash<qint64, QSet<qint64> > m_inputs;
+  QHash<qint64, QSet<qint64> > m_outputs;
+  int m_count;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <QPainter>
+
+#include "glitch-proxy-widget.h"
+#include "glitch-wire.h"
+
+glitch_wire::glitch_wire
+(glitch_proxy_widget *output, glitch_proxy_widget *input):QGraphicsItem()
+{
+  m_input = input;
+  m_output = output;
+  setAcceptedMouseButtons(Qt::NoButton);
+  setZValue(-1);
+  updatePath();
+}
+
+glitch_wire::~glitch_wire()
+{
+}
+
+QRectF glitch_wire::boundingRect(void) const
+{
+  return m_boundingRect;
+}
+
+glitch_proxy_widget *glitch_wire::input(void) const
+{
+  return m_input;
+}
+
+glitch_proxy_widget *glitch_wire::output(void) const
+{
+  return m_output;
+}
+
+int glitch_wire::type(void) const
+{
+  return Type;
+}
+
+void glitch_wire::paint(QPainter *painter,
+			const QStyleOptionGraphicsItem *option,
+			QWidget *widget)
+{
+  Q_UNUSED(option);
+  Q_UNUSED(widget);
+
+  if(!painter || m_path.isEmpty())
+    return;
+
+  painter->setRenderHint(QPainter::Antialiasing, true);
+  painter->setPen(QPen(QColor(70, 130, 180), 2.0));
+  painter->drawPath(m_path);
+}
+
+void glitch_wire::updatePath(void)
+{
+  /*
+  ** The path is only rebuilt if an end moves. Painting reuses it.
+  */
+
+  prepareGeometryChange();
+  m_path = QPainterPath();
+
+  if(!m_input || !m_output)
+    {
+      m_boundingRect = QRectF();
+      return;
+    }
+
+  auto r1(m_output->sceneBoundingRect());
+  auto r2(m_input->sceneBoundingRect());
+  QPointF p1(r1.right(), r1.center().y());
+  QPointF p2(r2.left(), r2.center().y());
+  auto dx = qMax(25.0, qAbs(p2.x() - p1.x()) / 2.0);
+
+  m_path.moveTo(p1);
+  m_path.cubicTo(p1 + QPointF(dx, 0.0), p2 - QPointF(dx, 0.0), p2);
+  m_boundingRect = m_path.boundingRect().adjusted(-2.0, -2.0, 2.0, 2.0);
+}
@@ -0,0 +1,63 @@
+/*
+** Copyright (c) 2004 - 10^10^10, Alexis Megas.
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from Glitch without specific prior written permission.
+**
+** GLITCH IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** GLITCH, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _glitch_wire_h_
+#define _glitch_wire_h_
+
+#include <QGraphicsItem>
+#include <QPainterPath>
+#include <QPointer>
+
+class glitch_proxy_widget;
+
+class glitch_wire: public QGraphicsItem
+{
+ public:
+  enum
+  {
+    Type = UserType + 1
+  };
+
+  glitch_wire(glitch_proxy_widget *output, glitch_proxy_widget *input);
+  ~glitch_wire();
+  QRectF boundingRect(void) const;
+  glitch_proxy_widget *input(void) const;
+  glitch_proxy_widget *output(void) const;
+  int type(void) const;
+  void paint(QPainter *painter,
+	     const QStyleOptionGraphicsItem *option,
+	     QWidget *widget);
+  void updatePath(void);
+
+ private:
+  QPainterPath m_path;
+  QPointer<glitch_proxy_widget> m_input;
+  QPointer<glitch_proxy_widget> m_output;
+  QRectF m_boundingRect;
+};
+
+#endif
@@ -0,0 +1,16 @@
+include(glitch.pro)
+
+CONFIG		+= testcase
+QT		+= testlib
+
+QMAKE_CLEAN	+= glitch-bench
+MOC_DIR		= temp/bench/moc
+OBJECTS_DIR	= temp/bench/obj
+RCC_DIR		= temp/bench/rcc
+UI_DIR		= temp/bench/ui
+
+SOURCES	       -= Source/glitch-main.cc
+SOURCES	       += Benchmarks/glitch-bench.cc
+
+PROJECTNAME	= glitch-bench
+TARGET		= glitch-bench
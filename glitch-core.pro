@@ -0,0 +1,32 @@
+include(Source/glitch-core.pro)
+
+CONFIG		+= qt release staticlib warn_on
+DEFINES		+= QT_DEPRECATED_WARNINGS
+LANGUAGE	= C++
+QT		= concurrent core sql
+
+QMAKE_CLEAN	+= libglitch-core.a
+QMAKE_CXXFLAGS_RELEASE += -Wall \
+                          -Wcast-align \
+                          -Wcast-qual \
+                          -Wconversion \
+                          -Wdouble-promotion \
+                          -Wextra \
+                          -Wformat=2 \
+                          -Woverloaded-virtual \
+                          -Wpointer-arith \
+                          -Wsign-conversion \
+                          -Wundef \
+                          -Wzero-as-null-pointer-constant \
+                          -fPIC \
+                          -fwrapv \
+                          -pedantic \
+                          -std=c++11
+
+INCLUDEPATH	+= Source
+MOC_DIR		= temp/core/moc
+OBJECTS_DIR	= temp/core/obj
+
+PROJECTNAME	= glitch-core
+TARGET		= glitch-core
+TEMPLATE	= lib
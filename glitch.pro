@@ -1,4 +1,5 @@
 include(Source/glitch-arduino.pro)
+include(Source/glitch-core.pro)
 
 doxygen.commands = doxygen glitch.doxygen
 purge.commands = find . -name '*~' -exec rm {} \\;
@@ -6,7 +7,7 @@ purge.commands = find . -name '*~' -exec rm {} \\;
 CONFIG		+= qt release warn_on
 DEFINES		+= QT_DEPRECATED_WARNINGS
 LANGUAGE	= C++
-QT		+= gui sql
+QT		+= concurrent gui sql
 
 greaterThan(QT_MAJOR_VERSION, 4) {
 QT += widgets
@@ -114,8 +115,10 @@ UI_DIR      = temp/ui
 
 FORMS          += UI/glitch-alignment.ui \
                   UI/glitch-canvas-settings.ui \
+                  UI/glitch-diagram-statistics.ui \
                   UI/glitch-errors-dialog.ui \
                   UI/glitch-floating-context-menu.ui \
+                  UI/glitch-generated-source.ui \
                   UI/glitch-mainwindow.ui \
 		  UI/glitch-separated-diagram-window.ui \
                   UI/glitch-structures.ui \
@@ -124,14 +127,18 @@ FORMS          += UI/glitch-alignment.ui \
 		  UI/glitch-view.ui
 HEADERS	       += Source/glitch-alignment.h \
                   Source/glitch-canvas-settings.h \
+                  Source/glitch-diagram-statistics.h \
                   Source/glitch-floating-context-menu.h \
+                  Source/glitch-generated-source.h \
                   Source/glitch-graphicsview.h \
                   Source/glitch-object.h \
+                  Source/glitch-object-actions.h \
                   Source/glitch-object-edit-window.h \
 		  Source/glitch-object-view.h \
                   Source/glitch-proxy-widget.h \
                   Source/glitch-scene.h \
                   Source/glitch-separated-diagram-window.h \
+                  Source/glitch-serial-log-model.h \
                   Source/glitch-structures-treewidget.h \
                   Source/glitch-style-sheet.h \
                   Source/glitch-tab.h \
@@ -139,20 +146,25 @@ HEADERS	       += Source/glitch-alignment.h \
                   Source/glitch-ui.h \
                   Source/glitch-user-functions.h \
                   Source/glitch-user-functions-tablewidget.h \
-                  Source/glitch-view.h
+                  Source/glitch-view.h \
+                  Source/glitch-waveform.h \
+                  Source/glitch-wire.h
 SOURCES	       += Source/glitch-alignment.cc \
                   Source/glitch-canvas-settings.cc \
-                  Source/glitch-common.cc \
+                  Source/glitch-diagram-statistics.cc \
                   Source/glitch-graphicsview.cc \
                   Source/glitch-floating-context-menu.cc \
+                  Source/glitch-generated-source.cc \
                   Source/glitch-main.cc \
                   Source/glitch-misc.cc \
                   Source/glitch-object.cc \
+                  Source/glitch-object-actions.cc \
                   Source/glitch-object-edit-window.cc \
 		  Source/glitch-object-view.cc \
                   Source/glitch-proxy-widget.cc \
                   Source/glitch-scene.cc \
                   Source/glitch-separated-diagram-window.cc \
+                  Source/glitch-serial-log-model.cc \
                   Source/glitch-structures-treewidget.cc \
                   Source/glitch-style-sheet.cc \
                   Source/glitch-tab.cc \
@@ -161,7 +173,9 @@ SOURCES	       += Source/glitch-alignment.cc \
                   Source/glitch-undo-command.cc \
                   Source/glitch-user-functions.cc \
                   Source/glitch-user-functions-tablewidget.cc \
-                  Source/glitch-view.cc
+                  Source/glitch-view.cc \
+                  Source/glitch-waveform.cc \
+                  Source/glitch-wire.cc
 TRANSLATIONS    =
 
 PROJECTNAME	= Glitch